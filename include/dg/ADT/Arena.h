@@ -0,0 +1,242 @@
+#ifndef _DG_ADT_ARENA_H_
+#define _DG_ADT_ARENA_H_
+
+#include <new>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+
+namespace dg {
+namespace ADT {
+
+///
+// Arena for objects of a few different sizes, e.g. nodes of a graph
+// and their subclasses. Sizes are rounded up to ALIGNMENT and every
+// such size class has its own current slab, so the objects of the same
+// size are packed together and the allocation is just bumping
+// a pointer. The memory of single objects is never freed, all the
+// memory is released at once when the arena is destroyed.
+// The arena does not call destructors of the objects.
+class SizeClassArena {
+public:
+    enum : size_t {
+        ALIGNMENT = 16,
+        SLAB_SIZE = 64 * 1024,
+        // objects bigger than this get their own slab
+        MAX_CLASS_SIZE = 1024
+    };
+
+private:
+    struct Bump {
+        char *cur{nullptr};
+        char *end{nullptr};
+        // the list of freed chunks of this size
+        void *free{nullptr};
+    };
+
+    std::vector<Bump> _classes;
+    std::vector<std::unique_ptr<char[]>> _slabs;
+    size_t _allocated{0};
+
+    static size_t _roundUp(size_t size) {
+        // freed chunks must be able to hold the pointer
+        // to the next free chunk
+        if (size == 0)
+            return ALIGNMENT;
+        return (size + ALIGNMENT - 1) & ~static_cast<size_t>(ALIGNMENT - 1);
+    }
+
+    char *_newSlab(size_t size) {
+        // new char[] returns memory aligned for any fundamental type
+        _slabs.emplace_back(new char[size]);
+        return _slabs.back().get();
+    }
+
+public:
+    SizeClassArena() : _classes(MAX_CLASS_SIZE / ALIGNMENT + 1) {}
+
+    // moving the arena does not move the slabs,
+    // so the objects in the arena stay valid
+    SizeClassArena(SizeClassArena&&) = default;
+    SizeClassArena& operator=(SizeClassArena&&) = default;
+    SizeClassArena(const SizeClassArena&) = delete;
+    SizeClassArena& operator=(const SizeClassArena&) = delete;
+
+    void *allocate(size_t size) {
+        static_assert(ALIGNMENT % alignof(std::max_align_t) == 0,
+                      "Arena alignment is too small");
+        size = _roundUp(size);
+        _allocated += size;
+
+        if (size > MAX_CLASS_SIZE)
+            return _newSlab(size);
+
+        auto& cls = _classes[size / ALIGNMENT];
+        if (cls.free) {
+            void *mem = cls.free;
+            cls.free = *static_cast<void **>(mem);
+            return mem;
+        }
+
+        if (static_cast<size_t>(cls.end - cls.cur) < size) {
+            cls.cur = _newSlab(SLAB_SIZE);
+            cls.end = cls.cur + SLAB_SIZE;
+        }
+
+        void *mem = cls.cur;
+        cls.cur += size;
+        return mem;
+    }
+
+    // give the memory back for reuse by objects of the same size.
+    // Memory of big objects is released only with the arena.
+    void deallocate(void *mem, size_t size) {
+        size = _roundUp(size);
+        assert(_allocated >= size);
+        _allocated -= size;
+
+        if (size > MAX_CLASS_SIZE)
+            return;
+
+        auto& cls = _classes[size / ALIGNMENT];
+        *static_cast<void **>(mem) = cls.free;
+        cls.free = mem;
+    }
+
+    template <typename T, typename... Args>
+    T *create(Args&&... args) {
+        static_assert(alignof(T) <= ALIGNMENT, "Unsupported alignment");
+        return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
+    // the number of bytes given out by the arena (and not given back)
+    size_t getAllocatedBytes() const { return _allocated; }
+    size_t getSlabsNum() const { return _slabs.size(); }
+};
+
+///
+// Deleter for std::unique_ptr that owns an object created in an arena.
+// It only calls the destructor, the memory is released with the arena.
+struct ArenaDeleter {
+    template <typename T>
+    void operator()(T *obj) const { obj->~T(); }
+};
+
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDeleter>;
+
+///
+// Base class for objects that are created with 'new' in the arena
+// that is active in the current thread (see ArenaScope), or on the
+// heap if there is no active arena. Every object remembers
+// the arena that it was allocated in, so deleting the object gives
+// its memory back to the right arena. The owner of the arena must
+// delete the objects before the arena is destroyed.
+class ArenaAllocated {
+    struct Header {
+        SizeClassArena *arena;
+        size_t size;
+    };
+
+    // the size of the header rounded up so that objects stay aligned
+    enum : size_t {
+        HEADER_SIZE = (sizeof(Header) + SizeClassArena::ALIGNMENT - 1)
+                        / SizeClassArena::ALIGNMENT * SizeClassArena::ALIGNMENT
+    };
+
+public:
+    static SizeClassArena *& activeArena() {
+        static thread_local SizeClassArena *active = nullptr;
+        return active;
+    }
+
+    static void *operator new(size_t size) {
+        auto *arena = activeArena();
+
+        size += HEADER_SIZE;
+        char *mem = static_cast<char *>(arena ? arena->allocate(size)
+                                              : ::operator new(size));
+        new (mem) Header{arena, size};
+        return mem + HEADER_SIZE;
+    }
+
+    static void operator delete(void *obj) {
+        if (!obj)
+            return;
+
+        char *mem = static_cast<char *>(obj) - HEADER_SIZE;
+        auto *hdr = reinterpret_cast<Header *>(mem);
+        if (hdr->arena)
+            hdr->arena->deallocate(mem, hdr->size);
+        else
+            ::operator delete(mem);
+    }
+};
+
+///
+// Allocator for standard containers that takes the memory from the arena
+// that is active in the current thread at the time of its construction
+// (or from the heap if there is no active arena)
+template <typename T>
+class ArenaAllocator {
+    template <typename U> friend class ArenaAllocator;
+
+    SizeClassArena *_arena;
+
+public:
+    using value_type = T;
+
+    ArenaAllocator() : _arena(ArenaAllocated::activeArena()) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other._arena) {}
+
+    T *allocate(size_t n) {
+        static_assert(alignof(T) <= SizeClassArena::ALIGNMENT,
+                      "Unsupported alignment");
+        void *mem = _arena ? _arena->allocate(n * sizeof(T))
+                           : ::operator new(n * sizeof(T));
+        return static_cast<T *>(mem);
+    }
+
+    void deallocate(T *mem, size_t n) {
+        if (_arena)
+            _arena->deallocate(mem, n * sizeof(T));
+        else
+            ::operator delete(mem);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return _arena == other._arena;
+    }
+
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return _arena != other._arena;
+    }
+};
+
+///
+// Make the arena active in the current thread
+// for the lifetime of this object
+class ArenaScope {
+    SizeClassArena *_prev;
+
+public:
+    ArenaScope(SizeClassArena *arena)
+    : _prev(ArenaAllocated::activeArena()) {
+        ArenaAllocated::activeArena() = arena;
+    }
+
+    ~ArenaScope() { ArenaAllocated::activeArena() = _prev; }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // _DG_ADT_ARENA_H_
@@ -0,0 +1,195 @@
+#ifndef _DG_BDD_H_
+#define _DG_BDD_H_
+
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <cassert>
+#include <cstdint>
+
+namespace dg {
+namespace ADT {
+
+///
+// A small self-contained package of reduced ordered binary
+// decision diagrams. Nodes are hash-consed in a unique table,
+// so two equal functions are represented by the same node
+// and the results of the binary operations are cached
+// (in a lossy cache of a fixed size).
+// The nodes are never freed (there is no garbage collection),
+// they live as long as the manager does.
+//
+// Variables are numbered 0, 1, ..., getVarsNum() - 1 from the root.
+class BddManager {
+public:
+    using NodeT = uint32_t;
+
+    // the terminal nodes
+    enum : NodeT { ZERO = 0, ONE = 1 };
+
+private:
+    struct Node {
+        unsigned var;
+        NodeT low;
+        NodeT high;
+
+        Node(unsigned v, NodeT l, NodeT h) : var(v), low(l), high(h) {}
+
+        bool operator==(const Node& rhs) const {
+            return var == rhs.var && low == rhs.low && high == rhs.high;
+        }
+    };
+
+    struct NodeHash {
+        size_t operator()(const Node& n) const {
+            uint64_t h = (static_cast<uint64_t>(n.low) << 32) | n.high;
+            h ^= static_cast<uint64_t>(n.var) * 0x9e3779b97f4a7c15ULL;
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+
+    enum class Op : uint8_t { AND, OR, DIFF };
+
+    unsigned _varsNum;
+    std::vector<Node> _nodes;
+    std::unordered_map<Node, NodeT, NodeHash> _unique;
+
+    // the cache of results of operations. It has a fixed size
+    // and an entry is overwritten on a collision, so the memory
+    // does not grow with the number of operations
+    struct CacheEntry {
+        NodeT a{ZERO}, b{ZERO}, res{ZERO};
+        Op op{Op::AND};
+        bool valid{false};
+    };
+
+    static const size_t CACHE_SIZE = 1 << 18;
+    std::vector<CacheEntry> _cache;
+
+    static size_t _cacheIdx(Op op, NodeT a, NodeT b) {
+        uint64_t h = ((static_cast<uint64_t>(a) << 32) | b) * 0x9e3779b97f4a7c15ULL;
+        h ^= static_cast<uint64_t>(op);
+        return static_cast<size_t>(h >> 46) & (CACHE_SIZE - 1);
+    }
+
+    // terminal case of the operation if there is one,
+    // returns true if 'res' was set
+    static bool _terminal(Op op, NodeT a, NodeT b, NodeT& res) {
+        switch (op) {
+            case Op::AND:
+                if (a == ZERO || b == ZERO) { res = ZERO; return true; }
+                if (a == ONE || a == b) { res = b; return true; }
+                if (b == ONE) { res = a; return true; }
+                return false;
+            case Op::OR:
+                if (a == ONE || b == ONE) { res = ONE; return true; }
+                if (a == ZERO || a == b) { res = b; return true; }
+                if (b == ZERO) { res = a; return true; }
+                return false;
+            case Op::DIFF:
+                if (a == ZERO || b == ONE || a == b) { res = ZERO; return true; }
+                if (b == ZERO) { res = a; return true; }
+                return false;
+        }
+        return false;
+    }
+
+    NodeT _apply(Op op, NodeT a, NodeT b) {
+        NodeT res;
+        if (_terminal(op, a, b, res))
+            return res;
+
+        // AND and OR are commutative
+        if (op != Op::DIFF && a > b)
+            std::swap(a, b);
+
+        auto& entry = _cache[_cacheIdx(op, a, b)];
+        if (entry.valid && entry.op == op && entry.a == a && entry.b == b)
+            return entry.res;
+
+        unsigned va = getVar(a), vb = getVar(b);
+        unsigned v = va < vb ? va : vb;
+        NodeT al = va == v ? _nodes[a].low : a;
+        NodeT ah = va == v ? _nodes[a].high : a;
+        NodeT bl = vb == v ? _nodes[b].low : b;
+        NodeT bh = vb == v ? _nodes[b].high : b;
+
+        NodeT low = _apply(op, al, bl);
+        NodeT high = _apply(op, ah, bh);
+        res = mk(v, low, high);
+
+        auto& newEntry = _cache[_cacheIdx(op, a, b)];
+        newEntry.a = a;
+        newEntry.b = b;
+        newEntry.op = op;
+        newEntry.res = res;
+        newEntry.valid = true;
+        return res;
+    }
+
+public:
+    BddManager(unsigned varsNum) : _varsNum(varsNum), _cache(CACHE_SIZE) {
+        // the terminals are below all variables
+        _nodes.emplace_back(varsNum, ZERO, ZERO);
+        _nodes.emplace_back(varsNum, ONE, ONE);
+    }
+
+    unsigned getVarsNum() const { return _varsNum; }
+    size_t getNodesNum() const { return _nodes.size(); }
+
+    unsigned getVar(NodeT n) const { return _nodes[n].var; }
+    NodeT getLow(NodeT n) const { return _nodes[n].low; }
+    NodeT getHigh(NodeT n) const { return _nodes[n].high; }
+
+    // get the (unique) node for the given variable and children
+    NodeT mk(unsigned var, NodeT low, NodeT high) {
+        assert(var < _varsNum);
+        assert(var < getVar(low) && var < getVar(high));
+        if (low == high)
+            return low;
+
+        Node key(var, low, high);
+        auto it = _unique.find(key);
+        if (it != _unique.end())
+            return it->second;
+
+        assert(_nodes.size() < UINT32_MAX && "Out of BDD nodes");
+        NodeT n = static_cast<NodeT>(_nodes.size());
+        _nodes.push_back(key);
+        _unique.emplace(key, n);
+        return n;
+    }
+
+    NodeT bddAnd(NodeT a, NodeT b) { return _apply(Op::AND, a, b); }
+    NodeT bddOr(NodeT a, NodeT b) { return _apply(Op::OR, a, b); }
+    // a & !b
+    NodeT bddDiff(NodeT a, NodeT b) { return _apply(Op::DIFF, a, b); }
+
+    ///
+    // Get the conjunction that assigns the 'width' variables
+    // starting at 'firstVar' to the bits of 'value'
+    // (the most significant bit is the first variable).
+    // The other variables are not constrained.
+    NodeT cube(unsigned firstVar, unsigned width, uint64_t value,
+               NodeT rest = ONE) {
+        assert(width <= 64);
+        assert(firstVar + width <= _varsNum);
+        assert(getVar(rest) >= firstVar + width);
+
+        NodeT n = rest;
+        for (unsigned i = 0; i < width; ++i) {
+            unsigned var = firstVar + width - 1 - i;
+            if ((value >> i) & 0x1)
+                n = mk(var, ZERO, n);
+            else
+                n = mk(var, n, ZERO);
+        }
+
+        return n;
+    }
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // _DG_BDD_H_
@@ -2,13 +2,19 @@
 #define _DG_SPARSE_BITVECTOR_H_
 
 #include <map>
+#include <vector>
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 
 namespace dg {
 namespace ADT {
 
+// Sparse bitvector that keeps the words in a std::map.
+// This is the original implementation, it is kept
+// for comparison with the flat implementation below.
 template <typename BitsT = uint64_t, typename ShiftT = uint64_t, size_t SCALE = 1>
-class SparseBitvectorImpl {
+class SparseBitvectorMapImpl {
     // mapping from shift to bits
     using BitsContainerT = std::map<ShiftT, BitsT>;
     BitsContainerT _bits{};
@@ -37,15 +43,15 @@ class SparseBitvectorImpl {
     }
 
 public:
-    SparseBitvectorImpl() = default;
-    SparseBitvectorImpl(size_t i) { set(i); } // singleton ctor
+    SparseBitvectorMapImpl() = default;
+    SparseBitvectorMapImpl(size_t i) { set(i); } // singleton ctor
 
-    SparseBitvectorImpl(const SparseBitvectorImpl&) = default;
-    SparseBitvectorImpl(SparseBitvectorImpl&&) = default;
+    SparseBitvectorMapImpl(const SparseBitvectorMapImpl&) = default;
+    SparseBitvectorMapImpl(SparseBitvectorMapImpl&&) = default;
 
     void reset() { _bits.clear(); }
     bool empty() const { return _bits.empty(); }
-    void swap(SparseBitvectorImpl& oth) { _bits.swap(oth._bits); }
+    void swap(SparseBitvectorMapImpl& oth) { _bits.swap(oth._bits); }
 
     bool get(size_t i) const {
         auto sft = _shift(i);
@@ -75,7 +81,7 @@ public:
     }
 
     // union operation
-    bool set(const SparseBitvectorImpl& rhs) {
+    bool set(const SparseBitvectorMapImpl& rhs) {
         bool changed = false;
         for (auto& pair : rhs._bits) {
             auto& B = _bits[pair.first];
@@ -229,6 +235,294 @@ public:
             return !operator==(rhs);
         }
 
+        friend class SparseBitvectorMapImpl;
+    };
+
+    const_iterator begin() const { return const_iterator(_bits); }
+    const_iterator end() const { return const_iterator(_bits, true /* end */); }
+
+    friend class const_iterator;
+};
+
+// Sparse bitvector that keeps the (shift, bits) pairs
+// in a vector sorted by the shift. Compared to the map-based
+// implementation, the words are stored contiguously in memory,
+// the union is a linear merge of the two sorted sequences
+// and the number of set bits is maintained in a variable.
+template <typename BitsT = uint64_t, typename ShiftT = uint64_t, size_t SCALE = 1>
+class SparseBitvectorImpl {
+    struct Word {
+        ShiftT shift;
+        BitsT bits;
+
+        Word(ShiftT s, BitsT b) : shift(s), bits(b) {}
+    };
+
+    using BitsContainerT = std::vector<Word>;
+    BitsContainerT _bits{};
+    // the number of set bits
+    size_t _size{0};
+
+    static size_t _bitsNum() { return sizeof(BitsT) * 8; }
+    static ShiftT _shift(size_t i) { return i - (i % _bitsNum()); }
+    static BitsT _bit(size_t i, ShiftT sft) {
+        return static_cast<BitsT>(1) << (i - sft);
+    }
+
+    static size_t _countBits(BitsT bits) {
+        static_assert(sizeof(BitsT) <= sizeof(unsigned long long),
+                      "Unsupported type of bits");
+        return __builtin_popcountll(static_cast<unsigned long long>(bits));
+    }
+
+    typename BitsContainerT::iterator _find(ShiftT sft) {
+        return std::lower_bound(_bits.begin(), _bits.end(), sft,
+                                [](const Word& w, ShiftT s) { return w.shift < s; });
+    }
+
+    typename BitsContainerT::const_iterator _find(ShiftT sft) const {
+        return std::lower_bound(_bits.begin(), _bits.end(), sft,
+                                [](const Word& w, ShiftT s) { return w.shift < s; });
+    }
+
+    // merge 'rhs' into this bitvector. We know that 'rhs'
+    // contains a word that is not in this bitvector,
+    // so we must create a new container.
+    void _mergeNew(const SparseBitvectorImpl& rhs) {
+        BitsContainerT tmp;
+        tmp.reserve(_bits.size() + rhs._bits.size());
+
+        auto it = _bits.begin(), et = _bits.end();
+        auto rit = rhs._bits.begin(), ret = rhs._bits.end();
+        while (it != et && rit != ret) {
+            if (it->shift < rit->shift) {
+                tmp.push_back(*it);
+                ++it;
+            } else if (rit->shift < it->shift) {
+                tmp.push_back(*rit);
+                _size += _countBits(rit->bits);
+                ++rit;
+            } else {
+                BitsT B = it->bits | rit->bits;
+                _size += _countBits(B) - _countBits(it->bits);
+                tmp.emplace_back(it->shift, B);
+                ++it;
+                ++rit;
+            }
+        }
+
+        tmp.insert(tmp.end(), it, et);
+        for (; rit != ret; ++rit) {
+            tmp.push_back(*rit);
+            _size += _countBits(rit->bits);
+        }
+
+        _bits.swap(tmp);
+    }
+
+public:
+    SparseBitvectorImpl() = default;
+    SparseBitvectorImpl(size_t i) { set(i); } // singleton ctor
+
+    SparseBitvectorImpl(const SparseBitvectorImpl&) = default;
+    SparseBitvectorImpl(SparseBitvectorImpl&&) = default;
+    SparseBitvectorImpl& operator=(const SparseBitvectorImpl&) = default;
+    SparseBitvectorImpl& operator=(SparseBitvectorImpl&&) = default;
+
+    void reset() { _bits.clear(); _size = 0; }
+    bool empty() const { return _bits.empty(); }
+    void swap(SparseBitvectorImpl& oth) {
+        _bits.swap(oth._bits);
+        std::swap(_size, oth._size);
+    }
+
+    bool get(size_t i) const {
+        auto sft = _shift(i);
+        assert(sft % _bitsNum() == 0);
+
+        auto it = _find(sft);
+        if (it == _bits.end() || it->shift != sft) {
+            return false;
+        }
+
+        return (it->bits & _bit(i, sft));
+    }
+
+    // returns the previous value of the i-th bit
+    bool set(size_t i) {
+        auto sft = _shift(i);
+        // the elements are often added in increasing order,
+        // so check the last word before searching
+        if (_bits.empty() || _bits.back().shift < sft) {
+            _bits.emplace_back(sft, _bit(i, sft));
+            ++_size;
+            return false;
+        }
+
+        auto it = _find(sft);
+        if (it == _bits.end() || it->shift != sft) {
+            _bits.emplace(it, sft, _bit(i, sft));
+            ++_size;
+            return false;
+        }
+
+        bool prev = (it->bits & _bit(i, sft));
+        if (!prev) {
+            it->bits |= _bit(i, sft);
+            ++_size;
+        }
+
+        return prev;
+    }
+
+    // union operation
+    bool set(const SparseBitvectorImpl& rhs) {
+        if (rhs.empty() || &rhs == this)
+            return false;
+
+        if (empty()) {
+            _bits = rhs._bits;
+            _size = rhs._size;
+            return true;
+        }
+
+        // first try to merge in place -- that is possible
+        // if every word of 'rhs' is already present here
+        auto it = _bits.begin(), et = _bits.end();
+        auto rit = rhs._bits.begin(), ret = rhs._bits.end();
+        auto oldsize = _size;
+        for (; rit != ret; ++rit) {
+            while (it != et && it->shift < rit->shift)
+                ++it;
+            if (it == et || it->shift != rit->shift)
+                break;
+
+            BitsT B = it->bits | rit->bits;
+            if (B != it->bits) {
+                _size += _countBits(B) - _countBits(it->bits);
+                it->bits = B;
+            }
+        }
+
+        if (rit != ret) {
+            // a word that we do not have, we must merge
+            // the rest into a new container. The words that
+            // we have merged already will be just copied.
+            _mergeNew(rhs);
+            return true;
+        }
+
+        return oldsize != _size;
+    }
+
+    // returns the previous value of the i-th bit
+    bool unset(size_t i) {
+        auto sft = _shift(i);
+        auto it = _find(sft);
+        if (it == _bits.end() || it->shift != sft) {
+            return false;
+        }
+
+        if (!(it->bits & _bit(i, sft)))
+            return false;
+
+        it->bits &= ~_bit(i, sft);
+        --_size;
+        if (it->bits == 0) {
+            _bits.erase(it);
+        }
+
+        return true;
+    }
+
+    size_t size() const { return _size; }
+
+    bool operator==(const SparseBitvectorImpl& rhs) const {
+        if (_size != rhs._size || _bits.size() != rhs._bits.size())
+            return false;
+
+        return std::equal(_bits.begin(), _bits.end(), rhs._bits.begin(),
+                          [](const Word& a, const Word& b) {
+                              return a.shift == b.shift && a.bits == b.bits;
+                          });
+    }
+
+    bool operator!=(const SparseBitvectorImpl& rhs) const {
+        return !operator==(rhs);
+    }
+
+    // hash of the set bits, equal bitvectors have equal hashes
+    size_t hash() const {
+        size_t h = _size;
+        for (const auto& w : _bits) {
+            h ^= static_cast<size_t>(w.shift) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            h ^= static_cast<size_t>(w.bits) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+        }
+        return h;
+    }
+
+    class const_iterator {
+        typename BitsContainerT::const_iterator container_it;
+        typename BitsContainerT::const_iterator container_end;
+        size_t pos{0};
+
+        const_iterator(const BitsContainerT& cont, bool end = false)
+        :container_it(end ? cont.end() : cont.begin()),
+         container_end(cont.end()) {
+            // set-up the initial position
+            if (!end && !cont.empty())
+                _findClosestBit();
+        }
+
+        // find the first set bit on position >= pos
+        // in the current word
+        void _findClosestBit() {
+            assert(pos < (sizeof(BitsT)*8));
+            BitsT rest = container_it->bits & (~static_cast<BitsT>(0) << pos);
+            if (rest == 0)
+                pos = sizeof(BitsT)*8;
+            else
+                pos = __builtin_ctzll(static_cast<unsigned long long>(rest));
+        }
+
+    public:
+        const_iterator() = default;
+        const_iterator& operator++() {
+            // shift to the next bit in the current bits
+            assert(pos < (sizeof(BitsT)*8));
+            assert(container_it != container_end && "operator++ called on end");
+            if (++pos != sizeof(BitsT)*8)
+                _findClosestBit();
+
+            if (pos == sizeof(BitsT)*8) {
+                ++container_it;
+                pos = 0;
+                if (container_it != container_end) {
+                    assert(container_it->bits != 0 && "Empty bucket in a bitvector");
+                    _findClosestBit();
+                }
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        size_t operator*() const {
+            return container_it->shift + pos;
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            return pos == rhs.pos && (container_it == rhs.container_it);
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+
         friend class SparseBitvectorImpl;
     };
 
@@ -239,6 +533,7 @@ public:
 };
 
 using SparseBitvector = SparseBitvectorImpl<uint64_t, uint64_t, 1>;
+using SparseBitvectorMap = SparseBitvectorMapImpl<uint64_t, uint64_t, 1>;
 
 } // namespace ADT
 } // namespace dg
@@ -0,0 +1,572 @@
+#ifndef _DG_COMPRESSED_BITMAP_H_
+#define _DG_COMPRESSED_BITMAP_H_
+
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <cassert>
+#include <cstdint>
+
+#include "dg/ADT/HybridBitvector.h"
+
+namespace dg {
+namespace ADT {
+
+///
+// A set of 2^16 numbers (the low bits of the numbers
+// in one chunk of CompressedBitmap). Depending on the contents,
+// the numbers are stored as a sorted array, as a bitmap
+// or as a sorted array of runs of consecutive numbers.
+class BitmapContainer {
+public:
+    enum class Type : uint8_t { ARRAY, BITMAP, RUN };
+
+private:
+    enum : uint32_t {
+        // the maximal number of elements in the array container
+        ARRAY_MAX = 4096,
+        WORDS_NUM = (1 << 16) / 64,
+        // the size of the bitmap in bytes
+        BITMAP_BYTES = WORDS_NUM * 8
+    };
+
+    // the run of numbers start, start + 1, ..., start + length
+    struct Run {
+        uint16_t start;
+        uint16_t length;
+
+        Run(uint16_t s, uint16_t l) : start(s), length(l) {}
+        uint32_t last() const { return static_cast<uint32_t>(start) + length; }
+    };
+
+    Type _type{Type::ARRAY};
+    // the number of elements
+    uint32_t _card{0};
+    std::vector<uint16_t> _array;
+    std::vector<uint64_t> _bitmap;
+    std::vector<Run> _runs;
+
+    static uint64_t _bit(uint32_t v) { return static_cast<uint64_t>(1) << (v % 64); }
+
+    // call F on every element, in increasing order
+    template <typename F>
+    void _forEach(F f) const {
+        switch (_type) {
+            case Type::ARRAY:
+                for (auto v : _array)
+                    f(v);
+                break;
+            case Type::BITMAP:
+                for (uint32_t w = 0; w < WORDS_NUM; ++w) {
+                    uint64_t bits = _bitmap[w];
+                    while (bits) {
+                        f(static_cast<uint16_t>(w * 64 + __builtin_ctzll(bits)));
+                        bits &= bits - 1;
+                    }
+                }
+                break;
+            case Type::RUN:
+                for (const auto& r : _runs) {
+                    for (uint32_t v = r.start; v <= r.last(); ++v)
+                        f(static_cast<uint16_t>(v));
+                }
+                break;
+        }
+    }
+
+    size_t _countRuns() const {
+        switch (_type) {
+            case Type::RUN:
+                return _runs.size();
+            case Type::ARRAY: {
+                size_t runs = 0;
+                for (size_t i = 0; i < _array.size(); ++i) {
+                    if (i == 0 || _array[i] != _array[i - 1] + 1)
+                        ++runs;
+                }
+                return runs;
+            }
+            case Type::BITMAP: {
+                // the number of runs is the number of 01 transitions
+                size_t runs = 0;
+                uint64_t prevTop = 0;
+                for (uint32_t w = 0; w < WORDS_NUM; ++w) {
+                    uint64_t bits = _bitmap[w];
+                    uint64_t starts = bits & ~((bits << 1) | prevTop);
+                    runs += __builtin_popcountll(starts);
+                    prevTop = bits >> 63;
+                }
+                return runs;
+            }
+        }
+        return 0;
+    }
+
+    void _setRange(uint32_t from, uint32_t to) {
+        assert(_type == Type::BITMAP);
+        assert(from <= to && to < (1 << 16));
+        for (uint32_t w = from / 64; w <= to / 64; ++w) {
+            uint64_t mask = ~static_cast<uint64_t>(0);
+            if (w == from / 64)
+                mask &= ~static_cast<uint64_t>(0) << (from % 64);
+            if (w == to / 64 && to % 64 != 63)
+                mask &= (static_cast<uint64_t>(1) << (to % 64 + 1)) - 1;
+            _bitmap[w] |= mask;
+        }
+    }
+
+    void _recount() {
+        assert(_type == Type::BITMAP);
+        _card = static_cast<uint32_t>(detail::wordsCount(_bitmap.data(), WORDS_NUM));
+    }
+
+    void _toBitmap() {
+        if (_type == Type::BITMAP)
+            return;
+
+        _bitmap.assign(WORDS_NUM, 0);
+        if (_type == Type::ARRAY) {
+            for (auto v : _array)
+                _bitmap[v / 64] |= _bit(v);
+            std::vector<uint16_t>().swap(_array);
+            _type = Type::BITMAP;
+        } else {
+            _type = Type::BITMAP;
+            for (const auto& r : _runs)
+                _setRange(r.start, r.last());
+            std::vector<Run>().swap(_runs);
+        }
+    }
+
+    void _toArray() {
+        assert(_card <= ARRAY_MAX);
+        if (_type == Type::ARRAY)
+            return;
+
+        std::vector<uint16_t> tmp;
+        tmp.reserve(_card);
+        _forEach([&tmp](uint16_t v) { tmp.push_back(v); });
+        _array.swap(tmp);
+        std::vector<uint64_t>().swap(_bitmap);
+        std::vector<Run>().swap(_runs);
+        _type = Type::ARRAY;
+    }
+
+    void _toRuns() {
+        if (_type == Type::RUN)
+            return;
+
+        std::vector<Run> tmp;
+        _forEach([&tmp](uint16_t v) {
+            if (!tmp.empty() && tmp.back().last() + 1 == v)
+                ++tmp.back().length;
+            else
+                tmp.emplace_back(v, 0);
+        });
+        _runs.swap(tmp);
+        std::vector<uint16_t>().swap(_array);
+        std::vector<uint64_t>().swap(_bitmap);
+        _type = Type::RUN;
+    }
+
+    // the run that contains v or the last run that starts before v
+    // (or _runs.end() if there is no such run)
+    std::vector<Run>::const_iterator _findRun(uint16_t v) const {
+        auto it = std::upper_bound(_runs.begin(), _runs.end(), v,
+                                   [](uint16_t x, const Run& r) { return x < r.start; });
+        if (it == _runs.begin())
+            return _runs.end();
+        return --it;
+    }
+
+    bool _setRun(uint16_t v) {
+        assert(_type == Type::RUN);
+        auto cit = _findRun(v);
+        if (cit != _runs.end() && v <= cit->last())
+            return true;
+
+        // the run that is after v
+        auto next = cit == _runs.end() ? _runs.begin() : _runs.begin() + (cit - _runs.begin()) + 1;
+        bool extendsPrev = cit != _runs.end() && cit->last() + 1 == v;
+        bool extendsNext = next != _runs.end() && static_cast<uint32_t>(v) + 1 == next->start;
+
+        if (extendsPrev && extendsNext) {
+            auto prev = _runs.begin() + (cit - _runs.begin());
+            prev->length += next->length + 2;
+            _runs.erase(next);
+        } else if (extendsPrev) {
+            ++(_runs.begin() + (cit - _runs.begin()))->length;
+        } else if (extendsNext) {
+            --next->start;
+            ++next->length;
+        } else {
+            _runs.emplace(next, v, 0);
+        }
+
+        ++_card;
+        return false;
+    }
+
+    void _unionRuns(const BitmapContainer& rhs) {
+        assert(_type == Type::RUN && rhs._type == Type::RUN);
+        std::vector<Run> tmp;
+        tmp.reserve(_runs.size() + rhs._runs.size());
+        std::merge(_runs.begin(), _runs.end(), rhs._runs.begin(), rhs._runs.end(),
+                   std::back_inserter(tmp),
+                   [](const Run& a, const Run& b) { return a.start < b.start; });
+
+        // coalesce overlapping and adjacent runs
+        std::vector<Run> res;
+        res.reserve(tmp.size());
+        _card = 0;
+        for (const auto& r : tmp) {
+            if (!res.empty() && r.start <= res.back().last() + 1) {
+                if (r.last() > res.back().last())
+                    res.back().length = static_cast<uint16_t>(r.last() - res.back().start);
+            } else {
+                res.push_back(r);
+            }
+        }
+        for (const auto& r : res)
+            _card += static_cast<uint32_t>(r.length) + 1;
+        _runs.swap(res);
+    }
+
+public:
+    Type getType() const { return _type; }
+    uint32_t size() const { return _card; }
+    bool empty() const { return _card == 0; }
+
+    bool get(uint16_t v) const {
+        switch (_type) {
+            case Type::ARRAY:
+                return std::binary_search(_array.begin(), _array.end(), v);
+            case Type::BITMAP:
+                return _bitmap[v / 64] & _bit(v);
+            case Type::RUN: {
+                auto it = _findRun(v);
+                return it != _runs.end() && v <= it->last();
+            }
+        }
+        return false;
+    }
+
+    // returns the previous value of the bit
+    bool set(uint16_t v) {
+        switch (_type) {
+            case Type::ARRAY: {
+                auto it = std::lower_bound(_array.begin(), _array.end(), v);
+                if (it != _array.end() && *it == v)
+                    return true;
+
+                if (_card < ARRAY_MAX) {
+                    _array.insert(it, v);
+                    ++_card;
+                    return false;
+                }
+
+                // the array is full, numbers in ranges are better
+                // stored as runs, otherwise use the bitmap
+                if (_countRuns() * sizeof(Run) < BITMAP_BYTES) {
+                    _toRuns();
+                    return _setRun(v);
+                }
+                _toBitmap();
+                return set(v);
+            }
+            case Type::BITMAP:
+                if (_bitmap[v / 64] & _bit(v))
+                    return true;
+                _bitmap[v / 64] |= _bit(v);
+                ++_card;
+                return false;
+            case Type::RUN:
+                if (_runs.size() * sizeof(Run) >= BITMAP_BYTES) {
+                    _toBitmap();
+                    return set(v);
+                }
+                return _setRun(v);
+        }
+        return false;
+    }
+
+    // union, returns true if this container changed
+    bool set(const BitmapContainer& rhs) {
+        if (rhs.empty())
+            return false;
+
+        auto oldCard = _card;
+        if (_type == Type::RUN && rhs._type == Type::RUN) {
+            _unionRuns(rhs);
+            if (_runs.size() * sizeof(Run) >= BITMAP_BYTES)
+                _toBitmap();
+        } else if (_type == Type::BITMAP || rhs._type == Type::BITMAP ||
+                   _card + rhs._card > ARRAY_MAX) {
+            _toBitmap();
+            switch (rhs._type) {
+                case Type::BITMAP:
+                    detail::wordsOr(_bitmap.data(), rhs._bitmap.data(), WORDS_NUM);
+                    break;
+                case Type::ARRAY:
+                    for (auto v : rhs._array)
+                        _bitmap[v / 64] |= _bit(v);
+                    break;
+                case Type::RUN:
+                    for (const auto& r : rhs._runs)
+                        _setRange(r.start, r.last());
+                    break;
+            }
+            _recount();
+        } else {
+            // the result fits into an array
+            _toArray();
+            std::vector<uint16_t> other;
+            other.reserve(rhs._card);
+            rhs._forEach([&other](uint16_t v) { other.push_back(v); });
+
+            std::vector<uint16_t> tmp;
+            tmp.reserve(_card + rhs._card);
+            std::set_union(_array.begin(), _array.end(), other.begin(), other.end(),
+                           std::back_inserter(tmp));
+            _array.swap(tmp);
+            _card = static_cast<uint32_t>(_array.size());
+        }
+
+        return _card != oldCard;
+    }
+
+    // convert the container to the representation
+    // that takes the least memory
+    void optimize() {
+        size_t runBytes = _countRuns() * sizeof(Run);
+        size_t arrayBytes = _card <= ARRAY_MAX ? _card * sizeof(uint16_t) : BITMAP_BYTES + 1;
+        if (runBytes < arrayBytes && runBytes < BITMAP_BYTES)
+            _toRuns();
+        else if (arrayBytes <= BITMAP_BYTES)
+            _toArray();
+        else
+            _toBitmap();
+    }
+
+    ///
+    // Position in the container: the index into the array
+    // or into the runs (unused for bitmap) and the value
+    struct Position {
+        uint32_t idx{0};
+        uint32_t val{0};
+    };
+
+    // the position of the first element, the container must not be empty
+    Position first() const {
+        assert(!empty());
+        Position pos;
+        switch (_type) {
+            case Type::ARRAY:
+                pos.val = _array[0];
+                break;
+            case Type::RUN:
+                pos.val = _runs[0].start;
+                break;
+            case Type::BITMAP:
+                pos.val = 0;
+                if (!(_bitmap[0] & 0x1))
+                    advance(pos);
+                break;
+        }
+        return pos;
+    }
+
+    // move to the next element, return false if there is none
+    bool advance(Position& pos) const {
+        switch (_type) {
+            case Type::ARRAY:
+                if (++pos.idx >= _array.size())
+                    return false;
+                pos.val = _array[pos.idx];
+                return true;
+            case Type::RUN:
+                if (pos.val < _runs[pos.idx].last()) {
+                    ++pos.val;
+                    return true;
+                }
+                if (++pos.idx >= _runs.size())
+                    return false;
+                pos.val = _runs[pos.idx].start;
+                return true;
+            case Type::BITMAP: {
+                uint32_t v = pos.val + 1;
+                if (v >= (1 << 16))
+                    return false;
+                uint32_t w = v / 64;
+                uint64_t rest = _bitmap[w] & (~static_cast<uint64_t>(0) << (v % 64));
+                while (rest == 0) {
+                    if (++w == WORDS_NUM)
+                        return false;
+                    rest = _bitmap[w];
+                }
+                pos.val = w * 64 + __builtin_ctzll(rest);
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+///
+// Compressed bitmap in the style of Roaring bitmaps.
+// The numbers are split into chunks of 2^16 numbers
+// with the same high bits and every chunk has its own container
+// (see BitmapContainer). The chunks are kept in a vector
+// sorted by the high bits.
+class CompressedBitmap {
+    struct Chunk {
+        uint64_t key;
+        BitmapContainer cont;
+
+        Chunk(uint64_t k) : key(k) {}
+    };
+
+    std::vector<Chunk> _chunks;
+
+    static uint64_t _key(uint64_t n) { return n >> 16; }
+    static uint16_t _low(uint64_t n) { return static_cast<uint16_t>(n & 0xffff); }
+
+    std::vector<Chunk>::const_iterator _find(uint64_t key) const {
+        return std::lower_bound(_chunks.begin(), _chunks.end(), key,
+                                [](const Chunk& c, uint64_t k) { return c.key < k; });
+    }
+
+public:
+    CompressedBitmap() = default;
+    CompressedBitmap(uint64_t n) { set(n); } // singleton ctor
+
+    void reset() { _chunks.clear(); }
+    bool empty() const { return _chunks.empty(); }
+    void swap(CompressedBitmap& oth) { _chunks.swap(oth._chunks); }
+
+    // O(number of containers)
+    size_t size() const {
+        size_t num = 0;
+        for (const auto& c : _chunks)
+            num += c.cont.size();
+        return num;
+    }
+
+    size_t getContainersNum() const { return _chunks.size(); }
+
+    bool get(uint64_t n) const {
+        auto it = _find(_key(n));
+        if (it == _chunks.end() || it->key != _key(n))
+            return false;
+        return it->cont.get(_low(n));
+    }
+
+    // returns the previous value of the n-th bit
+    bool set(uint64_t n) {
+        auto key = _key(n);
+        // the numbers are often added in increasing order
+        if (_chunks.empty() || _chunks.back().key < key) {
+            _chunks.emplace_back(key);
+            return _chunks.back().cont.set(_low(n));
+        }
+
+        auto it = _chunks.begin() + (_find(key) - _chunks.begin());
+        if (it == _chunks.end() || it->key != key)
+            it = _chunks.emplace(it, key);
+        return it->cont.set(_low(n));
+    }
+
+    // union operation, returns true if this bitmap changed
+    bool set(const CompressedBitmap& rhs) {
+        if (rhs.empty() || &rhs == this)
+            return false;
+
+        bool changed = false;
+        std::vector<Chunk> tmp;
+        tmp.reserve(_chunks.size() + rhs._chunks.size());
+
+        auto it = _chunks.begin(), et = _chunks.end();
+        auto rit = rhs._chunks.begin(), ret = rhs._chunks.end();
+        while (it != et || rit != ret) {
+            if (rit == ret || (it != et && it->key < rit->key)) {
+                tmp.push_back(std::move(*it));
+                ++it;
+            } else if (it == et || rit->key < it->key) {
+                tmp.push_back(*rit);
+                changed = true;
+                ++rit;
+            } else {
+                changed |= it->cont.set(rit->cont);
+                tmp.push_back(std::move(*it));
+                ++it;
+                ++rit;
+            }
+        }
+
+        _chunks.swap(tmp);
+        return changed;
+    }
+
+    // convert every container to the representation
+    // that takes the least memory
+    void optimize() {
+        for (auto& c : _chunks)
+            c.cont.optimize();
+    }
+
+    class const_iterator {
+        typename std::vector<Chunk>::const_iterator chunk_it;
+        typename std::vector<Chunk>::const_iterator chunk_end;
+        BitmapContainer::Position pos;
+
+        const_iterator(const std::vector<Chunk>& chunks, bool end = false)
+        : chunk_it(end ? chunks.end() : chunks.begin()), chunk_end(chunks.end()) {
+            if (chunk_it != chunk_end)
+                pos = chunk_it->cont.first();
+        }
+
+    public:
+        const_iterator() = default;
+
+        const_iterator& operator++() {
+            assert(chunk_it != chunk_end && "operator++ called on end");
+            if (!chunk_it->cont.advance(pos)) {
+                ++chunk_it;
+                pos = BitmapContainer::Position();
+                if (chunk_it != chunk_end)
+                    pos = chunk_it->cont.first();
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        uint64_t operator*() const {
+            return (chunk_it->key << 16) | pos.val;
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            return chunk_it == rhs.chunk_it && pos.val == rhs.pos.val;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class CompressedBitmap;
+    };
+
+    const_iterator begin() const { return const_iterator(_chunks); }
+    const_iterator end() const { return const_iterator(_chunks, true /* end */); }
+
+    friend class const_iterator;
+};
+
+} // namespace ADT
+} // namespace dg
+
+#endif // _DG_COMPRESSED_BITMAP_H_
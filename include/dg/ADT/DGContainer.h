@@ -2,24 +2,208 @@
 #define _DG_CONTAINER_H_
 
 #include <set>
+#include <new>
+#include <utility>
 #include <cassert>
+#include <cstdint>
 #include <algorithm>
+#include <type_traits>
 
 namespace dg {
 
+/// ------------------------------------------------------------------
+// - SmallSortedVector
+//
+//   Set of values kept in a sorted array. Up to N values are stored
+//   inline in the object, the array is allocated on the heap only
+//   when there are more values. Lookup is a binary search, so this is
+//   much cheaper than std::set for the few edges that nodes usually
+//   have. Iterators are invalidated by insert and erase.
+//   The values must be trivially copyable (pointers, small structs).
+/// ------------------------------------------------------------------
+template <typename ValueT, unsigned int N>
+class SmallSortedVector
+{
+    static_assert(std::is_trivially_copyable<ValueT>::value,
+                  "SmallSortedVector stores only trivially copyable values");
+
+    using StorageT
+        = typename std::aligned_storage<sizeof(ValueT) * (N > 0 ? N : 1),
+                                        alignof(ValueT)>::type;
+
+    ValueT *_data;
+    uint32_t _size{0};
+    uint32_t _capacity{N};
+    StorageT _inline;
+
+    ValueT *_inlineData() { return reinterpret_cast<ValueT *>(&_inline); }
+    bool _isInline() const
+    {
+        return _data == reinterpret_cast<const ValueT *>(&_inline);
+    }
+
+    void _free()
+    {
+        if (!_isInline())
+            ::operator delete(_data);
+        _data = _inlineData();
+        _capacity = N;
+    }
+
+    void _grow()
+    {
+        uint32_t cap = _capacity > 0 ? 2 * _capacity : 4;
+        auto *mem = static_cast<ValueT *>(::operator new(cap * sizeof(ValueT)));
+        std::copy(_data, _data + _size, mem);
+        if (!_isInline())
+            ::operator delete(_data);
+        _data = mem;
+        _capacity = cap;
+    }
+
+    // take the contents of 'oth', this must be empty and inline
+    void _steal(SmallSortedVector& oth)
+    {
+        assert(_isInline() && _size == 0);
+        if (oth._isInline()) {
+            std::copy(oth._data, oth._data + oth._size, _data);
+        } else {
+            _data = oth._data;
+            _capacity = oth._capacity;
+            oth._data = oth._inlineData();
+            oth._capacity = N;
+        }
+        _size = oth._size;
+        oth._size = 0;
+    }
+
+public:
+    using iterator = const ValueT *;
+    using const_iterator = const ValueT *;
+    using size_type = size_t;
+
+    SmallSortedVector() : _data(_inlineData()) {}
+    ~SmallSortedVector() { _free(); }
+
+    SmallSortedVector(const SmallSortedVector& oth) : _data(_inlineData())
+    {
+        while (_capacity < oth._size)
+            _grow();
+        std::copy(oth._data, oth._data + oth._size, _data);
+        _size = oth._size;
+    }
+
+    SmallSortedVector(SmallSortedVector&& oth) : _data(_inlineData())
+    {
+        _steal(oth);
+    }
+
+    SmallSortedVector& operator=(const SmallSortedVector& oth)
+    {
+        if (&oth != this) {
+            SmallSortedVector tmp(oth);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    SmallSortedVector& operator=(SmallSortedVector&& oth)
+    {
+        if (&oth != this) {
+            clear();
+            _steal(oth);
+        }
+        return *this;
+    }
+
+    const_iterator begin() const { return _data; }
+    const_iterator end() const { return _data + _size; }
+
+    size_type size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    const_iterator find(const ValueT& val) const
+    {
+        auto it = std::lower_bound(begin(), end(), val);
+        if (it != end() && !(val < *it))
+            return it;
+        return end();
+    }
+
+    size_type count(const ValueT& val) const { return find(val) != end(); }
+
+    std::pair<const_iterator, bool> insert(const ValueT& val)
+    {
+        // edges are often added in increasing order
+        ValueT *pos = _data + _size;
+        if (_size > 0 && !(_data[_size - 1] < val)) {
+            pos = const_cast<ValueT *>(std::lower_bound(begin(), end(), val));
+            if (!(val < *pos))
+                return {pos, false};
+        }
+
+        size_t idx = pos - _data;
+        if (_size == _capacity)
+            _grow();
+
+        std::copy_backward(_data + idx, _data + _size, _data + _size + 1);
+        _data[idx] = val;
+        ++_size;
+        return {_data + idx, true};
+    }
+
+    size_type erase(const ValueT& val)
+    {
+        auto it = find(val);
+        if (it == end())
+            return 0;
+
+        auto *pos = const_cast<ValueT *>(it);
+        std::copy(pos + 1, _data + _size, pos);
+        --_size;
+        return 1;
+    }
+
+    void clear()
+    {
+        _size = 0;
+        _free();
+    }
+
+    void swap(SmallSortedVector& oth)
+    {
+        if (!_isInline() && !oth._isInline()) {
+            std::swap(_data, oth._data);
+            std::swap(_size, oth._size);
+            std::swap(_capacity, oth._capacity);
+            return;
+        }
+
+        SmallSortedVector tmp(std::move(oth));
+        oth = std::move(*this);
+        *this = std::move(tmp);
+    }
+};
+
 /// ------------------------------------------------------------------
 // - DGContainer
 //
 //   This is basically just a wrapper for real container, so that
 //   we have the container defined on one place for all edges.
-//   It may have more implementations depending on available features
+//   It may have more implementations depending on available features.
+//   By default, the values are kept in a small sorted vector with
+//   EXPECTED_ELEMENTS_NUM values stored inline. Define
+//   DG_CONTAINER_STD_SET to use std::set instead.
 /// ------------------------------------------------------------------
 template <typename ValueT, unsigned int EXPECTED_ELEMENTS_NUM = 8>
 class DGContainer
 {
 public:
-    // XXX use llvm ADTs when available, or BDDs?
+#ifdef DG_CONTAINER_STD_SET
     using ContainerT = typename std::set<ValueT>;
+#else
+    using ContainerT = SmallSortedVector<ValueT, EXPECTED_ELEMENTS_NUM>;
+#endif
     using iterator = typename ContainerT::iterator;
     using const_iterator = typename ContainerT::const_iterator;
     using size_type = typename ContainerT::size_type;
@@ -54,7 +238,7 @@ public:
         container.clear();
     }
 
-    bool empty()
+    bool empty() const
     {
         return container.empty();
     }
@@ -68,11 +252,12 @@ public:
     {
         DGContainer<ValueT, EXPECTED_ELEMENTS_NUM> tmp;
 
-        std::set_intersection(container.begin(), container.end(),
-                              oth.container.begin(),
-                              oth.container.end(),
-                              std::inserter(tmp.container,
-                                            tmp.container.begin()));
+        // the containers are ordered, so the values
+        // are inserted at the end of 'tmp'
+        for (const auto& val : container) {
+            if (oth.contains(val))
+                tmp.insert(val);
+        }
 
         // swap containers
         container.swap(tmp.container);
@@ -83,14 +268,9 @@ public:
         if (container.size() != oth.size())
             return false;
 
-        // the sets are ordered, so this will work
-        iterator snd = oth.container.begin();
-        for (iterator fst = container.begin(), efst = container.end();
-             fst != efst; ++fst, ++snd)
-            if (*fst != *snd)
-                return false;
-
-        return true;
+        // the containers are ordered, so this will work
+        return std::equal(container.begin(), container.end(),
+                          oth.container.begin());
     }
 
     bool operator!=(const DGContainer<ValueT, EXPECTED_ELEMENTS_NUM>& oth) const
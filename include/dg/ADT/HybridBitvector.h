@@ -0,0 +1,545 @@
+#ifndef _DG_HYBRID_BITVECTOR_H_
+#define _DG_HYBRID_BITVECTOR_H_
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "dg/ADT/Bitvector.h"
+
+namespace dg {
+namespace ADT {
+
+namespace detail {
+
+// Kernels working on arrays of 64-bit words. They use SIMD
+// instructions when the compiler is allowed to use them
+// (e.g. -mavx2) and fall back to plain loops otherwise.
+
+// dst |= src, return true if dst changed
+inline bool wordsOr(uint64_t *dst, const uint64_t *src, size_t n) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i changed = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        // bits in src that are not in dst
+        changed = _mm256_or_si256(changed, _mm256_andnot_si256(d, s));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                            _mm256_or_si256(d, s));
+    }
+    bool ret = !_mm256_testz_si256(changed, changed);
+#elif defined(__SSE2__)
+    __m128i changed = _mm_setzero_si128();
+    for (; i + 2 <= n; i += 2) {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        changed = _mm_or_si128(changed, _mm_andnot_si128(d, s));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_or_si128(d, s));
+    }
+    bool ret = _mm_movemask_epi8(_mm_cmpeq_epi8(changed, _mm_setzero_si128())) != 0xffff;
+#else
+    bool ret = false;
+#endif
+    for (; i < n; ++i) {
+        ret |= (src[i] & ~dst[i]) != 0;
+        dst[i] |= src[i];
+    }
+
+    return ret;
+}
+
+// dst &= src, return true if dst changed
+inline bool wordsAnd(uint64_t *dst, const uint64_t *src, size_t n) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i changed = _mm256_setzero_si256();
+    for (; i + 4 <= n; i += 4) {
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dst + i));
+        __m256i s = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        // bits in dst that are not in src
+        changed = _mm256_or_si256(changed, _mm256_andnot_si256(s, d));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                            _mm256_and_si256(d, s));
+    }
+    bool ret = !_mm256_testz_si256(changed, changed);
+#elif defined(__SSE2__)
+    __m128i changed = _mm_setzero_si128();
+    for (; i + 2 <= n; i += 2) {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dst + i));
+        __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        changed = _mm_or_si128(changed, _mm_andnot_si128(s, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i),
+                         _mm_and_si128(d, s));
+    }
+    bool ret = _mm_movemask_epi8(_mm_cmpeq_epi8(changed, _mm_setzero_si128())) != 0xffff;
+#else
+    bool ret = false;
+#endif
+    for (; i < n; ++i) {
+        ret |= (dst[i] & ~src[i]) != 0;
+        dst[i] &= src[i];
+    }
+
+    return ret;
+}
+
+// return true if (a & ~b) == 0, i.e. a is a subset of b
+inline bool wordsSubset(const uint64_t *a, const uint64_t *b, size_t n) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= n; i += 4) {
+        __m256i A = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i B = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        // testc returns 1 iff (~B & A) == 0
+        if (!_mm256_testc_si256(B, A))
+            return false;
+    }
+#elif defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128i A = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i B = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        __m128i diff = _mm_andnot_si128(B, A);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(diff, _mm_setzero_si128())) != 0xffff)
+            return false;
+    }
+#endif
+    for (; i < n; ++i) {
+        if (a[i] & ~b[i])
+            return false;
+    }
+
+    return true;
+}
+
+inline size_t wordsCount(const uint64_t *w, size_t n) {
+    size_t num = 0;
+    for (size_t i = 0; i < n; ++i)
+        num += __builtin_popcountll(w[i]);
+    return num;
+}
+
+} // namespace detail
+
+// A set of numbers that changes its representation as it grows.
+// It starts as a small sorted inline array, then it is lifted
+// to a sparse bitvector and once the elements are dense enough
+// (at least one element per DENSITY bits on average),
+// it is lifted to a plain array of words starting at 0.
+// Operations on two dense sets use the SIMD kernels above.
+// A dense set goes back to the sparse representation only
+// if an element far behind the array would make it too sparse.
+template <size_t SMALL_SIZE = 4, size_t DENSITY = 32>
+class HybridBitvectorImpl {
+public:
+    enum class Mode : uint8_t { SMALL, SPARSE, DENSE };
+
+private:
+    using SparseT = SparseBitvector;
+    using DenseT = std::vector<uint64_t>;
+
+    Mode _mode{Mode::SMALL};
+    uint8_t _smallSize{0};
+    // the greatest element in the set
+    uint64_t _max{0};
+    // number of elements in the dense array
+    size_t _denseSize{0};
+
+    uint64_t _small[SMALL_SIZE]{};
+    SparseT _sparse;
+    DenseT _dense;
+
+    static size_t _word(uint64_t i) { return i / 64; }
+    static uint64_t _bit(uint64_t i) { return static_cast<uint64_t>(1) << (i % 64); }
+
+    bool _shouldBeDense(size_t size, uint64_t max) const {
+        return size * DENSITY > max;
+    }
+
+    void _toSparse() {
+        assert(_mode == Mode::SMALL);
+        for (unsigned i = 0; i < _smallSize; ++i)
+            _sparse.set(_small[i]);
+        _smallSize = 0;
+        _mode = Mode::SPARSE;
+    }
+
+    void _toDense() {
+        assert(_mode != Mode::DENSE);
+        // make sure the array is large enough
+        // for the elements that are to be added later
+        _dense.assign(_word(_max) + 1, 0);
+        _denseSize = 0;
+        if (_mode == Mode::SMALL) {
+            for (unsigned i = 0; i < _smallSize; ++i)
+                _denseSet(_small[i]);
+            _smallSize = 0;
+        } else {
+            for (auto x : _sparse)
+                _denseSet(x);
+            _sparse.reset();
+        }
+        _mode = Mode::DENSE;
+    }
+
+    void _denseToSparse() {
+        assert(_mode == Mode::DENSE);
+        for (size_t w = 0; w < _dense.size(); ++w) {
+            uint64_t bits = _dense[w];
+            while (bits) {
+                _sparse.set(w * 64 + __builtin_ctzll(bits));
+                bits &= bits - 1;
+            }
+        }
+        _dense.clear();
+        _denseSize = 0;
+        _mode = Mode::SPARSE;
+    }
+
+    void _maybeToDense() {
+        if (_mode == Mode::SPARSE && _shouldBeDense(_sparse.size(), _max))
+            _toDense();
+    }
+
+    bool _denseGet(uint64_t i) const {
+        auto w = _word(i);
+        return w < _dense.size() && (_dense[w] & _bit(i));
+    }
+
+    bool _denseSet(uint64_t i) {
+        auto w = _word(i);
+        if (w >= _dense.size())
+            _dense.resize(w + 1, 0);
+        if (_dense[w] & _bit(i))
+            return true;
+        _dense[w] |= _bit(i);
+        ++_denseSize;
+        return false;
+    }
+
+    bool _smallSet(uint64_t i) {
+        auto end = _small + _smallSize;
+        auto it = std::lower_bound(_small, end, i);
+        if (it != end && *it == i)
+            return true;
+
+        if (_smallSize == SMALL_SIZE) {
+            _toSparse();
+            return _sparse.set(i);
+        }
+
+        std::copy_backward(it, end, end + 1);
+        *it = i;
+        ++_smallSize;
+        return false;
+    }
+
+    void _denseUnion(const HybridBitvectorImpl& rhs) {
+        assert(_mode == Mode::DENSE && rhs._mode == Mode::DENSE);
+        if (_dense.size() < rhs._dense.size())
+            _dense.resize(rhs._dense.size(), 0);
+        if (detail::wordsOr(_dense.data(), rhs._dense.data(), rhs._dense.size()))
+            _denseSize = detail::wordsCount(_dense.data(), _dense.size());
+    }
+
+public:
+    HybridBitvectorImpl() = default;
+    HybridBitvectorImpl(uint64_t i) { set(i); } // singleton ctor
+
+    HybridBitvectorImpl(const HybridBitvectorImpl&) = default;
+    HybridBitvectorImpl(HybridBitvectorImpl&&) = default;
+    HybridBitvectorImpl& operator=(const HybridBitvectorImpl&) = default;
+    HybridBitvectorImpl& operator=(HybridBitvectorImpl&&) = default;
+
+    Mode getMode() const { return _mode; }
+
+    void reset() {
+        _mode = Mode::SMALL;
+        _smallSize = 0;
+        _max = 0;
+        _denseSize = 0;
+        _sparse.reset();
+        _dense.clear();
+    }
+
+    size_t size() const {
+        switch (_mode) {
+            case Mode::SMALL: return _smallSize;
+            case Mode::SPARSE: return _sparse.size();
+            case Mode::DENSE: return _denseSize;
+        }
+        return 0;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    void swap(HybridBitvectorImpl& oth) { std::swap(*this, oth); }
+
+    bool get(uint64_t i) const {
+        switch (_mode) {
+            case Mode::SMALL:
+                return std::binary_search(_small, _small + _smallSize, i);
+            case Mode::SPARSE:
+                return _sparse.get(i);
+            case Mode::DENSE:
+                return _denseGet(i);
+        }
+        return false;
+    }
+
+    // returns the previous value of the i-th bit
+    bool set(uint64_t i) {
+        if (empty() || i > _max)
+            _max = i;
+
+        switch (_mode) {
+            case Mode::SMALL:
+                if (_smallSet(i))
+                    return true;
+                _maybeToDense();
+                return false;
+            case Mode::SPARSE:
+                if (_sparse.set(i))
+                    return true;
+                _maybeToDense();
+                return false;
+            case Mode::DENSE:
+                if (_word(i) >= _dense.size() &&
+                    !_shouldBeDense(_denseSize + 1, i)) {
+                    _denseToSparse();
+                    return _sparse.set(i);
+                }
+                return _denseSet(i);
+        }
+        return false;
+    }
+
+    // returns the previous value of the i-th bit
+    bool unset(uint64_t i) {
+        switch (_mode) {
+            case Mode::SMALL: {
+                auto end = _small + _smallSize;
+                auto it = std::lower_bound(_small, end, i);
+                if (it == end || *it != i)
+                    return false;
+                std::copy(it + 1, end, it);
+                --_smallSize;
+                return true;
+            }
+            case Mode::SPARSE:
+                return _sparse.unset(i);
+            case Mode::DENSE:
+                if (!_denseGet(i))
+                    return false;
+                _dense[_word(i)] &= ~_bit(i);
+                --_denseSize;
+                return true;
+        }
+        return false;
+    }
+
+    // union operation, returns true if this set changed
+    bool set(const HybridBitvectorImpl& rhs) {
+        if (rhs.empty() || &rhs == this)
+            return false;
+
+        auto oldsize = size();
+        if (empty() || rhs._max > _max)
+            _max = rhs._max;
+
+        if (_mode == Mode::DENSE && rhs._mode == Mode::DENSE) {
+            _denseUnion(rhs);
+        } else if (rhs._mode == Mode::DENSE &&
+                   _shouldBeDense(oldsize + rhs.size(), _max)) {
+            // lift this set to the dense representation
+            // and do the union on words
+            _toDense();
+            _denseUnion(rhs);
+        } else if (_mode == Mode::SPARSE && rhs._mode == Mode::SPARSE) {
+            _sparse.set(rhs._sparse);
+            _maybeToDense();
+        } else if (_mode == Mode::SMALL && rhs._mode == Mode::SPARSE) {
+            // copy the sparse bitvector and add our elements
+            SparseT tmp(rhs._sparse);
+            for (unsigned i = 0; i < _smallSize; ++i)
+                tmp.set(_small[i]);
+            _sparse.swap(tmp);
+            _smallSize = 0;
+            _mode = Mode::SPARSE;
+            _maybeToDense();
+        } else {
+            for (auto x : rhs)
+                set(x);
+        }
+
+        return size() != oldsize;
+    }
+
+    // intersection, returns true if this set changed
+    bool intersect(const HybridBitvectorImpl& rhs) {
+        if (empty())
+            return false;
+
+        if (_mode == Mode::DENSE && rhs._mode == Mode::DENSE) {
+            bool changed;
+            if (_dense.size() > rhs._dense.size()) {
+                // the words that are not in rhs are cleared
+                for (size_t i = rhs._dense.size(); i < _dense.size(); ++i)
+                    _dense[i] = 0;
+            }
+            changed = detail::wordsAnd(_dense.data(), rhs._dense.data(),
+                                       std::min(_dense.size(), rhs._dense.size()));
+            auto oldsize = _denseSize;
+            _denseSize = detail::wordsCount(_dense.data(), _dense.size());
+            return changed || oldsize != _denseSize;
+        }
+
+        std::vector<uint64_t> toRemove;
+        for (auto x : *this) {
+            if (!rhs.get(x))
+                toRemove.push_back(x);
+        }
+
+        for (auto x : toRemove)
+            unset(x);
+
+        return !toRemove.empty();
+    }
+
+    // is this set a subset of rhs?
+    bool isSubsetOf(const HybridBitvectorImpl& rhs) const {
+        if (size() > rhs.size())
+            return false;
+
+        if (_mode == Mode::DENSE && rhs._mode == Mode::DENSE) {
+            auto n = std::min(_dense.size(), rhs._dense.size());
+            for (size_t i = n; i < _dense.size(); ++i) {
+                if (_dense[i] != 0)
+                    return false;
+            }
+            return detail::wordsSubset(_dense.data(), rhs._dense.data(), n);
+        }
+
+        for (auto x : *this) {
+            if (!rhs.get(x))
+                return false;
+        }
+
+        return true;
+    }
+
+    class const_iterator {
+        const HybridBitvectorImpl *_bv{nullptr};
+        // position in the small array or in the dense array
+        size_t _pos{0};
+        typename SparseT::const_iterator _sparse_it;
+
+        // find the first set bit in the dense array on position >= _pos
+        void _findDense() {
+            const auto& D = _bv->_dense;
+            auto w = _pos / 64;
+            if (w >= D.size()) {
+                _pos = D.size() * 64;
+                return;
+            }
+
+            uint64_t rest = D[w] & (~static_cast<uint64_t>(0) << (_pos % 64));
+            while (rest == 0) {
+                if (++w == D.size()) {
+                    _pos = D.size() * 64;
+                    return;
+                }
+                rest = D[w];
+            }
+
+            _pos = w * 64 + __builtin_ctzll(rest);
+        }
+
+        const_iterator(const HybridBitvectorImpl *bv, bool end = false)
+        : _bv(bv) {
+            switch (bv->_mode) {
+                case Mode::SMALL:
+                    _pos = end ? bv->_smallSize : 0;
+                    break;
+                case Mode::SPARSE:
+                    _sparse_it = end ? bv->_sparse.end() : bv->_sparse.begin();
+                    break;
+                case Mode::DENSE:
+                    _pos = end ? bv->_dense.size() * 64 : 0;
+                    if (!end)
+                        _findDense();
+                    break;
+            }
+        }
+
+    public:
+        const_iterator() = default;
+
+        const_iterator& operator++() {
+            switch (_bv->_mode) {
+                case Mode::SMALL:
+                    ++_pos;
+                    break;
+                case Mode::SPARSE:
+                    ++_sparse_it;
+                    break;
+                case Mode::DENSE:
+                    ++_pos;
+                    _findDense();
+                    break;
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        uint64_t operator*() const {
+            switch (_bv->_mode) {
+                case Mode::SMALL:
+                    return _bv->_small[_pos];
+                case Mode::SPARSE:
+                    return *_sparse_it;
+                case Mode::DENSE:
+                    return _pos;
+            }
+            abort();
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            if (_bv->_mode == Mode::SPARSE)
+                return _sparse_it == rhs._sparse_it;
+            return _pos == rhs._pos;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class HybridBitvectorImpl;
+    };
+
+    const_iterator begin() const { return const_iterator(this); }
+    const_iterator end() const { return const_iterator(this, true /* end */); }
+
+    friend class const_iterator;
+};
+
+using HybridBitvector = HybridBitvectorImpl<>;
+
+} // namespace ADT
+} // namespace dg
+
+#endif // _DG_HYBRID_BITVECTOR_H_
@@ -3,33 +3,148 @@
 
 #include "Bits.h"
 #include "Bitvector.h"
+#include "CompressedBitmap.h"
 
 namespace dg {
 namespace ADT {
 
-// this is just a wrapper around sparse bitvector
+// This is a wrapper around sparse bitvector
 // that translates the bitvector methods to a new methods.
+// When the set grows big, it is moved into a compressed
+// bitmap that stores dense chunks and ranges of numbers
+// more compactly.
 // There is no possibility to remove elements from the set.
 class BitvectorNumberSet {
     using NumT = uint64_t;
     using ContainerT = SparseBitvectorImpl<uint64_t, NumT>;
+    using CompressedT = CompressedBitmap;
 
+    // the number of elements at which the set
+    // is moved into the compressed bitmap
+    enum : size_t { COMPRESS_SIZE = 4096 };
+
+    bool _is_compressed{false};
     ContainerT _bitvector;
-public:
-    using const_iterator = typename ContainerT::const_iterator;
+    CompressedT _compressed;
+
+    void _compress() {
+        assert(!_is_compressed);
+
+        for (auto x : _bitvector)
+            _compressed.set(x);
+        _compressed.optimize();
+        ContainerT().swap(_bitvector);
 
+        _is_compressed = true;
+    }
+
+public:
     BitvectorNumberSet() = default;
     BitvectorNumberSet(size_t n) :_bitvector(n) {};
     BitvectorNumberSet(BitvectorNumberSet&&) = default;
 
-    bool add(NumT n) { return !_bitvector.set(n); }
-    bool has(NumT n) const { return _bitvector.get(n); }
-    bool empty() const { return _bitvector.empty(); }
-    size_t size() const { return _bitvector.size(); }
-    void swap(BitvectorNumberSet& oth) { oth._bitvector.swap(_bitvector); }
+    bool add(NumT n) {
+        if (_is_compressed)
+            return !_compressed.set(n);
+
+        if (_bitvector.set(n))
+            return false;
+        if (_bitvector.size() > COMPRESS_SIZE)
+            _compress();
+        return true;
+    }
+
+    // union, returns true if the set changed
+    bool add(const BitvectorNumberSet& rhs) {
+        if (!_is_compressed && !rhs._is_compressed) {
+            bool changed = _bitvector.set(rhs._bitvector);
+            if (_bitvector.size() > COMPRESS_SIZE)
+                _compress();
+            return changed;
+        }
 
-    const_iterator begin() const { return _bitvector.begin(); }
-    const_iterator end() const { return _bitvector.end(); }
+        if (!_is_compressed)
+            _compress();
+
+        if (rhs._is_compressed)
+            return _compressed.set(rhs._compressed);
+
+        bool changed = false;
+        for (auto x : rhs._bitvector)
+            changed |= !_compressed.set(x);
+        return changed;
+    }
+
+    bool has(NumT n) const {
+        return _is_compressed ? _compressed.get(n) : _bitvector.get(n);
+    }
+
+    bool empty() const {
+        return _is_compressed ? _compressed.empty() : _bitvector.empty();
+    }
+
+    size_t size() const {
+        return _is_compressed ? _compressed.size() : _bitvector.size();
+    }
+
+    bool isCompressed() const { return _is_compressed; }
+
+    void swap(BitvectorNumberSet& oth) {
+        std::swap(_is_compressed, oth._is_compressed);
+        oth._bitvector.swap(_bitvector);
+        oth._compressed.swap(_compressed);
+    }
+
+    class const_iterator {
+        bool is_compressed;
+        ContainerT::const_iterator bitvector_it;
+        CompressedT::const_iterator compressed_it;
+
+    public:
+        const_iterator(const BitvectorNumberSet& S, bool end = false)
+        : is_compressed(S._is_compressed) {
+            if (is_compressed)
+                compressed_it = end ? S._compressed.end() : S._compressed.begin();
+            else
+                bitvector_it = end ? S._bitvector.end() : S._bitvector.begin();
+        }
+
+        const_iterator& operator++() {
+            if (is_compressed)
+                ++compressed_it;
+            else
+                ++bitvector_it;
+
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        NumT operator*() const {
+            return is_compressed ? *compressed_it : *bitvector_it;
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            if (is_compressed != rhs.is_compressed)
+                return false;
+
+            return is_compressed ? compressed_it == rhs.compressed_it
+                                 : bitvector_it == rhs.bitvector_it;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+    };
+
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
+
+    friend class const_iterator;
 };
 
 
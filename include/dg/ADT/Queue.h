@@ -3,7 +3,15 @@
 
 #include <stack>
 #include <queue>
+#include <algorithm>
+#include <deque>
 #include <set>
+#include <vector>
+#include <mutex>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <utility>
 
 namespace dg {
 namespace ADT {
@@ -126,6 +134,267 @@ private:
     ContainerT Container;
 };
 
+// get the ID of an element that is a pointer to a node
+template <typename ValueT>
+struct GetNodeID
+{
+    size_t operator()(const ValueT& v) const { return v->getID(); }
+};
+
+///
+// Worklist for fixpoint computations. Every element has a dense
+// integer priority (e.g. the reverse postorder number or the
+// topological index of its SCC) and pop() returns an element with
+// the lowest priority. Elements with the same priority are
+// returned in LIFO order.
+// An element is in the worklist at most once -- the worklist
+// keeps an "already queued" bit for every element, indexed by
+// the dense ID that GetID returns for the element.
+//
+// The elements are stored in buckets indexed by priority and
+// non-empty buckets are tracked by a two-level bitmap, so push
+// and pop are O(1) (up to scanning the summary bitmap, which has
+// one bit for 4096 priorities).
+template <typename ValueT, typename GetID = GetNodeID<ValueT>>
+class PriorityWorklist
+{
+    std::vector<std::vector<ValueT>> _buckets;
+    // bit p is set iff the bucket p is not empty
+    std::vector<uint64_t> _nonempty;
+    // bit w is set iff the word _nonempty[w] is not zero
+    std::vector<uint64_t> _summary;
+    std::vector<bool> _queued;
+    size_t _size{0};
+    GetID _getID;
+
+    static uint64_t _bit(size_t i) { return static_cast<uint64_t>(1) << (i % 64); }
+
+    void _markNonempty(size_t prio)
+    {
+        if (prio / 64 >= _nonempty.size())
+            _nonempty.resize(prio / 64 + 1, 0);
+        if (prio / 4096 >= _summary.size())
+            _summary.resize(prio / 4096 + 1, 0);
+
+        _nonempty[prio / 64] |= _bit(prio);
+        _summary[prio / 4096] |= _bit(prio / 64);
+    }
+
+    void _markEmpty(size_t prio)
+    {
+        _nonempty[prio / 64] &= ~_bit(prio);
+        if (_nonempty[prio / 64] == 0)
+            _summary[prio / 4096] &= ~_bit(prio / 64);
+    }
+
+    size_t _lowestPriority() const
+    {
+        for (size_t s = 0; s < _summary.size(); ++s) {
+            if (_summary[s] == 0)
+                continue;
+            size_t w = s * 64 + __builtin_ctzll(_summary[s]);
+            return w * 64 + __builtin_ctzll(_nonempty[w]);
+        }
+
+        assert(false && "Worklist is empty");
+        abort();
+    }
+
+public:
+    PriorityWorklist(GetID getID = GetID()) : _getID(std::move(getID)) {}
+
+    // returns false if the element is already queued
+    bool push(const ValueT& what, size_t priority)
+    {
+        size_t id = _getID(what);
+        if (id >= _queued.size())
+            _queued.resize(id + 1, false);
+        else if (_queued[id])
+            return false;
+
+        _queued[id] = true;
+        if (priority >= _buckets.size())
+            _buckets.resize(priority + 1);
+        _buckets[priority].push_back(what);
+        _markNonempty(priority);
+        ++_size;
+        return true;
+    }
+
+    ValueT pop()
+    {
+        size_t prio = _lowestPriority();
+        auto& bucket = _buckets[prio];
+        ValueT ret = bucket.back();
+        bucket.pop_back();
+        if (bucket.empty())
+            _markEmpty(prio);
+
+        _queued[_getID(ret)] = false;
+        --_size;
+        return ret;
+    }
+
+    bool isQueued(const ValueT& what) const
+    {
+        size_t id = _getID(what);
+        return id < _queued.size() && _queued[id];
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    void clear()
+    {
+        _buckets.clear();
+        _nonempty.clear();
+        _summary.clear();
+        _queued.clear();
+        _size = 0;
+    }
+};
+
+///
+// Worklist for fixpoint computations where the priorities are not dense
+// (e.g. labels of an order that changes during the computation).
+// pop() returns an element with the lowest priority, elements with
+// the same priority are returned in LIFO order. As in PriorityWorklist,
+// an element is in the worklist at most once.
+//
+// The elements are kept in a binary heap, so push and pop are O(log n)
+// in the number of queued elements.
+template <typename ValueT, typename GetID = GetNodeID<ValueT>>
+class SparsePriorityWorklist
+{
+    struct Entry {
+        uint64_t priority;
+        // the order of pushes, for LIFO order of equal priorities
+        size_t seq;
+        ValueT value;
+
+        // is the entry popped after 'rhs'?
+        bool operator<(const Entry& rhs) const {
+            if (priority != rhs.priority)
+                return priority > rhs.priority;
+            return seq < rhs.seq;
+        }
+    };
+
+    std::vector<Entry> _heap;
+    std::vector<bool> _queued;
+    size_t _seq{0};
+    GetID _getID;
+
+public:
+    SparsePriorityWorklist(GetID getID = GetID()) : _getID(std::move(getID)) {}
+
+    // returns false if the element is already queued
+    bool push(const ValueT& what, uint64_t priority)
+    {
+        size_t id = _getID(what);
+        if (id >= _queued.size())
+            _queued.resize(id + 1, false);
+        else if (_queued[id])
+            return false;
+
+        _queued[id] = true;
+        _heap.push_back({priority, _seq++, what});
+        std::push_heap(_heap.begin(), _heap.end());
+        return true;
+    }
+
+    ValueT pop()
+    {
+        assert(!_heap.empty() && "Worklist is empty");
+        std::pop_heap(_heap.begin(), _heap.end());
+        ValueT ret = _heap.back().value;
+        _heap.pop_back();
+
+        _queued[_getID(ret)] = false;
+        return ret;
+    }
+
+    bool isQueued(const ValueT& what) const
+    {
+        size_t id = _getID(what);
+        return id < _queued.size() && _queued[id];
+    }
+
+    bool empty() const
+    {
+        return _heap.empty();
+    }
+
+    size_t size() const
+    {
+        return _heap.size();
+    }
+
+    void clear()
+    {
+        _heap.clear();
+        _queued.clear();
+    }
+};
+
+///
+// Double-ended queue of a worker thread in a parallel computation.
+// The owner pushes and pops the elements at the back (LIFO, so it works
+// on the data that it has just touched), other workers that ran out of
+// work steal the elements from the front (the oldest elements).
+// All operations take the lock of the queue, the queue is meant
+// for elements whose processing is much more expensive than locking.
+template <typename ValueT>
+class WorkStealingQueue
+{
+    std::deque<ValueT> Container;
+    mutable std::mutex Lock;
+
+public:
+    void push(const ValueT& what)
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        Container.push_back(what);
+    }
+
+    // pop an element from the back, returns false if the queue is empty
+    bool pop(ValueT& ret)
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        if (Container.empty())
+            return false;
+
+        ret = Container.back();
+        Container.pop_back();
+        return true;
+    }
+
+    // steal an element from the front, returns false if the queue is empty
+    bool steal(ValueT& ret)
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        if (Container.empty())
+            return false;
+
+        ret = Container.front();
+        Container.pop_front();
+        return true;
+    }
+
+    bool empty() const
+    {
+        std::lock_guard<std::mutex> guard(Lock);
+        return Container.empty();
+    }
+};
+
 } // namespace ADT
 } // namespace dg
 
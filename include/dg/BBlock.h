@@ -7,6 +7,7 @@
 #include <cassert>
 #include <list>
 
+#include "ADT/Arena.h"
 #include "ADT/DGContainer.h"
 #include "analysis/legacy/Analysis.h"
 
@@ -17,7 +18,7 @@ namespace dg {
 //     Basic block structure for dependence graph
 /// ------------------------------------------------------------------
 template <typename NodeT>
-class BBlock
+class BBlock : public ADT::ArenaAllocated
 {
 public:
     using KeyT = typename NodeT::KeyType;
@@ -149,9 +150,9 @@ public:
             // and create new edges to all successors. The new edges
             // will have the same label as the found one
             DGContainer<BBlockEdge> new_edges;
-            for (auto I = pred->nextBBs.begin(),E = pred->nextBBs.end(); I != E;) {
-                auto cur = I++;
-                if (cur->target == this) {
+            DGContainer<BBlockEdge> old_edges;
+            for (const BBlockEdge& cur : pred->nextBBs) {
+                if (cur.target == this) {
                     // create edges that will go from the predecessor
                     // to every successor of this node
                     for (const BBlockEdge& succ : nextBBs) {
@@ -159,14 +160,18 @@ public:
                         // that would be incorrect. It can occur when we're isolatin a bblock
                         // with self-loop
                         if (succ.target != this)
-                            new_edges.insert(BBlockEdge(succ.target, cur->label));
+                            new_edges.insert(BBlockEdge(succ.target, cur.label));
                     }
 
-                    // remove the edge from predecessor
-                    pred->nextBBs.erase(*cur);
+                    old_edges.insert(cur);
                 }
             }
 
+            // remove the edges from predecessor (not while iterating
+            // over them, erasing invalidates the iterators)
+            for (const BBlockEdge& edge : old_edges)
+                pred->nextBBs.erase(edge);
+
             // add newly created edges to predecessor
             for (const BBlockEdge& edge : new_edges) {
                 assert(edge.target != this
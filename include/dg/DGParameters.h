@@ -4,14 +4,16 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <functional>
 
+#include "ADT/Arena.h"
 #include "BBlock.h"
 
 namespace dg {
 
 
 template <typename NodeT>
-struct DGParameterPair
+struct DGParameterPair : public ADT::ArenaAllocated
 {
     DGParameterPair<NodeT>(NodeT *v1, NodeT *v2)
         : in(v1), out(v2) {}
@@ -50,11 +52,15 @@ struct DGParameterPair
 //  so that the parameters can be used in BBlock analysis
 // --------------------------------------------------------
 template <typename NodeT>
-class DGParameters
+class DGParameters : public ADT::ArenaAllocated
 {
 public:
     using KeyT = typename NodeT::KeyType;
-    using ContainerType = std::map<KeyT, DGParameterPair<NodeT>>;
+    // the pairs are allocated in the same arena as the parameters
+    using ContainerType
+        = std::map<KeyT, DGParameterPair<NodeT>, std::less<KeyT>,
+                   ADT::ArenaAllocator<std::pair<const KeyT,
+                                                 DGParameterPair<NodeT>>>>;
     using iterator = typename ContainerType::iterator;
     using const_iterator = typename ContainerType::const_iterator;
 
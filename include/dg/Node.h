@@ -118,18 +118,14 @@ public:
     // remove all control dependencies going from/to this node
     void removeOutcomingCDs()
     {
-        while (!controlDepEdges.empty())
-            removeControlDependence(*controlDepEdges.begin());
+        _removeBidirectionalEdges(static_cast<NodeT *>(this), controlDepEdges,
+                                  &Node::revControlDepEdges);
     }
 
     void removeIncomingCDs()
     {
-        while (!revControlDepEdges.empty()) {
-            NodeT *cd = *revControlDepEdges.begin();
-            // this will remove the reverse control dependence from
-            // this node
-            cd->removeControlDependence(static_cast<NodeT *>(this));
-        }
+        _removeBidirectionalEdges(static_cast<NodeT *>(this), revControlDepEdges,
+                                  &Node::controlDepEdges);
     }
 
     void removeCDs()
@@ -140,18 +136,14 @@ public:
 
     void removeOutcomingDDs()
     {
-        while (!dataDepEdges.empty())
-            removeDataDependence(*dataDepEdges.begin());
+        _removeBidirectionalEdges(static_cast<NodeT *>(this), dataDepEdges,
+                                  &Node::revDataDepEdges);
     }
 
     void removeIncomingDDs()
     {
-        while (!revDataDepEdges.empty()) {
-            NodeT *cd = *revDataDepEdges.begin();
-            // this will remove the reverse control dependence from
-            // this node
-            cd->removeDataDependence(static_cast<NodeT *>(this));
-        }
+        _removeBidirectionalEdges(static_cast<NodeT *>(this), revDataDepEdges,
+                                  &Node::dataDepEdges);
     }
 
     // remove all data dependencies going from/to this node
@@ -163,18 +155,14 @@ public:
 
     void removeOutcomingUses()
     {
-        while (!useEdges.empty())
-            removeUseDependence(*useEdges.begin());
+        _removeBidirectionalEdges(static_cast<NodeT *>(this), useEdges,
+                                  &Node::userEdges);
     }
 
     void removeIncomingUses()
     {
-        while (!userEdges.empty()) {
-            NodeT *cd = *userEdges.begin();
-            // this will remove the reverse control dependence from
-            // this node
-            cd->removeUseDependence(static_cast<NodeT *>(this));
-        }
+        _removeBidirectionalEdges(static_cast<NodeT *>(this), userEdges,
+                                  &Node::useEdges);
     }
 
     // remove all direct (top-level) data dependencies going from/to this node
@@ -398,6 +386,23 @@ private:
         return ret1;
     }
 
+    // remove all edges from 'ths_cont' and their reverse edges
+    // (in the container 'rev' of the other nodes). The edges
+    // are walked once and then cleared at once, removing them
+    // one by one would shift the rest of the sorted edges every time
+    static void _removeBidirectionalEdges(NodeT *ths, EdgesT& ths_cont,
+                                          EdgesT Node::*rev) {
+        for (NodeT *n : ths_cont) {
+#ifndef NDEBUG
+            bool ret =
+#endif
+            (n->*rev).erase(ths);
+            assert(ret && "An edge without rev. or vice versa");
+        }
+
+        ths_cont.clear();
+    }
+
     ControlEdgesT controlDepEdges;
     DataEdgesT dataDepEdges;
     UseEdgesT useEdges;
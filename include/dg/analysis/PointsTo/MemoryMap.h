@@ -0,0 +1,106 @@
+#ifndef _DG_MEMORY_MAP_H_
+#define _DG_MEMORY_MAP_H_
+
+#include <map>
+#include <set>
+#include <memory>
+
+#include "MemoryObject.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// The memory of the flow-sensitive analysis at some point:
+// the mapping from targets to memory objects.
+//
+// The memory objects are shared between the memory maps
+// (a merge of a map copies only the pointers to the objects)
+// and an object is copied when a map that shares it
+// is going to change it (copy-on-write).
+//
+// The map also keeps, for every map that it is merged into,
+// the targets whose objects changed since the last merge,
+// so that the merge does not need to go over all the objects.
+class MemoryMap
+{
+public:
+    using MemoryObjectPtr = std::shared_ptr<MemoryObject>;
+    using MapT = std::map<PSNode *, MemoryObjectPtr>;
+    using const_iterator = MapT::const_iterator;
+    using ChangesT = std::set<PSNode *>;
+
+private:
+    struct Successor {
+        // the targets whose objects changed since the last merge
+        ChangesT changes;
+        // did the last merge skip some pointers (strong update)?
+        bool filtered{false};
+    };
+
+    MapT objects;
+    std::map<const MemoryMap *, Successor> successors;
+
+public:
+    const_iterator begin() const { return objects.begin(); }
+    const_iterator end() const { return objects.end(); }
+    const_iterator find(PSNode *target) const { return objects.find(target); }
+    size_t size() const { return objects.size(); }
+    bool empty() const { return objects.empty(); }
+
+    // the (possibly shared) object of the target, the changes
+    // of the entry must be announced via setChanged()
+    MemoryObjectPtr& operator[](PSNode *target) { return objects[target]; }
+
+    // get the object that can be changed without changing
+    // other memory maps (create it if there is none yet)
+    MemoryObject *getWritable(PSNode *target) {
+        return getWritable(objects[target], target);
+    }
+
+    static MemoryObject *getWritable(MemoryObjectPtr& mo, PSNode *target) {
+        if (!mo)
+            mo.reset(new MemoryObject(target));
+        else if (mo.use_count() > 1)
+            mo.reset(new MemoryObject(*mo));
+
+        return mo.get();
+    }
+
+    // the object of the target changed (or may have changed),
+    // the maps that merge this map must merge it again
+    void setChanged(PSNode *target) {
+        for (auto& it : successors)
+            it.second.changes.insert(target);
+    }
+
+    // Get the targets whose objects changed since the last merge
+    // of this map into the map 'to'. The caller clears the returned set
+    // once it merged the objects. Return nullptr if all the objects
+    // must be merged -- on the first merge into 'to' and when the last
+    // merge skipped some pointers ('filtered'), but this one does not.
+    ChangesT *getChanges(const MemoryMap *to, bool filtered) {
+        auto it = successors.find(to);
+        if (it == successors.end()) {
+            successors[to].filtered = filtered;
+            return nullptr;
+        }
+
+        Successor& succ = it->second;
+        bool all = succ.filtered && !filtered;
+        succ.filtered = filtered;
+        if (all) {
+            succ.changes.clear();
+            return nullptr;
+        }
+
+        return &succ.changes;
+    }
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_MEMORY_MAP_H_
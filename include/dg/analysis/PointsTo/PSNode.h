@@ -4,6 +4,7 @@
 #include <cassert>
 #include <cstdarg>
 #include <string>
+#include <vector>
 #include <iostream>
 
 #ifndef NDEBUG
@@ -118,6 +119,37 @@ class PointerSubgraph;
 
 class PSNode : public SubgraphNode<PSNode>
 {
+public:
+    ///
+    // Record the nodes whose points-to set changed in the current
+    // thread for the lifetime of this object. The solver uses it
+    // to find the nodes that were changed as a side effect
+    // of processing another node (e.g. by the hooks of the analysis).
+    class ChangesLog {
+        friend class PSNode;
+
+        std::vector<PSNode *> nodes;
+        ChangesLog *_prev;
+
+        static ChangesLog *& active() {
+            static thread_local ChangesLog *log = nullptr;
+            return log;
+        }
+
+    public:
+        ChangesLog() : _prev(active()) { active() = this; }
+        ~ChangesLog() { active() = _prev; }
+
+        ChangesLog(const ChangesLog&) = delete;
+        ChangesLog& operator=(const ChangesLog&) = delete;
+
+        // the nodes in the order of changes, a node can be
+        // in the log several times
+        const std::vector<PSNode *>& getNodes() const { return nodes; }
+        void clear() { nodes.clear(); }
+    };
+
+private:
     PSNodeType type;
 
     // in some cases some nodes are kind of paired - like formal and actual
@@ -134,6 +166,15 @@ class PSNode : public SubgraphNode<PSNode>
 
     unsigned int dfsid = 0;
 
+    bool bump(bool changed) {
+        if (changed) {
+            ++pointsToVersion;
+            if (auto *log = ChangesLog::active())
+                log->nodes.push_back(this);
+        }
+        return changed;
+    }
+
 protected:
     ///
     // Construct a PSNode
@@ -310,11 +351,16 @@ public:
     // reason the PointerSubgraph node exists, so don't hide it
     PointsToSetT pointsTo;
 
+    // incremented on every change of pointsTo (through addPointsTo),
+    // so that the users can find out whether the set changed
+    // since they have seen it the last time
+    unsigned pointsToVersion{0};
+
     // convenient helper
-    bool addPointsTo(PSNode *n, Offset o) { return pointsTo.add(Pointer(n, o)); }
-    bool addPointsTo(const Pointer& ptr) { return pointsTo.add(ptr); }
-    bool addPointsTo(const PointsToSetT& ptrs) { return pointsTo.add(ptrs); }
-    bool addPointsTo(std::initializer_list<Pointer> ptrs) { return pointsTo.add(ptrs); }
+    bool addPointsTo(PSNode *n, Offset o) { return bump(pointsTo.add(Pointer(n, o))); }
+    bool addPointsTo(const Pointer& ptr) { return bump(pointsTo.add(ptr)); }
+    bool addPointsTo(const PointsToSetT& ptrs) { return bump(pointsTo.add(ptrs)); }
+    bool addPointsTo(std::initializer_list<Pointer> ptrs) { return bump(pointsTo.add(ptrs)); }
 
     bool doesPointsTo(const Pointer& p)
     {
@@ -2,7 +2,12 @@
 #define _DG_POINTER_ANALYSIS_H_
 
 #include <cassert>
+#include <cstdint>
 #include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
 
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/PointsTo/MemoryObject.h"
@@ -21,24 +26,143 @@ extern PSNode *UNKNOWN_MEMORY;
 extern const Pointer NullPointer;
 extern const Pointer UnknownPointer;
 
+// Return true if it makes sense to dereference this pointer.
+// PTA is over-approximation, so this is a filter.
+static inline bool canBeDereferenced(const Pointer& ptr)
+{
+    if (!ptr.isValid() || ptr.isInvalidated() || ptr.isUnknown())
+        return false;
+
+    // if the pointer points to a function, we can not dereference it
+    if (ptr.target->getType() == PSNodeType::FUNCTION)
+        return false;
+
+    return true;
+}
+
 class PointerAnalysis
 {
+public:
+    struct Statistics {
+        // the number of iterations over the (changed part of)
+        // the PointerSubgraph. With the worklist, an iteration
+        // ends when the worklist returns to an earlier node.
+        size_t iterations{0};
+        // the number of calls of processNode()
+        size_t processedNodes{0};
+        // the number of nodes in collapsed cycles
+        size_t collapsedNodes{0};
+    };
+
+private:
     // the pointer state subgraph
     PointerSubgraph *PS{nullptr};
     const PointerAnalysisOptions options{};
 
     // strongly connected components of the PointerSubgraph
-    std::vector<std::vector<PSNode *> > SCCs;
+    // (indexed by the scc_id of nodes). The components that were
+    // merged into other components by updateSCCs() are empty.
+    SCCComponents<PSNode> SCCs;
     unsigned sccs_index{0};
+    // the position of a component (indexed by id) in the topological
+    // order of the components and the ids of the components in this order.
+    // The positions are sparse labels, so that new components can be put
+    // between the others without renumbering all of them (insertSCCs()).
+    std::vector<unsigned> scc_pos;
+    std::map<unsigned, unsigned> scc_order;
+    // marks of components used by updateSCCs() (indexed by id)
+    std::vector<unsigned char> scc_marks;
+
+    // The inputs of a node that it has already processed:
+    // the versions of the points-to sets of its operands
+    // and the version of the memory. Inputs that did not change
+    // since the last processing are not merged again.
+    struct SeenInputs {
+        std::vector<std::pair<const PSNode *, unsigned>> operands;
+        unsigned memory{0};
+        bool memorySeen{false};
+    };
+
+    // indexed by the IDs of nodes
+    std::vector<SeenInputs> seen_inputs;
+    // incremented whenever processing a node changes the memory
+    unsigned memory_version{0};
+    // the memory objects changed by the processed node, gathered
+    // only by the worklist fixpoint when the memory is shared
+    // by the whole program (to find the nodes that read them)
+    std::vector<MemoryObject *> changed_objects;
+    bool record_changed_objects{false};
+
+    // Collapsed cycles of copy nodes. The points-to set of a cycle
+    // is gathered in its representative, the other members of
+    // the cycle copy the set from the representative only when
+    // a node that reads them is processed (see syncCycleMember())
+    // and once after the analysis.
+    // The representative of a node (indexed by ID), or nullptr.
+    std::vector<PSNode *> cycle_rep;
+    // the members of the cycles (indexed by ID of the representative)
+    std::unordered_map<unsigned, std::vector<PSNode *>> cycle_members;
+    // the representative and the version of its points-to set
+    // that a member has copied (indexed by ID of the member)
+    std::vector<std::pair<const PSNode *, unsigned>> cycle_synced;
+    // the copy edges (operand, node) that were already searched for a cycle
+    std::set<std::pair<unsigned, unsigned>> cycle_checked;
+    // incremented whenever a cycle is created or merged with another
+    unsigned cycles_version{0};
+
+    // the position of a node (indexed by ID) in its SCC:
+    // the reverse postorder of the nodes of the SCC.
+    // UNORDERED for the nodes that are not in any SCC.
+    std::vector<unsigned> order;
+    enum : unsigned { UNORDERED = ~0u };
+
+    bool inSCCs(const PSNode *n) const {
+        return n->getID() < order.size() && order[n->getID()] != UNORDERED;
+    }
+
+    // number the nodes of the component (stored in the postorder)
+    void numberSCC(unsigned id) {
+        unsigned pos = 0;
+        for (auto NI = SCCs[id].rbegin(), NE = SCCs[id].rend(); NI != NE; ++NI) {
+            if ((*NI)->getID() >= order.size())
+                order.resize((*NI)->getID() + 1, UNORDERED);
+            order[(*NI)->getID()] = pos++;
+        }
+    }
+
+    void computeSCCs() {
+        SCC<PSNode> scc_comp(sccs_index);
+        SCCs = std::move(scc_comp.compute(PS->getRoot()));
+        sccs_index = scc_comp.getIndex();
+
+        order.assign(PS->size(), UNORDERED);
+        scc_pos.assign(SCCs.size(), 0);
+        scc_marks.assign(SCCs.size(), 0);
+        scc_order.clear();
+
+        // SCCs are in the reverse topological order
+        std::vector<unsigned> ids;
+        ids.reserve(SCCs.size());
+        for (unsigned i = SCCs.size(); i > 0; --i) {
+            numberSCC(i - 1);
+            ids.push_back(i - 1);
+        }
+        insertSCCs(UNORDERED, ids);
+
+        // the nodes that are not in the SCCs (not reachable now)
+        // must be searched again by updateSCCs()
+        for (const auto& nd : PS->getNodes()) {
+            if (nd && !inSCCs(nd.get()))
+                nd->dfs_id = 0;
+        }
+    }
 
     void initPointerAnalysis() {
         assert(PS && "Need PointerSubgraph object");
 
         // compute the strongly connected components
         // FIXME: do that optional
-        SCC<PSNode> scc_comp;
-        SCCs = std::move(scc_comp.compute(PS->getRoot()));
-        sccs_index = scc_comp.getIndex();
+        computeSCCs();
     }
 
 protected:
@@ -47,7 +171,77 @@ protected:
     std::vector<PSNode *> to_process;
     std::vector<PSNode *> changed;
 
+    Statistics statistics;
+
+    const PointerAnalysisOptions& getOptions() const { return options; }
+
+    // process the node sequentially, returns true if anything changed
+    bool processNode(PSNode *);
+    bool processMemcpy(std::vector<MemoryObject *>& srcObjects,
+                       std::vector<MemoryObject *>& destObjects,
+                       const Pointer& sptr, const Pointer& dptr,
+                       Offset len);
+    // check the sanity of results of pointer analysis
+    void sanityCheck();
+
+    // forget the inputs that the nodes have already processed,
+    // so that the next processing of the nodes merges all of them
+    // (used when the points-to sets are computed again)
+    void forgetSeenInputs() { seen_inputs.clear(); }
+
+    // the position of the node in the order of the worklist:
+    // the position of its SCC and the position in the SCC
+    uint64_t getPriority(const PSNode *n) const {
+        if (!inSCCs(n))
+            return ~static_cast<uint64_t>(0);
+        return (static_cast<uint64_t>(scc_pos[n->getSCCId()]) << 32)
+                | order[n->getID()];
+    }
+
+    // the representative of the collapsed cycle of the node (or nullptr)
+    // and the members of the cycle with the given representative
+    PSNode *getCycleRep(const PSNode *n) const {
+        return n->getID() < cycle_rep.size() ? cycle_rep[n->getID()] : nullptr;
+    }
+
+    const std::vector<PSNode *>& getCycleMembers(const PSNode *rep) {
+        return cycle_members[rep->getID()];
+    }
+
+    // copy the points-to set of the representative to the member
+    // of a cycle if it changed since the last copy
+    bool syncCycleMember(PSNode *node);
+    // the operands of the node are going to be read
+    void syncOperands(PSNode *node) {
+        for (PSNode *op : node->getOperands())
+            syncCycleMember(op);
+    }
+    void syncCycleMembers();
+
+    // is the node in the PointerSubgraph (and not e.g. NULLPTR)?
+    bool isGraphNode(const PSNode *node) const {
+        const auto& nodes = PS->getNodes();
+        return node->getID() < nodes.size() &&
+               nodes[node->getID()].get() == node;
+    }
+
+    // get the allocation that the target of a pointer belongs to
+    // (the same mapping as in PointerAnalysisFI::getMemoryObjects())
+    static PSNode *getAllocationNode(PSNode *target) {
+        if (target->getType() == PSNodeType::CAST ||
+            target->getType() == PSNodeType::GEP)
+            return target->getOperand(0);
+
+        if (target->getType() == PSNodeType::CONSTANT) {
+            assert(target->pointsTo.size() == 1);
+            return (*target->pointsTo.begin()).target;
+        }
+
+        return target;
+    }
+
 public:
+    const Statistics& getStatistics() const { return statistics; }
 
     PointerAnalysis(PointerSubgraph *ps,
                     const PointerAnalysisOptions& opts)
@@ -88,7 +282,7 @@ public:
 
     PointerSubgraph *getPS() const { return PS; }
 
-    const std::vector<std::vector<PSNode *> > &getSCCs() const { return SCCs; }
+    const SCCComponents<PSNode>& getSCCs() const { return SCCs; }
 
     virtual void enqueue(PSNode *n)
     {
@@ -119,11 +313,13 @@ public:
             enq |= beforeProcessed(cur);
             enq |= processNode(cur);
             enq |= afterProcessed(cur);
+            ++statistics.processedNodes;
 
             if (enq)
                 enqueue(cur);
         }
 
+        ++statistics.iterations;
         return !changed.empty();
     }
 
@@ -144,10 +340,21 @@ public:
         }
     }
 
-    void run()
+    virtual void run()
     {
-        // do preprocessing and queue the nodes
+        // the sets created during the analysis use the numbering of PS
+        PointerIdRegistry::Scope scope(PS->getIdRegistry());
+
         preprocess();
+
+        if (options.worklistFixpoint) {
+            sanityCheck();
+            solveWorklist();
+            sanityCheck();
+            return;
+        }
+
+        // queue the nodes
         initialize_queue();
 
         // check that the current state of pointer analysis makes sense
@@ -203,6 +410,21 @@ public:
         return false;
     }
 
+    // adjust the PointerSubgraph on calls of more functions
+    // that were found at once for the callsite (the graph is then
+    // updated once for all of them)
+    // @ where is the callsite
+    // @ what are the functions that are being called
+    virtual bool functionPointerCalls(PSNode *where,
+                                      const std::vector<PSNode *>& what)
+    {
+        bool changed = false;
+        for (PSNode *called : what)
+            changed |= functionPointerCall(where, called);
+
+        return changed;
+    }
+
     virtual bool handleFork(PSNode *)
     {
         return false;
@@ -213,10 +435,39 @@ public:
         return false;
     }
 
+    // Does the memory change only by processing STORE and MEMCPY nodes?
+    // (and not e.g. by merging memory maps of the flow-sensitive analysis)
+    // Then loads and stores whose inputs did not change can be skipped.
+    virtual bool memoryChangesOnlyByStores() const
+    {
+        return false;
+    }
+
+    // Does the node see the memory of its predecessor, so that
+    // a change of the memory in the predecessor is a change
+    // of the memory in this node? (used by the worklist fixpoint)
+    virtual bool usesPredecessorsMemory(PSNode *) const
+    {
+        return false;
+    }
+
 private:
+    // compute the fixpoint using a worklist of nodes whose inputs changed
+    void solveWorklist();
 
-    // check the sanity of results of pointer analysis
-    void sanityCheck();
+    bool collapsingCycles() const {
+        return options.collapseCycles && options.worklistFixpoint;
+    }
+
+    // does the node only copy points-to sets of its operands?
+    bool isCopyNode(const PSNode *n) const;
+
+    // the node has just merged the points-to set of the operand,
+    // if the sets are the same, look for a cycle and collapse it.
+    // Returns true if the points-to set of the node changed.
+    bool detectCycle(PSNode *node, PSNode *operand);
+    bool collapseCycle(PSNode *rep, const std::vector<PSNode *>& nodes);
+    bool processCycleMember(PSNode *node, PSNode *rep);
 
     void preprocessGEPs()
     {
@@ -225,7 +476,8 @@ private:
         // in the loop will end up with Offset::UNKNOWN after some
         // number of iterations, so we can do that right now
         // and save iterations
-        for (const auto& scc : SCCs) {
+        for (unsigned idx = 0; idx < SCCs.size(); ++idx) {
+            const auto scc = SCCs[idx];
             if (scc.size() > 1) {
                 for (PSNode *n : scc) {
                     if (PSNodeGep *gep = PSNodeGep::get(n))
@@ -235,21 +487,45 @@ private:
         }
     }
 
-    bool processNode(PSNode *);
+    // did the idx-th operand or the memory change since the last
+    // call for this node? The current state is remembered.
+    bool operandChanged(PSNode *node, size_t idx);
+    bool memoryChanged(PSNode *node);
     bool processLoad(PSNode *node);
     bool processGep(PSNode *node);
     bool processMemcpy(PSNode *node);
-    bool processMemcpy(std::vector<MemoryObject *>& srcObjects,
-                       std::vector<MemoryObject *>& destObjects,
-                       const Pointer& sptr, const Pointer& dptr,
-                       Offset len);
+
+    void objectChanged(MemoryObject *mo)
+    {
+        if (record_changed_objects)
+            changed_objects.push_back(mo);
+    }
 
     void recomputeSCCs()
     {
-        SCC<PSNode> scc_comp(sccs_index);
-        SCCs = std::move(scc_comp.compute(PS->getRoot()));
-        sccs_index = scc_comp.getIndex();
+        computeSCCs();
     }
+
+    // Update the SCCs after the graph has changed at the callsite:
+    // the nodes with IDs from 'first_new_id' were added and the callsite
+    // had 'old_successors' before the change. Only the components
+    // that the new edges affect are searched (the topological order
+    // is maintained as in the algorithm of Pearce and Kelly).
+    void updateSCCs(PSNode *callsite,
+                    const std::vector<PSNode *>& old_successors,
+                    unsigned first_new_id);
+    // add the components of the new nodes
+    void addNewSCCs(PSNode *callsite, unsigned first_new_id);
+    // put the components 'ids' (in this order) right after
+    // the component 'after' (at the end if it is UNORDERED)
+    void insertSCCs(unsigned after, const std::vector<unsigned>& ids);
+    // keep the order of SCCs topological after adding the edge,
+    // merge the components if the edge closes a cycle
+    void addSCCEdge(PSNode *from, PSNode *to);
+    // merge the components, return the id of the merged component
+    unsigned mergeSCCs(std::vector<unsigned>& components);
+    // are the nodes in the same SCC reachable without the removed edge?
+    bool stillConnected(PSNode *from, PSNode *to);
 };
 
 } // namespace pta
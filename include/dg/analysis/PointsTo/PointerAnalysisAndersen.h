@@ -0,0 +1,149 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_ANDERSEN_H_
+#define _DG_ANALYSIS_POINTS_TO_ANDERSEN_H_
+
+#include <cassert>
+#include <map>
+#include <set>
+#include <vector>
+#include <unordered_map>
+
+#include "PointerAnalysis.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Flow-insensitive inclusion-based (Andersen-style) pointer analysis.
+//
+// Unlike PointerAnalysisFI, this analysis does not iterate over
+// the control flow of the PointerSubgraph. It extracts a constraint graph
+// from the nodes of the PointerSubgraph and solves it with a worklist.
+// The address-of constraints are the initial points-to sets of the nodes
+// (allocations, functions, constants), the other constraints are:
+//
+//   copy     a  = b        (PHI, CAST, RETURN, CALL_RETURN)
+//   gep      a  = b + off  (GEP)
+//   load     a  = *b       (LOAD)
+//   store    *a = b        (STORE)
+//   memcpy   *a = *b       (MEMCPY)
+//   call     a  = b()      (CALL_FUNCPTR, resolved during solving)
+//
+// The memory is modeled by locations (object, offset) that have their
+// own points-to sets. The points-to sets of nodes are computed directly
+// in PSNode::pointsTo, so the hooks of PointerAnalysis (calls via pointers,
+// threads) can be used during solving. When a hook changes the graph,
+// the constraints of the new nodes and operands are extracted.
+class PointerAnalysisAndersen : public PointerAnalysis
+{
+public:
+    PointerAnalysisAndersen(PointerSubgraph *ps,
+                            const PointerAnalysisOptions& opts)
+    : PointerAnalysis(ps, opts) {}
+
+    // default options
+    PointerAnalysisAndersen(PointerSubgraph *ps)
+    : PointerAnalysisAndersen(ps, {}) {}
+
+    void run() override;
+
+    // the solver does not use memory objects,
+    // the memory is kept in the locations of the constraint graph
+    void getMemoryObjects(PSNode *, const Pointer&,
+                          std::vector<MemoryObject *>&) override {}
+
+    // the pointers that may be stored in the memory
+    // (object, offset) after the analysis, or nullptr
+    const PointsToSetT *getMemoryPointsTo(PSNode *object, Offset off) const;
+
+    size_t getNumOfConstraints() const { return constraints.size(); }
+    size_t getNumOfLocations() const { return locations.size(); }
+
+private:
+    struct Constraint {
+        enum class Kind { COPY, GEP, LOAD, STORE, MEMCPY, CALL } kind;
+        // the node of the PointerSubgraph that gave the constraint
+        PSNode *node;
+        // the operand whose points-to set is copied
+        // (the only operand for other constraints than copy)
+        PSNode *operand;
+
+        Constraint(Kind k, PSNode *n, PSNode *op)
+        : kind(k), node(n), operand(op) {}
+    };
+
+    // memory location (object, offset)
+    struct Location {
+        PSNode *object;
+        Offset offset;
+        PointsToSetT pointsTo;
+        // loads that read this location
+        std::set<PSNode *> readers;
+        // locations that copy this location (memcpy)
+        std::set<unsigned> copies;
+
+        Location(PSNode *obj, Offset off) : object(obj), offset(off) {}
+    };
+
+    struct Object {
+        // the locations of the object by the offset
+        std::map<Offset, unsigned> fields;
+        // loads that read the object at unknown offset,
+        // they read all the fields of the object
+        std::set<PSNode *> wildcardReaders;
+        // memcpy constraints that read the object
+        std::set<size_t> memcpys;
+    };
+
+    std::vector<Constraint> constraints;
+    // the constraints that use the points-to set of a node (indexed by ID)
+    std::vector<std::vector<size_t>> uses;
+    // the number of operands of the node (indexed by ID) whose
+    // constraints were extracted or -1 if the node was not seen yet
+    std::vector<int> extracted;
+    // FORK and JOIN nodes, they read points-to sets of nodes
+    // that are not their operands
+    std::vector<PSNode *> forks_joins;
+
+    std::vector<Location> locations;
+    std::unordered_map<PSNode *, Object> objects;
+
+    std::vector<PSNode *> node_worklist;
+    std::vector<bool> node_queued;
+    std::vector<unsigned> loc_worklist;
+    std::vector<bool> loc_queued;
+    // constraints that have not been applied yet
+    std::vector<size_t> new_constraints;
+
+    void queue(PSNode *node);
+    void queue(unsigned loc);
+
+    // extract the constraints from the nodes reachable from the root
+    // that were not processed yet (or that got new operands)
+    void extractConstraints();
+    void extractConstraints(PSNode *node);
+    void addConstraint(Constraint::Kind kind, PSNode *node, PSNode *operand);
+
+    unsigned getLocation(PSNode *object, Offset off);
+    // add the pointers to the location, queue it on change
+    void addToLocation(unsigned loc, const PointsToSetT& ptrs);
+    void addToLocation(unsigned loc, const Pointer& ptr);
+    // add the node to the readers of the location
+    void addReader(unsigned loc, PSNode *reader);
+    void addCopy(unsigned from, unsigned to);
+
+    void applyConstraint(size_t idx);
+    void applyGep(PSNode *node);
+    void applyLoad(PSNode *node);
+    void applyStore(PSNode *node);
+    void applyMemcpy(size_t idx);
+    void applyCall(PSNode *node);
+
+    void solve();
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_ANDERSEN_H_
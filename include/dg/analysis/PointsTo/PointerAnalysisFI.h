@@ -19,11 +19,15 @@ class PointerAnalysisFI : public PointerAnalysis
     std::vector<std::unique_ptr<MemoryObject>> memory_objects;
 
 public:
-    PointerAnalysisFI(PointerSubgraph *ps)
-    : PointerAnalysis(ps) {
+    PointerAnalysisFI(PointerSubgraph *ps,
+                      const PointerAnalysisOptions& opts)
+    : PointerAnalysis(ps, opts) {
         memory_objects.reserve(std::max(ps->size() / 100, static_cast<size_t>(8)));
     }
 
+    // default options
+    PointerAnalysisFI(PointerSubgraph *ps) : PointerAnalysisFI(ps, {}) {}
+
     void getMemoryObjects(PSNode *where, const Pointer& pointer,
                           std::vector<MemoryObject *>& objects) override
     {
@@ -55,6 +59,10 @@ public:
 
         objects.push_back(mo);
     }
+
+    // memory objects are shared by the whole program
+    // and only stores and memcpy write to them
+    bool memoryChangesOnlyByStores() const override { return true; }
 };
 
 } // namespace pta
@@ -0,0 +1,129 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_FLOW_INSENSITIVE_PARALLEL_H_
+#define _DG_ANALYSIS_POINTS_TO_FLOW_INSENSITIVE_PARALLEL_H_
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "PointerAnalysisFI.h"
+#include "dg/ADT/Queue.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Flow-insensitive inclusion-based pointer analysis solved by more threads
+// (the number of threads is PointerAnalysisOptions::solverThreads).
+// The results are the same as the results of PointerAnalysisFI.
+//
+// Every worker thread takes the nodes whose inputs changed from its own
+// work-stealing queue and steals from the queues of the other workers when
+// it runs out of work. The points-to sets only grow, so the nodes can be
+// processed in any order and at the same time. The points-to sets of nodes
+// and the memory objects are guarded by striped locks. A worker holds
+// at most two locks of nodes (taken at once) and one lock of memory,
+// so the locking cannot deadlock. The workers stop when no node is queued
+// and no node is being processed.
+//
+// The nodes that may change the PointerSubgraph (calls via pointers,
+// forks and joins) are processed sequentially after the workers stop.
+// The new nodes, the nodes that got new operands and the users of the nodes
+// whose points-to sets changed are then queued for the next parallel phase.
+//
+// The implementations of points-to sets that share a global state
+// (the IDs of pointers, BDDs, interned sets) can not be used by more threads,
+// with these sets the analysis falls back to the sequential solver.
+class PointerAnalysisFIParallel : public PointerAnalysisFI
+{
+public:
+    PointerAnalysisFIParallel(PointerSubgraph *ps,
+                              const PointerAnalysisOptions& opts)
+    : PointerAnalysisFI(ps, opts) {}
+
+    // default options
+    PointerAnalysisFIParallel(PointerSubgraph *ps)
+    : PointerAnalysisFIParallel(ps, {}) {}
+
+    void run() override;
+
+    // can more threads work with (different) sets of the kind at once?
+    static bool isThreadSafe(PointsToSetKind kind) {
+        return kind == PointsToSetKind::OFFSETS_SET ||
+               kind == PointsToSetKind::SIMPLE;
+    }
+
+private:
+    static const unsigned LOCKS_NUM = 1024;
+
+    // locks of the points-to sets of nodes (by ID of the node)
+    std::unique_ptr<std::mutex[]> node_locks{new std::mutex[LOCKS_NUM]};
+    // locks of memory objects (by ID of the allocation)
+    std::unique_ptr<std::mutex[]> memory_locks{new std::mutex[LOCKS_NUM]};
+    // memcpy reads and writes the flags of allocations
+    std::mutex memcpy_lock;
+
+    std::vector<std::unique_ptr<ADT::WorkStealingQueue<PSNode *>>> queues;
+    // is the node (indexed by ID) in some queue?
+    std::unique_ptr<std::atomic<bool>[]> queued;
+    // the number of the queued nodes and the nodes being processed
+    std::atomic<size_t> pending{0};
+    // did some node change in the current parallel phase?
+    std::atomic<bool> progress{false};
+    std::atomic<size_t> processed{0};
+
+    // the nodes that the workers left for the sequential processing
+    std::vector<PSNode *> deferred;
+    std::mutex deferred_lock;
+
+    // the number of operands of the node (indexed by ID)
+    // when it was queued or -1 if the node was not seen yet
+    std::vector<int> operands_num;
+    // loads and memcpy nodes, these read the memory
+    std::vector<PSNode *> memory_readers;
+    std::vector<PSNode *> forks_joins;
+
+    std::mutex& nodeLock(const PSNode *n) {
+        return node_locks[n->getID() % LOCKS_NUM];
+    }
+
+    std::mutex& memoryLock(const MemoryObject *mo) {
+        return memory_locks[mo->node->getID() % LOCKS_NUM];
+    }
+
+    // the memory object of the target of a pointer, the objects
+    // are created before the parallel phase (see createMemoryObjects())
+    MemoryObject *getObject(PSNode *target) {
+        PSNode *n = getAllocationNode(target);
+        assert(n->getData<MemoryObject>() && "No memory object for the target");
+        return n->getData<MemoryObject>();
+    }
+
+    void push(PSNode *n, unsigned worker);
+    void pushUsers(PSNode *n, unsigned worker);
+    void pushMemoryReaders(unsigned worker);
+
+    void createMemoryObjects();
+    // queue the new nodes, the nodes with new operands
+    // and the users of the nodes whose versions changed
+    void queueChanged(const std::vector<unsigned>& versions);
+
+    // process the nodes that were left by the workers, forks and joins
+    void processSequential();
+    void solveParallel();
+    void worker(unsigned idx);
+
+    void processNodeParallel(PSNode *node, unsigned worker);
+    bool processCopy(PSNode *node);
+    bool processGep(PSNode *node);
+    bool processLoad(PSNode *node);
+    bool processStore(PSNode *node);
+    bool processMemcpy(PSNode *node);
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_FLOW_INSENSITIVE_PARALLEL_H_
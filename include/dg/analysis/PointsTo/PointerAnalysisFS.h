@@ -5,6 +5,7 @@
 #include <memory>
 
 #include "MemoryObject.h"
+#include "MemoryMap.h"
 #include "PointerSubgraph.h"
 
 namespace dg {
@@ -18,7 +19,8 @@ class PointerAnalysisFS : public PointerAnalysis
 {
 public:
     //using MemoryObjectsSetT = std::set<MemoryObject *>;
-    using MemoryMapT = std::map<PSNode *, std::unique_ptr<MemoryObject>>;
+    using MemoryObjectPtr = MemoryMap::MemoryObjectPtr;
+    using MemoryMapT = MemoryMap;
 
     // this is an easy but not very efficient implementation,
     // works for testing
@@ -95,25 +97,33 @@ public:
         return changed;
     }
 
+    // the nodes that do not merge memory maps share
+    // the memory map of their predecessor
+    bool usesPredecessorsMemory(PSNode *n) const override
+    {
+        return !needsMerge(n);
+    }
+
     void getMemoryObjects(PSNode *where, const Pointer& pointer,
                           std::vector<MemoryObject *>& objects) override
     {
         MemoryMapT *mm = where->getData<MemoryMapT>();
         assert(mm && "Node does not have memory map");
 
+        // if we haven't found any memory object, but this psnode
+        // is a write to memory, create a new one, so that
+        // the write has something to write to.
+        // The write must not change the objects shared with other maps.
+        if (canChangeMM(where)) {
+            objects.push_back(mm->getWritable(pointer.target));
+            mm->setChanged(pointer.target);
+            return;
+        }
+
         auto I = mm->find(pointer.target);
         if (I != mm->end()) {
             objects.push_back(I->second.get());
         }
-
-        // if we haven't found any memory object, but this psnode
-        // is a write to memory, create a new one, so that
-        // the write has something to write to
-        if (objects.empty() && canChangeMM(where)) {
-            MemoryObject *mo = new MemoryObject(pointer.target);
-            mm->emplace(pointer.target, std::unique_ptr<MemoryObject>(mo));
-            objects.push_back(mo);
-        }
     }
 
 protected:
@@ -164,20 +174,117 @@ protected:
         return changed;
     }
 
+    // does 'to' contain all offsets and pointers from 'from'
+    // (except the overwritten ones)?
+    static bool containsObject(PSNode *node,
+                               const MemoryObject *to,
+                               const MemoryObject *from,
+                               PointsToSetT *overwritten) {
+        for (auto& fromIt : from->pointsTo) {
+            if (overwritten &&
+                overwritten->count(Pointer(node, fromIt.first)))
+                continue;
+
+            auto toIt = to->pointsTo.find(fromIt.first);
+            if (toIt == to->pointsTo.end())
+                return false;
+
+            if (fromIt.second.empty())
+                continue;
+
+            // the union of the sets is faster than looking up
+            // the pointers one by one
+            PointsToSetT S(toIt->second);
+            if (S.add(fromIt.second))
+                return false;
+        }
+
+        return true;
+    }
+
+    static bool hasPointers(const MemoryObject *mo) {
+        for (auto& it : mo->pointsTo) {
+            if (!it.second.empty())
+                return true;
+        }
+        return false;
+    }
+
+    // merge the object of 'target' from some other map into the map 'mm',
+    // return true if any new information was created
+    static bool mergeObject(MemoryMapT *mm, PSNode *target,
+                            const MemoryObjectPtr& fromMo,
+                            PointsToSetT *overwritten) {
+        MemoryObjectPtr& toMo = (*mm)[target];
+        if (toMo == fromMo)
+            return false;
+
+        bool overwrites = overwritten &&
+                          overwritten->pointsToTarget(target);
+        if (!toMo && !overwrites) {
+            toMo = fromMo;
+            mm->setChanged(target);
+            return hasPointers(fromMo.get());
+        }
+
+        if (toMo && toMo.use_count() > 1) {
+            // do not copy the shared object if it would not change
+            if (containsObject(target, toMo.get(),
+                               fromMo.get(), overwritten))
+                return false;
+
+            // the object in 'mm' is a subset of the object
+            // from 'from', so the union is the object from 'from'
+            // (that has something more, checked above)
+            if (!overwrites &&
+                containsObject(target, fromMo.get(),
+                               toMo.get(), nullptr)) {
+                toMo = fromMo;
+                mm->setChanged(target);
+                return true;
+            }
+        }
+
+        bool created = !toMo;
+        if (!mergeObjects(target, MemoryMapT::getWritable(toMo, target),
+                          fromMo.get(), overwritten)) {
+            if (created)
+                mm->setChanged(target);
+            return false;
+        }
+
+        // the object is the same as the object from 'from' now
+        // (e.g. on the head of a loop), share it
+        if (!overwrites &&
+            containsObject(target, fromMo.get(), toMo.get(), nullptr))
+            toMo = fromMo;
+
+        mm->setChanged(target);
+        return true;
+    }
+
     // Merge two Memory maps, return true if any new information was created,
-    // otherwise return false
+    // otherwise return false. Only the objects that changed since
+    // the last merge of 'from' into 'mm' are merged.
     static bool mergeMaps(MemoryMapT *mm, MemoryMapT *from,
                           PointsToSetT *overwritten) {
+        if (mm == from)
+            return false;
+
         bool changed = false;
-        for (auto& it : *from) {
-            PSNode *fromTarget = it.first;
-            std::unique_ptr<MemoryObject>& toMo = (*mm)[fromTarget];
-            if (toMo == nullptr)
-                toMo.reset(new MemoryObject(fromTarget));
-
-            changed |= mergeObjects(fromTarget, toMo.get(),
-                                    it.second.get(), overwritten);
+        auto *changes = from->getChanges(mm, overwritten != nullptr);
+        if (!changes) {
+            for (auto& it : *from)
+                changed |= mergeObject(mm, it.first, it.second, overwritten);
+            return changed;
+        }
+
+        for (PSNode *target : *changes) {
+            auto it = from->find(target);
+            assert(it != from->end() && "Changed object is not in the map");
+            changed |= mergeObject(mm, target, it->second, overwritten);
         }
+        changes->clear();
 
         return changed;
     }
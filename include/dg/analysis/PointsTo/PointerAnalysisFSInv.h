@@ -24,12 +24,10 @@ class PointerAnalysisFSInv : public PointerAnalysisFS
     }
 
     static MemoryObject *getOrCreateMO(MemoryMapT *mm, PSNode *target) {
-        std::unique_ptr<MemoryObject>& moptr = (*mm)[target];
-        if (!moptr)
-            moptr.reset(new MemoryObject(target));
-
+        MemoryObject *mo = mm->getWritable(target);
+        mm->setChanged(target);
         assert(mm->find(target) != mm->end());
-        return moptr.get();
+        return mo;
     }
 
 public:
@@ -87,6 +85,11 @@ public:
         return PointerAnalysisFS::afterProcessed(n);
     }
 
+    bool usesPredecessorsMemory(PSNode *n) const override
+    {
+        return !needsMerge(n);
+    }
+
     static bool isLocal(PSNodeAlloc *alloc, PSNode *where) {
         return !alloc->isHeap() && !alloc->isGlobal() &&
                 alloc->getParent() == where->getParent();
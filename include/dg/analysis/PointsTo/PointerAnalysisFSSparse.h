@@ -0,0 +1,122 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_FLOW_SENSITIVE_SPARSE_H_
+#define _DG_ANALYSIS_POINTS_TO_FLOW_SENSITIVE_SPARSE_H_
+
+#include <cassert>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "PointerAnalysis.h"
+#include "PointerAnalysisFS.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Flow-sensitive pointer analysis solved sparsely, in two stages.
+//
+// The first stage is the flow-insensitive analysis. Its results say which
+// memory objects (targets of pointers) may every store, memcpy and load
+// access and the calls via pointers are resolved (the subgraphs of the called
+// functions are built) in this stage.
+//
+// The second stage computes the flow-sensitive points-to sets.
+// Instead of keeping the memory maps in nodes of the PointerSubgraph,
+// the memory of every object lives only in the nodes that write the object
+// (as found by the first stage) and in the nodes where the paths
+// from these nodes join (like phi nodes of the memory SSA). The memory flows
+// along def-use chains from these nodes to the next writes, joins and to
+// the nodes that read the object. The semantics of the transfer functions
+// (including the strong updates) are the same as in PointerAnalysisFS.
+//
+// The calls via pointers, forks and joins keep the flow-insensitive
+// points-to sets, so the results can be less precise than the results
+// of PointerAnalysisFS if the flow-insensitive stage finds more functions
+// called via a pointer.
+class PointerAnalysisFSSparse : public PointerAnalysisFS
+{
+public:
+    PointerAnalysisFSSparse(PointerSubgraph *ps,
+                            PointerAnalysisOptions opts)
+    : PointerAnalysisFS(ps, opts) {}
+
+    PointerAnalysisFSSparse(PointerSubgraph *ps)
+    : PointerAnalysisFSSparse(ps, {}) {}
+
+    void run() override;
+
+    void getMemoryObjects(PSNode *where, const Pointer& pointer,
+                          std::vector<MemoryObject *>& objects) override;
+
+    // the nodes do not have memory maps
+    bool beforeProcessed(PSNode *) override { return false; }
+    bool afterProcessed(PSNode *) override { return false; }
+    bool usesPredecessorsMemory(PSNode *) const override { return false; }
+
+    // in the flow-insensitive stage, the memory is shared
+    // by the whole program
+    bool memoryChangesOnlyByStores() const override {
+        return stage == Stage::FLOW_INSENSITIVE;
+    }
+
+    // the number of the places in the program where
+    // the second stage keeps the memory of an object
+    size_t getSlotsNum() const { return slots.size(); }
+
+private:
+    enum class Stage { FLOW_INSENSITIVE, SPARSE } stage{Stage::FLOW_INSENSITIVE};
+
+    // the memory objects of the flow-insensitive stage (by allocation)
+    std::unordered_map<PSNode *, std::unique_ptr<MemoryObject>> fi_memory;
+
+    // The memory of one object (the target of pointers) in a node
+    struct Slot {
+        PSNode *node;
+        PSNode *target;
+        // the memory is defined here (the node writes the object
+        // or merges the memory from more predecessors) and flows
+        // to the successors, otherwise the node only reads it
+        bool def;
+        bool queued{false};
+        // the memory, nullptr if no object reached the node yet
+        std::unique_ptr<MemoryObject> mo;
+        // the slots that see the memory of this slot
+        // and the slots whose memory this slot sees
+        std::vector<Slot *> successors;
+        std::vector<Slot *> predecessors;
+
+        Slot(PSNode *n, PSNode *t, bool d) : node(n), target(t), def(d) {}
+    };
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    // the slots of a node (indexed by ID) sorted by the target
+    std::vector<std::vector<Slot *>> node_slots;
+    // the def slots whose memory changed
+    std::vector<Slot *> changed_slots;
+
+    Slot *getSlot(const PSNode *node, const PSNode *target) const;
+    void queueSlot(Slot *slot);
+
+    // the targets of pointers that the node may dereference,
+    // according to the current points-to sets
+    static void getTargets(PSNode *ptr, std::vector<PSNode *>& targets);
+
+    void runFlowInsensitive();
+    // forget the flow-insensitive points-to sets
+    void resetPointsTo(const std::vector<PSNode *>& nodes);
+    void buildSlots(const std::vector<PSNode *>& nodes);
+    // merge the memory of the slot to its successors, the nodes that
+    // read the changed memory or that merge it themselves (stores)
+    // are pushed to 'pending'
+    void propagate(Slot *slot, std::vector<PSNode *>& pending);
+    // merge the memory of the predecessors to the slots of the store
+    bool mergeStoreSlots(PSNode *store);
+    void solveSparse(const std::vector<PSNode *>& nodes);
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_FLOW_SENSITIVE_SPARSE_H_
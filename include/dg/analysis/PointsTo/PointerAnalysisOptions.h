@@ -2,6 +2,7 @@
 #define _DG_POINTER_ANALYSIS_OPTIONS_H_
 
 #include "dg/analysis/AnalysisOptions.h"
+#include "dg/analysis/PointsTo/PointsToSets/PointsToSetKind.h"
 
 namespace dg {
 namespace analysis {
@@ -19,8 +20,34 @@ struct PointerAnalysisOptions : AnalysisOptions {
     // INVALIDATED object.
     bool invalidateNodes{false};
 
+    // Process only the nodes whose inputs changed, in the topological
+    // order of strongly connected components of the PointerSubgraph.
+    // If false, every iteration of the analysis processes all
+    // the nodes reachable from the nodes that changed.
+    // Off by default, the worklist does not beat the iterations
+    // on every program yet.
+    bool worklistFixpoint{false};
+
+    // Detect cycles of nodes that only copy points-to sets
+    // (PHI, CAST, ...) during the analysis and collapse them,
+    // so that the pointers do not circulate around the cycle.
+    // Used only with the worklist fixpoint.
+    bool collapseCycles{true};
+
+    // The number of threads that solve the flow-insensitive analysis
+    // (see PointerAnalysisFIParallel). 1 means the sequential solver.
+    unsigned solverThreads{1};
+
+    // The implementation of points-to sets of the PointerSubgraph
+    // built with these options (see PointerSubgraph::getPointsToSetKind()).
+    pta::PointsToSetKind pointsToSetKind{pta::PointsToSetKind::OFFSETS_SET};
+
     PointerAnalysisOptions& setInvalidateNodes(bool b) { invalidateNodes = b; return *this;}
     PointerAnalysisOptions& setPreprocessGeps(bool b)  { preprocessGeps = b; return *this;}
+    PointerAnalysisOptions& setWorklistFixpoint(bool b) { worklistFixpoint = b; return *this;}
+    PointerAnalysisOptions& setCollapseCycles(bool b) { collapseCycles = b; return *this;}
+    PointerAnalysisOptions& setSolverThreads(unsigned n) { solverThreads = n; return *this;}
+    PointerAnalysisOptions& setPointsToSetKind(pta::PointsToSetKind k) { pointsToSetKind = k; return *this;}
 };
 
 } // namespace analysis
@@ -0,0 +1,154 @@
+#ifndef _DG_ANALYSIS_POINTS_TO_STEENSGAARD_H_
+#define _DG_ANALYSIS_POINTS_TO_STEENSGAARD_H_
+
+#include <cassert>
+#include <map>
+#include <vector>
+#include <unordered_map>
+
+#include "PointerAnalysis.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+///
+// Flow-insensitive unification-based (Steensgaard-style) pointer analysis.
+//
+// Every node has a cell that abstracts the pointer value of the node.
+// A cell points to one (object, offset) pair, where the object is
+// an equivalence class of allocations. An object has a cell
+// for each of its fields (offsets). The assignments unify
+// the cells instead of including one points-to set into another:
+//
+//   a  = b        (PHI, CAST, ...)  unify cell(a) and cell(b)
+//   a  = *b       (LOAD)            unify cell(a) and field(target(b))
+//   *a = b        (STORE)           unify field(target(a)) and cell(b)
+//   a  = b + off  (GEP)             target(a) = target(b) + off
+//
+// Unifying two cells unifies their targets. If the offsets of the targets
+// differ (or an offset is unknown or not below the field sensitivity),
+// the object is collapsed to a single field with unknown offset.
+// Null and unknown pointers are kept as flags of the cells, assigning
+// them only sets the flags (the cells are not unified with anything).
+//
+// The unifications are done with union-find, so a pass over the nodes
+// is almost linear. The passes are repeated until nothing changes
+// (GEPs, memcpy and calls via pointers depend on the current targets).
+class PointerAnalysisSteensgaard : public PointerAnalysis
+{
+public:
+    PointerAnalysisSteensgaard(PointerSubgraph *ps,
+                               const PointerAnalysisOptions& opts)
+    : PointerAnalysis(ps, opts) {}
+
+    // default options
+    PointerAnalysisSteensgaard(PointerSubgraph *ps)
+    : PointerAnalysisSteensgaard(ps, {}) {}
+
+    void run() override;
+
+    // the solver does not use memory objects
+    void getMemoryObjects(PSNode *, const Pointer&,
+                          std::vector<MemoryObject *>&) override {}
+
+    // do the two nodes point to the same equivalence class of objects?
+    bool pointsToSameObjects(PSNode *a, PSNode *b);
+
+private:
+    static const unsigned NONE = ~0U;
+
+    struct Cell {
+        unsigned parent;
+        unsigned rank{0};
+        // the object and the offset that the cell points to
+        unsigned object{NONE};
+        Offset offset{0};
+        bool null{false};
+        bool unknown{false};
+
+        Cell(unsigned p) : parent(p) {}
+    };
+
+    struct Object {
+        unsigned parent;
+        unsigned rank{0};
+        // the cells of the fields by the offset
+        std::map<Offset, unsigned> fields;
+        // all the fields are unified to the one at unknown offset
+        bool collapsed{false};
+        bool zeroInitialized{false};
+        // the maximal size of the allocations
+        Offset size{0};
+        // the allocations in the class
+        std::vector<PSNode *> nodes;
+
+        Object(unsigned p) : parent(p) {}
+    };
+
+    std::vector<Cell> cells;
+    std::vector<Object> objects;
+
+    // the cell of a node (indexed by ID)
+    std::vector<unsigned> node_cells;
+    // the cells of the nodes that are not in the graph (NULLPTR, ...),
+    // these cells have only the flags and are never unified
+    std::unordered_map<const PSNode *, unsigned> special_cells;
+    // the objects of allocations (indexed by ID)
+    std::vector<unsigned> node_objects;
+
+    // cells to unify
+    std::vector<std::pair<unsigned, unsigned>> pending;
+    bool unifying{false};
+
+    // did anything change in the current pass?
+    bool progress{false};
+    bool graph_changed{false};
+
+    std::vector<PSNode *> forks_joins;
+
+    // the nodes whose points-to sets are set by the graph
+    static bool isAddressNode(const PSNode *node) {
+        return node->getType() == PSNodeType::ALLOC ||
+               node->getType() == PSNodeType::DYN_ALLOC ||
+               node->getType() == PSNodeType::FUNCTION ||
+               node->getType() == PSNodeType::CONSTANT;
+    }
+
+    unsigned newCell();
+    unsigned findCell(unsigned c);
+    unsigned findObject(unsigned o);
+    unsigned getCell(PSNode *node);
+    unsigned getObject(PSNode *alloc);
+    unsigned getField(unsigned obj, Offset off);
+
+    void unifyCells(unsigned a, unsigned b);
+    // unify the cell with the cell of the node (a = node)
+    void unifyWithNode(unsigned cell, PSNode *node);
+    void unifyPending();
+    unsigned unifyObjects(unsigned a, unsigned b);
+    void collapse(unsigned obj);
+    // make the cell point (also) to the object at the offset
+    void addTarget(unsigned cell, unsigned obj, Offset off);
+    void addPointer(unsigned cell, const Pointer& ptr);
+    void setNull(unsigned cell);
+    void setUnknown(unsigned cell);
+    // the offset of the target of the cell (unknown if collapsed)
+    Offset getTargetOffset(unsigned cell);
+
+    void visitNode(PSNode *node);
+    void visitGep(PSNode *node);
+    void visitLoad(PSNode *node);
+    void visitStore(PSNode *node);
+    void visitMemcpy(PSNode *node);
+    void visitCall(PSNode *node);
+
+    // write the results into PSNode::pointsTo
+    void setPointsTo();
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_ANALYSIS_POINTS_TO_STEENSGAARD_H_
@@ -0,0 +1,145 @@
+#ifndef _DG_POINTER_ID_REGISTRY_H_
+#define _DG_POINTER_ID_REGISTRY_H_
+
+#include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointsToSets/PointsToSetKind.h"
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cassert>
+#include <cstddef>
+
+namespace dg {
+
+namespace ADT {
+class BddManager;
+}
+
+namespace analysis {
+namespace pta {
+
+class PointsToSetsPool;
+
+///
+// Numbering of nodes and pointers for the points-to sets that are
+// represented by bitvectors of IDs. The registry is owned by
+// the PointerSubgraph, so the IDs are released with the analysis and
+// more analyses do not share the numbering.
+// Points-to sets take the registry that is active at the time
+// of their construction (see Scope) and get the kind of sets
+// of the registry. If no registry is active, a process-wide registry
+// with the default kind of sets is used.
+class PointerIdRegistry {
+    struct PointerHash {
+        size_t operator()(const Pointer& ptr) const {
+            return std::hash<PSNode *>()(ptr.target)
+                    ^ (std::hash<Offset::type>()(*ptr.offset) * 31);
+        }
+    };
+
+    // nodes and pointers are numbered 1, 2, ...
+    // (node = nodes[id - 1], pointer = pointers[id - 1])
+    std::unordered_map<PSNode *, size_t> nodeIds;
+    std::vector<PSNode *> nodes;
+    std::unordered_map<Pointer, size_t, PointerHash> pointerIds;
+    std::vector<Pointer> pointers;
+    // IDs of the pointers to the given target
+    std::unordered_map<PSNode *, std::vector<size_t>> targetPointers;
+    // the canonical sets of IDs (InternedPointsToSet), if used
+    PointsToSetsPool *setsPool{nullptr};
+    // the BDD nodes of the sets (BddPointsToSet), if used
+    ADT::BddManager *bddManager{nullptr};
+    // the implementation of the points-to sets that use this registry
+    const PointsToSetKind setsKind;
+
+    static PointerIdRegistry *& active() {
+        static thread_local PointerIdRegistry *registry = nullptr;
+        return registry;
+    }
+
+public:
+    PointerIdRegistry(PointsToSetKind kind = PointsToSetKind::OFFSETS_SET)
+    : setsKind(kind) {}
+    PointerIdRegistry(const PointerIdRegistry&) = delete;
+    PointerIdRegistry& operator=(const PointerIdRegistry&) = delete;
+    ~PointerIdRegistry();
+
+    // if the node does not have an ID, it is assigned one
+    size_t getNodeID(PSNode *node) {
+        auto it = nodeIds.find(node);
+        if (it != nodeIds.end())
+            return it->second;
+
+        nodes.push_back(node);
+        return nodeIds.emplace(node, nodes.size()).first->second;
+    }
+
+    // if the pointer does not have an ID, it is assigned one
+    size_t getPointerID(const Pointer& ptr) {
+        auto it = pointerIds.find(ptr);
+        if (it != pointerIds.end())
+            return it->second;
+
+        pointers.push_back(ptr);
+        targetPointers[ptr.target].push_back(pointers.size());
+        return pointerIds.emplace(ptr, pointers.size()).first->second;
+    }
+
+    // the IDs of all the pointers with the target that have an ID
+    const std::vector<size_t>& getPointerIDs(PSNode *target) const {
+        static const std::vector<size_t> empty;
+        auto it = targetPointers.find(target);
+        return it == targetPointers.end() ? empty : it->second;
+    }
+
+    PSNode *getNode(size_t id) const {
+        assert(id > 0 && id <= nodes.size());
+        return nodes[id - 1];
+    }
+
+    const Pointer& getPointer(size_t id) const {
+        assert(id > 0 && id <= pointers.size());
+        return pointers[id - 1];
+    }
+
+    size_t getNodesNum() const { return nodes.size(); }
+    size_t getPointersNum() const { return pointers.size(); }
+
+    // all the pointers with an ID, pointer with ID 'i' is at index i - 1
+    const std::vector<Pointer>& getPointers() const { return pointers; }
+
+    PointsToSetsPool *& getSetsPool() { return setsPool; }
+    ADT::BddManager *& getBddManager() { return bddManager; }
+    PointsToSetKind getSetsKind() const { return setsKind; }
+
+    // the registry for new points-to sets in the current thread
+    static PointerIdRegistry *get() {
+        static PointerIdRegistry global;
+        auto *registry = active();
+        return registry ? registry : &global;
+    }
+
+    ///
+    // Make the registry active in the current thread
+    // for the lifetime of this object
+    class Scope {
+        PointerIdRegistry *_prev;
+
+    public:
+        Scope(PointerIdRegistry *registry) : _prev(active()) {
+            active() = registry;
+        }
+
+        ~Scope() { active() = _prev; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif // _DG_POINTER_ID_REGISTRY_H_
@@ -2,9 +2,11 @@
 #define _DG_POINTER_SUBGRAPH_H_
 
 #include "dg/ADT/Queue.h"
+#include "dg/ADT/Arena.h"
 #include "dg/analysis/SubgraphNode.h"
 #include "dg/analysis/CallGraph.h"
 #include "dg/analysis/PointsTo/PSNode.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
 #include "dg/analysis/BFS.h"
 
 #include <cassert>
@@ -24,13 +26,24 @@ extern const Pointer UnknownPointer;
 
 class PointerSubgraph
 {
+public:
+    using NodesT = std::vector<ADT::ArenaPtr<PSNode>>;
+
+private:
     unsigned int dfsnum;
 
     // root of the pointer state subgraph
     PSNode *root;
 
-    using NodesT = std::vector<std::unique_ptr<PSNode>>;
+    // the numbering of nodes and pointers for the points-to sets
+    // of this graph and the kind of the sets
+    // (on heap, so that it does not move with the graph)
+    std::unique_ptr<PointerIdRegistry> idRegistry;
+
+    // the nodes are allocated in the arena and are destroyed
+    // before the arena goes away (see the destructor)
     NodesT nodes;
+    ADT::SizeClassArena arena;
 
     // Take care of assigning ids to new nodes
     unsigned int last_node_id = 0;
@@ -38,17 +51,29 @@ class PointerSubgraph
         return ++last_node_id;
     }
 
+    // construct the node in the arena (here, since the constructors
+    // of nodes are accessible only to PointerSubgraph)
+    template <typename T, typename... Args>
+    T *newNode(Args&&... args) {
+        static_assert(alignof(T) <= ADT::SizeClassArena::ALIGNMENT,
+                      "Unsupported alignment");
+        return new (arena.allocate(sizeof(T))) T(std::forward<Args>(args)...);
+    }
+
     GenericCallGraph<PSNode *> callGraph;
 
+    // the static nodes are shared by all graphs, so their sets
+    // do not depend on the registry or the kind of sets of this graph
     void initStaticNodes() {
-        NULLPTR->pointsTo.clear();
-        UNKNOWN_MEMORY->pointsTo.clear();
+        NULLPTR->pointsTo.makeShared();
+        UNKNOWN_MEMORY->pointsTo.makeShared();
         NULLPTR->pointsTo.add(Pointer(NULLPTR, 0));
         UNKNOWN_MEMORY->pointsTo.add(Pointer(UNKNOWN_MEMORY, Offset::UNKNOWN));
     }
 
 public:
-    PointerSubgraph() : dfsnum(0), root(nullptr) {
+    PointerSubgraph(PointsToSetKind kind = PointsToSetKind::OFFSETS_SET)
+    : dfsnum(0), root(nullptr), idRegistry(new PointerIdRegistry(kind)) {
         // nodes[0] represents invalid node (the node with id 0)
         nodes.emplace_back(nullptr);
         initStaticNodes();
@@ -63,6 +88,16 @@ public:
     const NodesT& getNodes() const { return nodes; }
     size_t size() const { return nodes.size(); }
 
+    // points-to sets created while this registry is active
+    // (see PointerIdRegistry::Scope) use the numbering of this graph
+    PointerIdRegistry *getIdRegistry() const { return idRegistry.get(); }
+    PointsToSetKind getPointsToSetKind() const { return idRegistry->getSetsKind(); }
+
+    ~PointerSubgraph() {
+        // destroy the nodes while the arena is alive
+        nodes.clear();
+    }
+
     PointerSubgraph(PointerSubgraph&&) = default;
     PointerSubgraph& operator=(PointerSubgraph&&) = default;
     PointerSubgraph(const PointerSubgraph&) = delete;
@@ -105,42 +140,52 @@ public:
         va_list args;
         PSNode *node = nullptr;
 
+        // NOTE: read the arguments into variables first,
+        // the order of evaluation of function arguments
+        // is unspecified
+        PSNode *op1, *op2;
+        Offset::type off;
+
+        // the points-to sets of the node belong to this graph
+        PointerIdRegistry::Scope scope(getIdRegistry());
+
         va_start(args, t);
         switch (t) {
             case PSNodeType::ALLOC:
             case PSNodeType::DYN_ALLOC:
-                node = new PSNodeAlloc(getNewNodeId(), t);
+                node = newNode<PSNodeAlloc>(getNewNodeId(), t);
                 break;
             case PSNodeType::GEP:
-                node = new PSNodeGep(getNewNodeId(),
-                                     va_arg(args, PSNode *),
-                                     va_arg(args, Offset::type));
+                op1 = va_arg(args, PSNode *);
+                off = va_arg(args, Offset::type);
+                node = newNode<PSNodeGep>(getNewNodeId(), op1, off);
                 break;
             case PSNodeType::MEMCPY:
-                node = new PSNodeMemcpy(getNewNodeId(),
-                                        va_arg(args, PSNode *),
-                                        va_arg(args, PSNode *),
-                                        va_arg(args, Offset::type));
+                op1 = va_arg(args, PSNode *);
+                op2 = va_arg(args, PSNode *);
+                off = va_arg(args, Offset::type);
+                node = newNode<PSNodeMemcpy>(getNewNodeId(), op1, op2, off);
                 break;
             case PSNodeType::CONSTANT:
-                node = new PSNode(getNewNodeId(), PSNodeType::CONSTANT,
-                                  va_arg(args, PSNode *),
-                                  va_arg(args, Offset::type));
+                op1 = va_arg(args, PSNode *);
+                off = va_arg(args, Offset::type);
+                node = newNode<PSNode>(getNewNodeId(), PSNodeType::CONSTANT,
+                                       op1, off);
                 break;
             case PSNodeType::ENTRY:
-                node = new PSNodeEntry(getNewNodeId());
+                node = newNode<PSNodeEntry>(getNewNodeId());
                 break;
             case PSNodeType::CALL:
-                node = new PSNodeCall(getNewNodeId());
+                node = newNode<PSNodeCall>(getNewNodeId());
                 break;
             case PSNodeType::FORK:
-                node = new PSNodeFork(getNewNodeId());
+                node = newNode<PSNodeFork>(getNewNodeId());
                 break;
             case PSNodeType::JOIN:
-                node = new PSNodeJoin(getNewNodeId());
+                node = newNode<PSNodeJoin>(getNewNodeId());
                 break;
             default:
-                node = new PSNode(getNewNodeId(), t, args);
+                node = newNode<PSNode>(getNewNodeId(), t, args);
                 break;
         }
         va_end(args);
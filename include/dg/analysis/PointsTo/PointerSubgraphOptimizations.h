@@ -1,6 +1,10 @@
 #ifndef _DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 #define _DG_POINTER_SUBGRAPH_OPTIMIZATIONS_H_
 
+#include <vector>
+#include <unordered_map>
+#include <utility>
+
 #include "PointsToMapping.h"
 
 namespace dg {
@@ -195,6 +199,168 @@ private:
     unsigned merged_nodes_num;
 };
 
+///
+// Offline hash-based value numbering: nodes that compute the same
+// value from the same operands (e.g. two GEPs with the same source
+// and offset or two casts of the same pointer) are guaranteed
+// to have the same points-to sets,
+// so we keep only one of them. Nodes are numbered by a key
+// built from their type, parameters and the (already merged)
+// operands; nodes with the same key are merged. Merging a node
+// changes the operands of its users, so the users are numbered again.
+//
+// Loads of the same pointer are equivalent only in the flow-insensitive
+// analysis, therefore merging loads must be requested explicitly.
+class PSValueNumberingMerger {
+public:
+    using MappingT = PointsToMapping<PSNode *>;
+
+    PSValueNumberingMerger(PointerSubgraph *S, bool mergeLoads = false)
+    : PS(S), merge_loads(mergeLoads) {}
+
+    MappingT& getMapping() { return mapping; }
+    const MappingT& getMapping() const { return mapping; }
+
+    unsigned getNumOfMergedNodes() const { return merged_nodes_num; }
+
+    unsigned run() {
+        // process the nodes in the order of IDs, so that the nodes
+        // created earlier become the representatives
+        std::vector<unsigned> worklist;
+        worklist.reserve(PS->size());
+        const auto& nodes = PS->getNodes();
+        for (auto I = nodes.rbegin(), E = nodes.rend(); I != E; ++I) {
+            if (*I)
+                worklist.push_back((*I)->getID());
+        }
+
+        while (!worklist.empty()) {
+            unsigned id = worklist.back();
+            worklist.pop_back();
+
+            PSNode *node = PS->getNodes()[id].get();
+            // already merged
+            if (!node || !canMerge(node))
+                continue;
+
+            // the operands of the node may have changed,
+            // forget the old key of the node
+            auto kit = node_keys.find(id);
+            if (kit != node_keys.end()) {
+                auto it = values.find(kit->second);
+                if (it != values.end() && it->second == node)
+                    values.erase(it);
+                node_keys.erase(kit);
+            }
+
+            KeyT key = getKey(node);
+            auto it = values.find(key);
+            if (it == values.end()) {
+                values.emplace(key, node);
+                node_keys.emplace(id, std::move(key));
+                continue;
+            }
+
+            PSNode *rep = it->second;
+            assert(rep != node);
+            // a renumbered user may come before an earlier node
+            // with the same key, keep the earlier node anyway
+            if (rep->getID() > id) {
+                std::swap(rep, node);
+                it->second = rep;
+                node_keys.erase(node->getID());
+                node_keys.emplace(id, std::move(key));
+            }
+
+            for (PSNode *user : node->getUsers())
+                worklist.push_back(user->getID());
+            merge(node, rep);
+        }
+
+        return merged_nodes_num;
+    }
+
+private:
+    using KeyT = std::vector<uint64_t>;
+
+    struct KeyHash {
+        size_t operator()(const KeyT& key) const {
+            size_t h = key.size();
+            for (uint64_t v : key)
+                h = h * 31 + std::hash<uint64_t>()(v);
+            return h;
+        }
+    };
+
+    bool canMerge(PSNode *node) const {
+        switch (node->getType()) {
+            case PSNodeType::GEP:
+            case PSNodeType::CAST:
+                return true;
+            case PSNodeType::CONSTANT:
+                return node->pointsTo.size() == 1;
+            case PSNodeType::LOAD:
+                return merge_loads;
+            default:
+                return false;
+        }
+    }
+
+    static KeyT getKey(PSNode *node) {
+        KeyT key{static_cast<uint64_t>(node->getType())};
+
+        if (PSNodeGep *gep = PSNodeGep::get(node)) {
+            key.push_back(*gep->getOffset());
+        } else if (node->getType() == PSNodeType::CONSTANT) {
+            const Pointer& ptr = *node->pointsTo.begin();
+            key.push_back(ptr.target->getID());
+            key.push_back(*ptr.offset);
+        }
+
+        for (PSNode *op : node->getOperands())
+            key.push_back(op->getID());
+
+        return key;
+    }
+
+    // merge node1 to node2 (the same as in PSEquivalentNodesMerger)
+    void merge(PSNode *node1, PSNode *node2) {
+        node1->replaceAllUsesWith(node2);
+        node1->removeAllOperands();
+        node1->isolate();
+        node_keys.erase(node1->getID());
+        PS->remove(node1);
+
+        // the nodes that were merged to node1 are now represented by node2
+        auto it = merged.find(node1);
+        if (it != merged.end()) {
+            auto& to = merged[node2];
+            for (PSNode *n : it->second) {
+                mapping.set(n, node2);
+                to.push_back(n);
+            }
+            merged.erase(node1);
+        }
+
+        mapping.add(node1, node2);
+        merged[node2].push_back(node1);
+
+        ++merged_nodes_num;
+    }
+
+    PointerSubgraph *PS;
+    const bool merge_loads;
+
+    std::unordered_map<KeyT, PSNode *, KeyHash> values;
+    // the current key of a node (indexed by ID)
+    std::unordered_map<unsigned, KeyT> node_keys;
+    // the nodes merged to the node
+    std::unordered_map<PSNode *, std::vector<PSNode *>> merged;
+    MappingT mapping;
+
+    unsigned merged_nodes_num{0};
+};
+
 class PointerSubgraphOptimizer {
     using MappingT = PointsToMapping<PSNode *>;
 
@@ -226,9 +392,22 @@ public:
         }
     }
 
+    // merge loads only for flow-insensitive analysis
+    void removeEquivalentValues(bool mergeLoads = false) {
+        PSValueNumberingMerger merger(PS, mergeLoads);
+        if (auto r = merger.run()) {
+            // the nodes we mapped to may have been merged
+            MappingT merged = merger.getMapping();
+            mapping.compose(std::move(merged));
+            mapping.merge(std::move(merger.getMapping()));
+            removed += r;
+        }
+    }
+
     unsigned run() {
         removeNoops();
         removeEquivalentNodes();
+        removeEquivalentValues();
         removeUnknowns();
         // need to call this once more because
         // the optimizations may have created
@@ -8,12 +8,18 @@
 #include "dg/analysis/PointsTo/PointsToSets/SmallOffsetsPointsToSet.h"
 #include "dg/analysis/PointsTo/PointsToSets/AlignedSmallOffsetsPointsToSet.h"
 #include "dg/analysis/PointsTo/PointsToSets/AlignedPointerIdPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/HybridPointerIdPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/InternedPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/BddPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/DynamicPointsToSet.h"
 
 namespace dg {
 namespace analysis {
 namespace pta {
 
-using PointsToSetT = OffsetsSetPointsToSet;
+// the implementation of the sets is selected at runtime
+// by the kind of the PointerSubgraph, see DynamicPointsToSet
+using PointsToSetT = DynamicPointsToSet;
 using PointsToMapT = std::map<Offset, PointsToSetT>;
 
 } // namespace pta
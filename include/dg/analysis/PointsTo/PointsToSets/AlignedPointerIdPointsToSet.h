@@ -2,10 +2,11 @@
 #define ALIGNEDBITVECTORPOINTSTOSET_H
 
 #include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
 #include "dg/ADT/Bitvector.h"
 
-#include <map>
 #include <vector>
+#include <utility>
 #include <set>
 #include <cassert>
 
@@ -21,17 +22,12 @@ class AlignedPointerIdPointsToSet {
 
     ADT::SparseBitvector pointers;
     std::set<Pointer> overflowSet;
-    static std::map<Pointer, size_t> ids; //pointers are numbered 1, 2, ...
-    static std::vector<Pointer> idVector; //starts from 0 (pointer = idVector[id - 1])
+    // the numbering of pointers in this set
+    PointerIdRegistry *registry{PointerIdRegistry::get()};
 
     //if the pointer doesn't have ID, it's assigned one
     size_t getPointerID(const Pointer& ptr) const {
-        auto it = ids.find(ptr);
-        if(it != ids.end()) {
-            return it->second;
-        }
-        idVector.push_back(ptr);
-        return ids.emplace_hint(it, ptr, ids.size() + 1)->second;
+        return registry->getPointerID(ptr);
     }
 
     bool addWithUnknownOffset(PSNode* node) {
@@ -65,6 +61,14 @@ public:
     }
 
     bool add(const AlignedPointerIdPointsToSet& S) {
+        if (S.registry != registry) {
+            // the sets are numbered differently
+            bool changed = false;
+            for (const auto& ptr : S)
+                changed |= add(ptr);
+            return changed;
+        }
+
         bool changed = pointers.set(S.pointers);
         for (const auto& ptr : S.overflowSet) {
             changed |= overflowSet.insert(ptr).second;
@@ -72,6 +76,14 @@ public:
         return changed;
     }
 
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
     bool remove(const Pointer& ptr) {
         if(isOffsetValid(ptr.offset)) {
             return pointers.unset(getPointerID(ptr));
@@ -84,15 +96,9 @@ public:
     }
 
     bool removeAny(PSNode *target) {
-        std::vector<size_t> toRemove;
-        for (const auto& ptrID : pointers) {
-            if(idVector[ptrID - 1].target == target) {
-                toRemove.push_back(ptrID);
-            }
-        }
-
-        for (auto ptrID : toRemove)  {
-            pointers.unset(ptrID);
+        bool removed = false;
+        for (auto ptrID : registry->getPointerIDs(target)) {
+            removed |= pointers.unset(ptrID);
         }
 
         bool changed = false;
@@ -106,7 +112,7 @@ public:
                 it++;
             }
         }
-        return changed || !toRemove.empty();
+        return changed || removed;
     }
 
     void clear() {
@@ -132,8 +138,8 @@ public:
     }
 
     bool pointsToTarget(PSNode *target) const {
-        for(const auto& kv : ids) {
-            if(kv.first.target == target && pointers.get(kv.second)) {
+        for(auto ptrID : registry->getPointerIDs(target)) {
+            if(pointers.get(ptrID)) {
                 return true;
             }
         }
@@ -181,6 +187,7 @@ public:
     void swap(AlignedPointerIdPointsToSet& rhs) {
         pointers.swap(rhs.pointers);
         overflowSet.swap(rhs.overflowSet);
+        std::swap(registry, rhs.registry);
     }
 
     size_t overflowSetSize() const {
@@ -197,12 +204,13 @@ public:
         typename ADT::SparseBitvector::const_iterator bitvector_end;
         typename std::set<Pointer>::const_iterator set_it;
         bool secondContainer;
+        const PointerIdRegistry *registry;
 
-        const_iterator(const ADT::SparseBitvector& pointers, const std::set<Pointer>& overflow, bool end = false) :
-        bitvector_it(end ? pointers.end() : pointers.begin()),
-        bitvector_end(pointers.end()),
-        set_it(end ? overflow.end() : overflow.begin()),
-        secondContainer(end) {
+        const_iterator(const AlignedPointerIdPointsToSet& S, bool end = false) :
+        bitvector_it(end ? S.pointers.end() : S.pointers.begin()),
+        bitvector_end(S.pointers.end()),
+        set_it(end ? S.overflowSet.end() : S.overflowSet.begin()),
+        secondContainer(end), registry(S.registry) {
             if(bitvector_it == bitvector_end) {
                 secondContainer = true;
             }
@@ -229,7 +237,7 @@ public:
 
         Pointer operator*() const {
             if(!secondContainer) {
-                return Pointer(idVector[*bitvector_it - 1]);
+                return registry->getPointer(*bitvector_it);
             }
             return *set_it;
         }
@@ -246,8 +254,8 @@ public:
         friend class AlignedPointerIdPointsToSet;
     };
 
-    const_iterator begin() const { return const_iterator(pointers, overflowSet); }
-    const_iterator end() const { return const_iterator(pointers, overflowSet, true /* end */); }
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
 
     friend class const_iterator;
 };
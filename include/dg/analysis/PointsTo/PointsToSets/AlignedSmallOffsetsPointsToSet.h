@@ -2,11 +2,12 @@
 #define ALIGNEDOFFSETSPOINTSTOSET_H
 
 #include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
 #include "dg/ADT/Bitvector.h"
 
-#include <map>
 #include <set>
 #include <vector>
+#include <utility>
 #include <cassert>
 
 namespace dg {
@@ -21,17 +22,12 @@ class AlignedSmallOffsetsPointsToSet {
 
     ADT::SparseBitvector pointers;
     std::set<Pointer> oddPointers;
-    static std::map<PSNode*,size_t> ids;  //nodes are numbered 1,2, ...
-    static std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
+    // the numbering of nodes in this set
+    PointerIdRegistry *registry{PointerIdRegistry::get()};
 
     //if the node doesn't have ID, it's assigned one
     size_t getNodeID(PSNode *node) const {
-        auto it = ids.find(node);
-        if(it != ids.end()) {
-            return it->second;
-        }
-        idVector.push_back(node);
-        return ids.emplace_hint(it, node, ids.size() + 1)->second;
+        return registry->getNodeID(node);
     }
 
     size_t getNodePosition(PSNode *node) const {
@@ -77,6 +73,14 @@ public:
     }
 
     bool add(const AlignedSmallOffsetsPointsToSet& S) {
+        if (S.registry != registry) {
+            // the sets are numbered differently
+            bool changed = false;
+            for (const auto& ptr : S)
+                changed |= add(ptr);
+            return changed;
+        }
+
         bool changed = pointers.set(S.pointers);
         for (const auto& ptr : S.oddPointers) {
             changed |= oddPointers.insert(ptr).second;
@@ -84,6 +88,14 @@ public:
         return changed;
     }
 
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
     bool remove(const Pointer& ptr) {
         if(isOffsetValid(ptr.offset)) {
             return pointers.unset(getPosition(ptr.target, ptr.offset));
@@ -186,6 +198,7 @@ public:
     void swap(AlignedSmallOffsetsPointsToSet& rhs) {
         pointers.swap(rhs.pointers);
         oddPointers.swap(rhs.oddPointers);
+        std::swap(registry, rhs.registry);
     }
 
     size_t overflowSetSize() const {
@@ -203,12 +216,13 @@ public:
         typename ADT::SparseBitvector::const_iterator bitvector_end;
         typename std::set<Pointer>::const_iterator set_it;
         bool secondContainer;
+        const PointerIdRegistry *registry;
 
-        const_iterator(const ADT::SparseBitvector& pointers, const std::set<Pointer>& oddPointers, bool end = false)
-        : bitvector_it(end ? pointers.end() : pointers.begin()),
-        bitvector_end(pointers.end()),
-        set_it(end ? oddPointers.end() : oddPointers.begin()),
-        secondContainer(end) {
+        const_iterator(const AlignedSmallOffsetsPointsToSet& S, bool end = false)
+        : bitvector_it(end ? S.pointers.end() : S.pointers.begin()),
+        bitvector_end(S.pointers.end()),
+        set_it(end ? S.oddPointers.end() : S.oddPointers.begin()),
+        secondContainer(end), registry(S.registry) {
             if(bitvector_it == bitvector_end) {
                 secondContainer = true;
             }
@@ -237,7 +251,7 @@ public:
             if(!secondContainer) {
                 size_t offsetPosition = (*bitvector_it % 64);
                 size_t nodeID = ((*bitvector_it - offsetPosition) / 64) + 1;
-                return offsetPosition == 63 ? Pointer(idVector[nodeID - 1], Offset::UNKNOWN) : Pointer(idVector[nodeID - 1], offsetPosition * multiplier);
+                return offsetPosition == 63 ? Pointer(registry->getNode(nodeID), Offset::UNKNOWN) : Pointer(registry->getNode(nodeID), offsetPosition * multiplier);
             }
             return *set_it;
         }
@@ -254,8 +268,8 @@ public:
         friend class AlignedSmallOffsetsPointsToSet;
     };
 
-    const_iterator begin() const { return const_iterator(pointers, oddPointers); }
-    const_iterator end() const { return const_iterator(pointers, oddPointers, true /* end */); }
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
 
     friend class const_iterator;
 };
@@ -0,0 +1,365 @@
+#ifndef BDDPOINTSTOSET_H
+#define BDDPOINTSTOSET_H
+
+#include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
+#include "dg/ADT/Bdd.h"
+
+#include <vector>
+#include <utility>
+#include <unordered_map>
+#include <cassert>
+#include <cstdint>
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+class PSNode;
+
+///
+// Points-to set represented as a BDD. A pointer is encoded
+// into two variable domains: the ID of the target (TARGET_BITS
+// variables) followed by the offset (OFFSET_BITS variables).
+// Unions and removing all pointers to a target are BDD operations,
+// so sets with many pointers that share structure (e.g. ranges
+// of targets or offsets) take little memory.
+// The sets with the same registry share one BDD manager,
+// it is owned by the registry and freed with it.
+class BddPointsToSet {
+    using NodeT = ADT::BddManager::NodeT;
+
+    enum : unsigned {
+        TARGET_BITS = 32,
+        OFFSET_BITS = 64,
+        VARS_NUM = TARGET_BITS + OFFSET_BITS
+    };
+
+    NodeT root{ADT::BddManager::ZERO};
+    // the size of the set with the root 'sizeOf'
+    mutable size_t cachedSize{0};
+    mutable NodeT sizeOf{ADT::BddManager::ZERO};
+
+    // the numbering of nodes in this set
+    PointerIdRegistry *registry{PointerIdRegistry::get()};
+
+    // the manager of the registry, created on the first use
+    static ADT::BddManager& getManager(PointerIdRegistry *registry) {
+        auto *&manager = registry->getBddManager();
+        if (!manager)
+            manager = new ADT::BddManager(VARS_NUM);
+        return *manager;
+    }
+
+    ADT::BddManager& bdd() const { return getManager(registry); }
+
+    //if the node doesn't have ID, it's assigned one
+    size_t getNodeID(PSNode *node) const {
+        return registry->getNodeID(node);
+    }
+
+    NodeT targetCube(PSNode *target) const {
+        return bdd().cube(0, TARGET_BITS, getNodeID(target));
+    }
+
+    NodeT pointerCube(const Pointer& ptr) const {
+        return bdd().cube(0, TARGET_BITS, getNodeID(ptr.target),
+                          bdd().cube(TARGET_BITS, OFFSET_BITS, *ptr.offset));
+    }
+
+    static bool getBit(size_t id, uint64_t offset, unsigned var) {
+        if (var < TARGET_BITS)
+            return (id >> (TARGET_BITS - 1 - var)) & 0x1;
+        return (offset >> (VARS_NUM - 1 - var)) & 0x1;
+    }
+
+    bool setRoot(NodeT n) {
+        if (n == root)
+            return false;
+        root = n;
+        return true;
+    }
+
+    bool addWithUnknownOffset(PSNode* target) {
+        NodeT n = bdd().bddDiff(root, targetCube(target));
+        n = bdd().bddOr(n, pointerCube({target, Offset::UNKNOWN}));
+        return setRoot(n);
+    }
+
+    // cnt * 2^bits (the skipped variables can have any value).
+    // The count of ZERO can be shifted by 64 or more bits,
+    // other counts do not overflow as no set holds 2^64 pointers.
+    static uint64_t shiftCount(uint64_t cnt, unsigned bits) {
+        if (cnt == 0)
+            return 0;
+        if (bits >= 64 || (cnt >> (63 - bits)) > 1) {
+            assert(false && "The size of the set overflows");
+            return ~static_cast<uint64_t>(0);
+        }
+        return cnt << bits;
+    }
+
+    // the number of assignments to variables var(n), ..., VARS_NUM - 1
+    // that satisfy n
+    uint64_t satCount(NodeT n, std::unordered_map<NodeT, uint64_t>& memo) const {
+        if (n == ADT::BddManager::ZERO)
+            return 0;
+        if (n == ADT::BddManager::ONE)
+            return 1;
+
+        auto it = memo.find(n);
+        if (it != memo.end())
+            return it->second;
+
+        const auto& manager = bdd();
+        auto var = manager.getVar(n);
+        auto low = manager.getLow(n), high = manager.getHigh(n);
+        uint64_t cnt = shiftCount(satCount(low, memo), manager.getVar(low) - var - 1)
+                       + shiftCount(satCount(high, memo), manager.getVar(high) - var - 1);
+        memo.emplace(n, cnt);
+        return cnt;
+    }
+
+public:
+    BddPointsToSet() = default;
+    BddPointsToSet(std::initializer_list<Pointer> elems) { add(elems); }
+
+    bool add(PSNode *target, Offset off) {
+        return add(Pointer(target,off));
+    }
+
+    bool add(const Pointer& ptr) {
+        if(has({ptr.target, Offset::UNKNOWN})) {
+            return false;
+        }
+        if(ptr.offset.isUnknown()) {
+            return addWithUnknownOffset(ptr.target);
+        }
+        return setRoot(bdd().bddOr(root, pointerCube(ptr)));
+    }
+
+    bool add(const BddPointsToSet& S) {
+        if (S.registry != registry) {
+            // the sets are numbered differently
+            bool changed = false;
+            for (const auto& ptr : S)
+                changed |= add(ptr);
+            return changed;
+        }
+
+        return setRoot(bdd().bddOr(root, S.root));
+    }
+
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
+    bool remove(const Pointer& ptr) {
+        return setRoot(bdd().bddDiff(root, pointerCube(ptr)));
+    }
+
+    bool remove(PSNode *target, Offset offset) {
+        return remove(Pointer(target,offset));
+    }
+
+    bool removeAny(PSNode *target) {
+        return setRoot(bdd().bddDiff(root, targetCube(target)));
+    }
+
+    void clear() {
+        root = ADT::BddManager::ZERO;
+    }
+
+    bool pointsTo(const Pointer& ptr) const {
+        auto id = getNodeID(ptr.target);
+        const auto& manager = bdd();
+        NodeT n = root;
+        while (manager.getVar(n) < VARS_NUM) {
+            n = getBit(id, *ptr.offset, manager.getVar(n)) ?
+                    manager.getHigh(n) : manager.getLow(n);
+        }
+        return n == ADT::BddManager::ONE;
+    }
+
+    bool mayPointTo(const Pointer& ptr) const {
+        return pointsTo(ptr)
+                || pointsTo(Pointer(ptr.target, Offset::UNKNOWN));
+    }
+
+    bool mustPointTo(const Pointer& ptr) const {
+        assert(!ptr.offset.isUnknown() && "Makes no sense");
+        return pointsTo(ptr) && isSingleton();
+    }
+
+    bool pointsToTarget(PSNode *target) const {
+        auto id = getNodeID(target);
+        const auto& manager = bdd();
+        NodeT n = root;
+        while (manager.getVar(n) < TARGET_BITS) {
+            n = getBit(id, 0, manager.getVar(n)) ?
+                    manager.getHigh(n) : manager.getLow(n);
+        }
+        return n != ADT::BddManager::ZERO;
+    }
+
+    bool isSingleton() const {
+        return size() == 1;
+    }
+
+    bool empty() const {
+        return root == ADT::BddManager::ZERO;
+    }
+
+    size_t count(const Pointer& ptr) const {
+        return pointsTo(ptr);
+    }
+
+    bool has(const Pointer& ptr) const {
+        return count(ptr) > 0;
+    }
+
+    bool hasUnknown() const {
+        return pointsToTarget(UNKNOWN_MEMORY);
+    }
+
+    bool hasNull() const {
+        return pointsToTarget(NULLPTR);
+    }
+
+    bool hasInvalidated() const {
+        return pointsToTarget(INVALIDATED);
+    }
+
+    size_t size() const {
+        if (sizeOf != root) {
+            std::unordered_map<NodeT, uint64_t> memo;
+            cachedSize = shiftCount(satCount(root, memo), bdd().getVar(root));
+            sizeOf = root;
+        }
+        return cachedSize;
+    }
+
+    void swap(BddPointsToSet& rhs) {
+        std::swap(root, rhs.root);
+        std::swap(cachedSize, rhs.cachedSize);
+        std::swap(sizeOf, rhs.sizeOf);
+        std::swap(registry, rhs.registry);
+    }
+
+    // the number of nodes in the BDD manager of the set
+    size_t getBddNodesNum() const { return bdd().getNodesNum(); }
+
+    ///
+    // Iterates over the satisfying assignments
+    // in the order of (target ID, offset)
+    class const_iterator {
+        // the current assignment
+        size_t id{0};
+        uint64_t offset{0};
+        // the node that decides the value of each variable
+        // on the current path
+        NodeT path[VARS_NUM];
+        bool atEnd{true};
+        const PointerIdRegistry *registry;
+        const ADT::BddManager *bdd;
+
+        void setBit(unsigned var, bool val) {
+            if (var < TARGET_BITS) {
+                size_t mask = static_cast<size_t>(1) << (TARGET_BITS - 1 - var);
+                id = val ? (id | mask) : (id & ~mask);
+            } else {
+                uint64_t mask = static_cast<uint64_t>(1) << (VARS_NUM - 1 - var);
+                offset = val ? (offset | mask) : (offset & ~mask);
+            }
+        }
+
+        // find the least assignment of variables var, var + 1, ...
+        // that satisfies n
+        void descend(unsigned var, NodeT n) {
+            for (; var < VARS_NUM; ++var) {
+                path[var] = n;
+                if (bdd->getVar(n) == var) {
+                    if (bdd->getLow(n) != ADT::BddManager::ZERO) {
+                        setBit(var, false);
+                        n = bdd->getLow(n);
+                    } else {
+                        setBit(var, true);
+                        n = bdd->getHigh(n);
+                    }
+                } else {
+                    // the variable is not constrained
+                    setBit(var, false);
+                }
+            }
+            assert(n == ADT::BddManager::ONE);
+        }
+
+        const_iterator(const BddPointsToSet& S, bool end = false)
+        : atEnd(end), registry(S.registry), bdd(&S.bdd()) {
+            NodeT root = S.root;
+            if (root == ADT::BddManager::ZERO)
+                atEnd = true;
+            if (!atEnd)
+                descend(0, root);
+        }
+
+    public:
+        const_iterator& operator++() {
+            assert(!atEnd && "operator++ called on end");
+            // find the last variable that is 0 and can be 1
+            for (unsigned var = VARS_NUM; var-- > 0;) {
+                if (getBit(id, offset, var))
+                    continue;
+
+                NodeT n = path[var];
+                NodeT next = bdd->getVar(n) == var ? bdd->getHigh(n) : n;
+                if (next != ADT::BddManager::ZERO) {
+                    setBit(var, true);
+                    descend(var + 1, next);
+                    return *this;
+                }
+            }
+
+            atEnd = true;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        Pointer operator*() const {
+            assert(!atEnd);
+            return Pointer(registry->getNode(id), offset);
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            if (atEnd || rhs.atEnd)
+                return atEnd == rhs.atEnd;
+            return id == rhs.id && offset == rhs.offset;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class BddPointsToSet;
+    };
+
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
+
+    friend class const_iterator;
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif /* BDDPOINTSTOSET_H */
@@ -0,0 +1,457 @@
+#ifndef DYNAMICPOINTSTOSET_H
+#define DYNAMICPOINTSTOSET_H
+
+#include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
+#include "dg/analysis/PointsTo/PointsToSets/PointsToSetKind.h"
+#include "dg/analysis/PointsTo/PointsToSets/OffsetsSetPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/SimplePointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/SeparateOffsetsPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/PointerIdPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/SmallOffsetsPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/AlignedSmallOffsetsPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/AlignedPointerIdPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/HybridPointerIdPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/InternedPointsToSet.h"
+#include "dg/analysis/PointsTo/PointsToSets/BddPointsToSet.h"
+
+#include <new>
+#include <string>
+#include <utility>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+// Run the statements (the variadic argument) with 'S' bound
+// to the set (or iterator) of the type given by KIND.
+// GET is a member template that returns the object of the given type.
+#define DG_PTSET_DISPATCH(KIND, GET, ...)                                       \
+    switch (KIND) {                                                             \
+        case PointsToSetKind::OFFSETS_SET:                                      \
+            { auto& S = GET<OffsetsSetPointsToSet>(); __VA_ARGS__; }            \
+        case PointsToSetKind::SIMPLE:                                           \
+            { auto& S = GET<SimplePointsToSet>(); __VA_ARGS__; }                \
+        case PointsToSetKind::SEPARATE_OFFSETS:                                 \
+            { auto& S = GET<SeparateOffsetsPointsToSet>(); __VA_ARGS__; }       \
+        case PointsToSetKind::POINTER_ID:                                       \
+            { auto& S = GET<PointerIdPointsToSet>(); __VA_ARGS__; }             \
+        case PointsToSetKind::SMALL_OFFSETS:                                    \
+            { auto& S = GET<SmallOffsetsPointsToSet>(); __VA_ARGS__; }          \
+        case PointsToSetKind::ALIGNED_SMALL_OFFSETS:                            \
+            { auto& S = GET<AlignedSmallOffsetsPointsToSet>(); __VA_ARGS__; }   \
+        case PointsToSetKind::ALIGNED_POINTER_ID:                               \
+            { auto& S = GET<AlignedPointerIdPointsToSet>(); __VA_ARGS__; }      \
+        case PointsToSetKind::HYBRID_POINTER_ID:                                \
+            { auto& S = GET<HybridPointerIdPointsToSet>(); __VA_ARGS__; }       \
+        case PointsToSetKind::INTERNED:                                         \
+            { auto& S = GET<InternedPointsToSet>(); __VA_ARGS__; }              \
+        case PointsToSetKind::BDD:                                              \
+            { auto& S = GET<BddPointsToSet>(); __VA_ARGS__; }                   \
+    }                                                                           \
+    assert(false && "Unknown kind of points-to set");                           \
+    abort();
+
+///
+// Points-to set whose implementation is chosen at runtime.
+// The kind of a new set is the kind of the active PointerIdRegistry,
+// that is, the kind of the PointerSubgraph that the set belongs to,
+// so all sets in the analysis have the same kind. The operations
+// on two sets require the sets to be of the same kind, except
+// for the shared sets (see makeShared()) that can be added to sets
+// of any kind.
+// The operations are forwarded to the implementation by a switch
+// on the kind, so selecting the representation does not need
+// recompiling the analyses.
+class DynamicPointsToSet {
+    // the implementations that fit into the storage are stored inline,
+    // the larger ones are allocated on the heap, so that the set
+    // is not much larger than the default implementation
+    using StorageT = typename std::aligned_union<0,
+                                    OffsetsSetPointsToSet,
+                                    SimplePointsToSet,
+                                    PointerIdPointsToSet,
+                                    InternedPointsToSet,
+                                    BddPointsToSet,
+                                    void *>::type;
+
+    template <typename SetT>
+    using IsInline = std::integral_constant<bool,
+                                            sizeof(SetT) <= sizeof(StorageT) &&
+                                            alignof(SetT) <= alignof(StorageT)>;
+
+    PointsToSetKind kind;
+    // the set does not belong to any graph (see makeShared())
+    bool shared{false};
+    StorageT storage;
+
+    template <typename SetT>
+    SetT *ptr(std::true_type) { return reinterpret_cast<SetT *>(&storage); }
+    template <typename SetT>
+    SetT *ptr(std::false_type) { return *reinterpret_cast<SetT **>(&storage); }
+
+    template <typename SetT>
+    SetT& get() { return *ptr<SetT>(IsInline<SetT>()); }
+    template <typename SetT>
+    const SetT& get() const {
+        return const_cast<DynamicPointsToSet *>(this)->get<SetT>();
+    }
+
+    template <typename SetT, typename... Args>
+    void constructIn(std::true_type, Args&&... args) {
+        new (&storage) SetT(std::forward<Args>(args)...);
+    }
+    template <typename SetT, typename... Args>
+    void constructIn(std::false_type, Args&&... args) {
+        *reinterpret_cast<SetT **>(&storage) = new SetT(std::forward<Args>(args)...);
+    }
+
+    template <typename SetT, typename... Args>
+    void construct(Args&&... args) {
+        constructIn<SetT>(IsInline<SetT>(), std::forward<Args>(args)...);
+    }
+
+    template <typename SetT>
+    void destroyIn(SetT& S, std::true_type) { S.~SetT(); }
+    template <typename SetT>
+    void destroyIn(SetT& S, std::false_type) { delete &S; }
+
+    template <typename SetT>
+    void destroy(SetT& S) { destroyIn(S, IsInline<SetT>()); }
+
+    // the type of the implementation for the dispatch
+    // when the set is not constructed yet
+    template <typename SetT>
+    struct Tag { using type = SetT; };
+    template <typename SetT>
+    static Tag<SetT>& tag() { static Tag<SetT> t; return t; }
+
+    void constructDefault() {
+        DG_PTSET_DISPATCH(kind, tag,
+            construct<typename std::remove_reference<decltype(S)>::type::type>();
+            return)
+    }
+
+    void destroy() {
+        DG_PTSET_DISPATCH(kind, get, destroy(S); return)
+    }
+
+    // the kind of this set must be set already
+    void copyFrom(const DynamicPointsToSet& rhs) {
+        assert(kind == rhs.kind);
+        DG_PTSET_DISPATCH(kind, rhs.get,
+            construct<typename std::decay<decltype(S)>::type>(S);
+            return)
+    }
+
+    void moveFrom(DynamicPointsToSet& rhs) {
+        assert(kind == rhs.kind);
+        DG_PTSET_DISPATCH(kind, rhs.get,
+            construct<typename std::decay<decltype(S)>::type>(std::move(S));
+            return)
+    }
+
+public:
+    // the names of the kinds as used in the command-line options
+    static const char *getKindName(PointsToSetKind k) {
+        switch (k) {
+            case PointsToSetKind::OFFSETS_SET: return "offsets-set";
+            case PointsToSetKind::SIMPLE: return "simple";
+            case PointsToSetKind::SEPARATE_OFFSETS: return "separate-offsets";
+            case PointsToSetKind::POINTER_ID: return "pointer-id";
+            case PointsToSetKind::SMALL_OFFSETS: return "small-offsets";
+            case PointsToSetKind::ALIGNED_SMALL_OFFSETS: return "aligned-small-offsets";
+            case PointsToSetKind::ALIGNED_POINTER_ID: return "aligned-pointer-id";
+            case PointsToSetKind::HYBRID_POINTER_ID: return "hybrid";
+            case PointsToSetKind::INTERNED: return "interned";
+            case PointsToSetKind::BDD: return "bdd";
+        }
+        return "unknown";
+    }
+
+    // returns false if there is no kind with the given name
+    static bool getKindByName(const char *name, PointsToSetKind& k) {
+        for (unsigned i = 0; i <= static_cast<unsigned>(PointsToSetKind::BDD); ++i) {
+            auto cur = static_cast<PointsToSetKind>(i);
+            if (strcmp(getKindName(cur), name) == 0) {
+                k = cur;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    DynamicPointsToSet()
+    : kind(PointerIdRegistry::get()->getSetsKind()) { constructDefault(); }
+    DynamicPointsToSet(std::initializer_list<Pointer> elems)
+    : DynamicPointsToSet() { add(elems); }
+
+    DynamicPointsToSet(const DynamicPointsToSet& rhs)
+    : kind(rhs.kind), shared(rhs.shared) { copyFrom(rhs); }
+    DynamicPointsToSet(DynamicPointsToSet&& rhs)
+    : kind(rhs.kind), shared(rhs.shared) { moveFrom(rhs); }
+
+    // assignment does not change the kind of the set
+    // (the kind is taken from rhs only if the kinds differ,
+    // which is an error caught by the assertion)
+    DynamicPointsToSet& operator=(const DynamicPointsToSet& rhs) {
+        assert(kind == rhs.kind && "Assigning a set of a different kind");
+        if (&rhs != this) {
+            destroy();
+            kind = rhs.kind;
+            copyFrom(rhs);
+        }
+        return *this;
+    }
+
+    DynamicPointsToSet& operator=(DynamicPointsToSet&& rhs) {
+        assert(kind == rhs.kind && "Assigning a set of a different kind");
+        if (&rhs != this) {
+            destroy();
+            kind = rhs.kind;
+            moveFrom(rhs);
+        }
+        return *this;
+    }
+
+    ~DynamicPointsToSet() { destroy(); }
+
+    PointsToSetKind getKind() const { return kind; }
+
+    ///
+    // Clear the set and make it shared by all graphs, whatever
+    // the kind of their sets is (used for the sets of the static nodes
+    // like NULLPTR). The set gets a kind that does not number
+    // the pointers in any registry and can be added to sets of any kind.
+    void makeShared() {
+        clear(PointsToSetKind::OFFSETS_SET);
+        shared = true;
+    }
+
+    bool isShared() const { return shared; }
+
+    bool add(PSNode *target, Offset off) {
+        return add(Pointer(target, off));
+    }
+
+    bool add(const Pointer& ptr) {
+        DG_PTSET_DISPATCH(kind, get, return S.add(ptr))
+    }
+
+    bool add(const DynamicPointsToSet& rhs) {
+        if (kind != rhs.kind) {
+            assert(rhs.shared && "Adding a set of a different kind");
+            bool changed = false;
+            for (const auto& ptr : rhs)
+                changed |= add(ptr);
+            return changed;
+        }
+
+        DG_PTSET_DISPATCH(kind, get,
+            return S.add(rhs.get<typename std::remove_reference<decltype(S)>::type>()))
+    }
+
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
+    bool remove(const Pointer& ptr) {
+        DG_PTSET_DISPATCH(kind, get, return S.remove(ptr))
+    }
+
+    bool remove(PSNode *target, Offset offset) {
+        return remove(Pointer(target, offset));
+    }
+
+    bool removeAny(PSNode *target) {
+        DG_PTSET_DISPATCH(kind, get, return S.removeAny(target))
+    }
+
+    void clear() { clear(kind); }
+
+    // clear the set and change its implementation to the given kind
+    void clear(PointsToSetKind k) {
+        destroy();
+        kind = k;
+        constructDefault();
+    }
+
+    bool pointsTo(const Pointer& ptr) const {
+        DG_PTSET_DISPATCH(kind, get, return S.pointsTo(ptr))
+    }
+
+    bool mayPointTo(const Pointer& ptr) const {
+        DG_PTSET_DISPATCH(kind, get, return S.mayPointTo(ptr))
+    }
+
+    bool mustPointTo(const Pointer& ptr) const {
+        DG_PTSET_DISPATCH(kind, get, return S.mustPointTo(ptr))
+    }
+
+    bool pointsToTarget(PSNode *target) const {
+        DG_PTSET_DISPATCH(kind, get, return S.pointsToTarget(target))
+    }
+
+    bool isSingleton() const {
+        DG_PTSET_DISPATCH(kind, get, return S.isSingleton())
+    }
+
+    bool empty() const {
+        DG_PTSET_DISPATCH(kind, get, return S.empty())
+    }
+
+    size_t count(const Pointer& ptr) const {
+        DG_PTSET_DISPATCH(kind, get, return S.count(ptr))
+    }
+
+    bool has(const Pointer& ptr) const {
+        return count(ptr) > 0;
+    }
+
+    bool hasUnknown() const {
+        DG_PTSET_DISPATCH(kind, get, return S.hasUnknown())
+    }
+
+    bool hasNull() const {
+        DG_PTSET_DISPATCH(kind, get, return S.hasNull())
+    }
+
+    bool hasInvalidated() const {
+        DG_PTSET_DISPATCH(kind, get, return S.hasInvalidated())
+    }
+
+    size_t size() const {
+        DG_PTSET_DISPATCH(kind, get, return S.size())
+    }
+
+    void swap(DynamicPointsToSet& rhs) {
+        assert(kind == rhs.kind && "Swapping sets of different kinds");
+        if (kind != rhs.kind) {
+            DynamicPointsToSet tmp(std::move(rhs));
+            rhs.destroy();
+            rhs.kind = kind;
+            rhs.moveFrom(*this);
+            destroy();
+            kind = tmp.kind;
+            moveFrom(tmp);
+            return;
+        }
+
+        DG_PTSET_DISPATCH(kind, get,
+            S.swap(rhs.get<typename std::remove_reference<decltype(S)>::type>());
+            return)
+    }
+
+    class const_iterator {
+        using StorageT = typename std::aligned_union<0,
+                            OffsetsSetPointsToSet::const_iterator,
+                            SimplePointsToSet::const_iterator,
+                            SeparateOffsetsPointsToSet::const_iterator,
+                            PointerIdPointsToSet::const_iterator,
+                            SmallOffsetsPointsToSet::const_iterator,
+                            AlignedSmallOffsetsPointsToSet::const_iterator,
+                            AlignedPointerIdPointsToSet::const_iterator,
+                            HybridPointerIdPointsToSet::const_iterator,
+                            InternedPointsToSet::const_iterator,
+                            BddPointsToSet::const_iterator>::type;
+
+        PointsToSetKind kind;
+        StorageT storage;
+
+        // the iterator of the set of type SetT
+        template <typename SetT>
+        typename SetT::const_iterator& it() {
+            return *reinterpret_cast<typename SetT::const_iterator *>(&storage);
+        }
+
+        template <typename SetT>
+        const typename SetT::const_iterator& it() const {
+            return *reinterpret_cast<const typename SetT::const_iterator *>(&storage);
+        }
+
+        // this iterator as the implementation's iterator of the given type
+        template <typename ItT>
+        const ItT& sameAs(const ItT&) const {
+            return *reinterpret_cast<const ItT *>(&storage);
+        }
+
+        template <typename ItT>
+        void construct(const ItT& from) { new (&storage) ItT(from); }
+        template <typename ItT>
+        void destroy(ItT& I) { I.~ItT(); }
+
+        void destroy() {
+            DG_PTSET_DISPATCH(kind, it, destroy(S); return)
+        }
+
+        void copyFrom(const const_iterator& rhs) {
+            kind = rhs.kind;
+            DG_PTSET_DISPATCH(kind, rhs.it, construct(S); return)
+        }
+
+        const_iterator(const DynamicPointsToSet& set, bool end = false)
+        : kind(set.kind) {
+            DG_PTSET_DISPATCH(kind, set.get,
+                construct(end ? S.end() : S.begin()); return)
+        }
+
+    public:
+        const_iterator(const const_iterator& rhs) { copyFrom(rhs); }
+        const_iterator& operator=(const const_iterator& rhs) {
+            if (&rhs != this) {
+                destroy();
+                copyFrom(rhs);
+            }
+            return *this;
+        }
+
+        ~const_iterator() { destroy(); }
+
+        const_iterator& operator++() {
+            DG_PTSET_DISPATCH(kind, it, ++S; return *this)
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        Pointer operator*() const {
+            DG_PTSET_DISPATCH(kind, it, return *S)
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            assert(kind == rhs.kind && "Comparing iterators of different sets");
+            DG_PTSET_DISPATCH(kind, it,
+                return S == rhs.sameAs(S))
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class DynamicPointsToSet;
+    };
+
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
+
+    friend class const_iterator;
+};
+
+#undef DG_PTSET_DISPATCH
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif /* DYNAMICPOINTSTOSET_H */
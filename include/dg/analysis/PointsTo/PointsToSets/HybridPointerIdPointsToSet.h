@@ -0,0 +1,213 @@
+#ifndef HYBRIDPOINTERIDPOINTSTOSET_H
+#define HYBRIDPOINTERIDPOINTSTOSET_H
+
+#include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
+#include "dg/ADT/HybridBitvector.h"
+
+#include <vector>
+#include <utility>
+#include <cassert>
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+class PSNode;
+
+// Like PointerIdPointsToSet, but the IDs are kept in HybridBitvector
+// that switches from a small array to a sparse and then to a dense
+// bitvector as the set grows. Unions of dense sets are vectorized.
+class HybridPointerIdPointsToSet {
+
+    ADT::HybridBitvector pointers;
+    // the numbering of pointers in this set
+    PointerIdRegistry *registry{PointerIdRegistry::get()};
+
+    //if the pointer doesn't have ID, it's assigned one
+    size_t getPointerID(const Pointer& ptr) const {
+        return registry->getPointerID(ptr);
+    }
+
+    bool addWithUnknownOffset(PSNode* node) {
+        removeAny(node);
+        return !pointers.set(getPointerID({node, Offset::UNKNOWN}));
+    }
+
+public:
+    HybridPointerIdPointsToSet() = default;
+    HybridPointerIdPointsToSet(std::initializer_list<Pointer> elems) { add(elems); }
+
+    bool add(PSNode *target, Offset off) {
+        return add(Pointer(target,off));
+    }
+
+    bool add(const Pointer& ptr) {
+        if(has({ptr.target, Offset::UNKNOWN})) {
+            return false;
+        }
+        if(ptr.offset.isUnknown()) {
+            return addWithUnknownOffset(ptr.target);
+        }
+        return !pointers.set(getPointerID(ptr));
+    }
+
+    bool add(const HybridPointerIdPointsToSet& S) {
+        if (S.registry != registry) {
+            // the sets are numbered differently
+            bool changed = false;
+            for (const auto& ptr : S)
+                changed |= add(ptr);
+            return changed;
+        }
+
+        return pointers.set(S.pointers);
+    }
+
+    // keep only the pointers that are also in S
+    bool intersect(const HybridPointerIdPointsToSet& S) {
+        assert(S.registry == registry && "The sets are numbered differently");
+        return pointers.intersect(S.pointers);
+    }
+
+    bool isSubsetOf(const HybridPointerIdPointsToSet& S) const {
+        assert(S.registry == registry && "The sets are numbered differently");
+        return pointers.isSubsetOf(S.pointers);
+    }
+
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
+    bool remove(const Pointer& ptr) {
+        return pointers.unset(getPointerID(ptr));
+    }
+
+    bool remove(PSNode *target, Offset offset) {
+        return remove(Pointer(target,offset));
+    }
+
+    bool removeAny(PSNode *target) {
+        bool removed = false;
+        for (auto ptrID : registry->getPointerIDs(target)) {
+            removed |= pointers.unset(ptrID);
+        }
+        return removed;
+    }
+
+    void clear() {
+        pointers.reset();
+    }
+
+    bool pointsTo(const Pointer& ptr) const {
+        return pointers.get(getPointerID(ptr));
+    }
+
+    bool mayPointTo(const Pointer& ptr) const {
+        return pointsTo(ptr)
+                || pointsTo(Pointer(ptr.target, Offset::UNKNOWN));
+    }
+
+    bool mustPointTo(const Pointer& ptr) const {
+        assert(!ptr.offset.isUnknown() && "Makes no sense");
+        return pointsTo(ptr) && isSingleton();
+    }
+
+    bool pointsToTarget(PSNode *target) const {
+        for(auto ptrID : registry->getPointerIDs(target)) {
+            if(pointers.get(ptrID)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isSingleton() const {
+        return pointers.size() == 1;
+    }
+
+    bool empty() const {
+        return pointers.empty();
+    }
+
+    size_t count(const Pointer& ptr) const {
+        return pointsTo(ptr);
+    }
+
+    bool has(const Pointer& ptr) const {
+        return count(ptr) > 0;
+    }
+
+    bool hasUnknown() const {
+        return pointsToTarget(UNKNOWN_MEMORY);
+    }
+
+    bool hasNull() const {
+        return pointsToTarget(NULLPTR);
+
+    }
+
+    bool hasInvalidated() const {
+        return pointsToTarget(INVALIDATED);
+    }
+
+    size_t size() const {
+        return pointers.size();
+    }
+
+    void swap(HybridPointerIdPointsToSet& rhs) {
+        pointers.swap(rhs.pointers);
+        std::swap(registry, rhs.registry);
+    }
+
+    class const_iterator {
+
+        typename ADT::HybridBitvector::const_iterator container_it;
+        const PointerIdRegistry *registry;
+
+        const_iterator(const HybridPointerIdPointsToSet& S, bool end = false) :
+        container_it(end ? S.pointers.end() : S.pointers.begin()),
+        registry(S.registry) {}
+
+    public:
+        const_iterator& operator++() {
+            container_it++;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        Pointer operator*() const {
+            return registry->getPointer(*container_it);
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            return container_it == rhs.container_it;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class HybridPointerIdPointsToSet;
+    };
+
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
+
+    friend class const_iterator;
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif /* HYBRIDPOINTERIDPOINTSTOSET_H */
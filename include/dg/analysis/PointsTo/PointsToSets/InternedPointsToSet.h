@@ -0,0 +1,505 @@
+#ifndef INTERNEDPOINTSTOSET_H
+#define INTERNEDPOINTSTOSET_H
+
+#include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
+#include "dg/ADT/Bitvector.h"
+
+#include <vector>
+#include <utility>
+#include <deque>
+#include <unordered_map>
+#include <cassert>
+#include <cstdint>
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+class PSNode;
+
+///
+// Pool of canonical (hash-consed) immutable sets of pointer IDs
+// of one PointerIdRegistry. Every distinct set is stored only once
+// and it is referred to by a 32-bit handle. The handle 0 is the empty set.
+// The handles are reference counted, a set is released when no
+// points-to set refers to it (so the intermediate sets created while
+// a set grows do not stay in the pool) and its handle is reused.
+// The results of unions and of adding a single pointer are memoized,
+// so repeated merges of the same sets are O(1). The memo tables are
+// cleared when they get much bigger than the number of the sets.
+//
+// The pool is owned by its registry and by the points-to sets that use
+// it, it is deleted when the registry and all the sets are gone.
+class PointsToSetsPool {
+public:
+    using HandleT = uint32_t;
+    using BitsT = ADT::SparseBitvector;
+
+private:
+    struct Entry {
+        BitsT bits;
+        size_t hash{0};
+        // the number of handles to this set that are in use
+        unsigned refs{0};
+        // incremented when the handle is reused for another set,
+        // so that memoized results of released sets are not used
+        unsigned generation{0};
+    };
+
+    // the result of a memoized operation with the generations
+    // of the operands and of the result at the time of the operation
+    struct Memo {
+        HandleT result;
+        unsigned genA, genB, genResult;
+    };
+
+    PointerIdRegistry *registry;
+    // the number of points-to sets that use this pool
+    size_t users{0};
+
+    // handle -> canonical set. Deque does not move the sets
+    // when it grows, so iterators of a set stay valid
+    // while other sets are being created
+    std::deque<Entry> sets{Entry()};
+    std::vector<HandleT> freeHandles;
+    // hash of a set -> handles of the sets with this hash
+    std::unordered_multimap<size_t, HandleT> table;
+    // (handle, handle) -> handle of their union
+    std::unordered_map<uint64_t, Memo> unions;
+    // (handle, pointer ID) -> handle of the set with the pointer added
+    std::unordered_map<uint64_t, Memo> adds;
+
+    static uint64_t key(uint64_t a, uint64_t b) {
+        assert(a <= UINT32_MAX && b <= UINT32_MAX);
+        return (a << 32) | b;
+    }
+
+    Memo memo(HandleT a, unsigned genB, HandleT result) const {
+        return {result, sets[a].generation, genB, sets[result].generation};
+    }
+
+    // the memoized result if all the sets involved are still the same
+    bool lookup(std::unordered_map<uint64_t, Memo>& memos, uint64_t k,
+                HandleT a, unsigned genB, HandleT& result) {
+        auto it = memos.find(k);
+        if (it == memos.end())
+            return false;
+
+        const Memo& m = it->second;
+        if (m.genA != sets[a].generation || m.genB != genB ||
+            m.genResult != sets[m.result].generation) {
+            memos.erase(it);
+            return false;
+        }
+
+        result = m.result;
+        return true;
+    }
+
+    void remember(std::unordered_map<uint64_t, Memo>& memos,
+                  uint64_t k, const Memo& m) {
+        // most of the memoized results refer to released sets
+        if (memos.size() > 4 * (sets.size() - freeHandles.size()) + 1024)
+            memos.clear();
+        memos[k] = m;
+    }
+
+    void releaseSet(HandleT h) {
+        Entry& E = sets[h];
+        auto range = table.equal_range(E.hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == h) {
+                table.erase(it);
+                break;
+            }
+        }
+
+        E.bits = BitsT();
+        ++E.generation;
+        freeHandles.push_back(h);
+    }
+
+    PointsToSetsPool(PointerIdRegistry *r) : registry(r) {
+        table.emplace(sets[0].bits.hash(), 0);
+    }
+
+    // returns true if the pool is not used anymore
+    bool removeUser() {
+        assert(users > 0);
+        --users;
+        return users == 0 && !registry;
+    }
+
+public:
+    PointsToSetsPool(const PointsToSetsPool&) = delete;
+    PointsToSetsPool& operator=(const PointsToSetsPool&) = delete;
+
+    // the pool of the registry, created on the first use
+    static PointsToSetsPool *get(PointerIdRegistry *registry) {
+        auto *&pool = registry->getSetsPool();
+        if (!pool)
+            pool = new PointsToSetsPool(registry);
+        return pool;
+    }
+
+    // called when the registry is destroyed
+    static void detach(PointsToSetsPool *pool) {
+        pool->registry = nullptr;
+        if (pool->users == 0)
+            delete pool;
+    }
+
+    static void addUser(PointsToSetsPool *pool) { ++pool->users; }
+    static void removeUser(PointsToSetsPool *pool) {
+        if (pool->removeUser())
+            delete pool;
+    }
+
+    PointerIdRegistry *getRegistry() const {
+        assert(registry && "The registry of the sets is gone");
+        return registry;
+    }
+
+    const BitsT& get(HandleT h) const {
+        assert(h < sets.size());
+        return sets[h].bits;
+    }
+
+    void acquire(HandleT h) {
+        if (h != 0)
+            ++sets[h].refs;
+    }
+
+    void release(HandleT h) {
+        if (h == 0)
+            return;
+
+        assert(sets[h].refs > 0);
+        if (--sets[h].refs == 0)
+            releaseSet(h);
+    }
+
+    // get the handle of the canonical set equal to 'bits'.
+    // The set is released on the first release() of the handle
+    // if nobody acquires it.
+    HandleT intern(BitsT&& bits) {
+        auto hsh = bits.hash();
+        auto range = table.equal_range(hsh);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (sets[it->second].bits == bits)
+                return it->second;
+        }
+
+        HandleT h;
+        if (freeHandles.empty()) {
+            assert(sets.size() < UINT32_MAX && "Out of handles");
+            h = static_cast<HandleT>(sets.size());
+            sets.emplace_back();
+        } else {
+            h = freeHandles.back();
+            freeHandles.pop_back();
+        }
+
+        sets[h].bits = std::move(bits);
+        sets[h].hash = hsh;
+        assert(sets[h].refs == 0);
+        table.emplace(hsh, h);
+        return h;
+    }
+
+    HandleT unite(HandleT a, HandleT b) {
+        if (a == b || b == 0)
+            return a;
+        if (a == 0)
+            return b;
+
+        // union is commutative
+        if (b < a)
+            std::swap(a, b);
+
+        HandleT h;
+        auto k = key(a, b);
+        if (lookup(unions, k, a, sets[b].generation, h))
+            return h;
+
+        BitsT tmp(sets[a].bits);
+        tmp.set(sets[b].bits);
+        h = intern(std::move(tmp));
+        remember(unions, k, memo(a, sets[b].generation, h));
+        return h;
+    }
+
+    HandleT add(HandleT a, size_t id) {
+        if (sets[a].bits.get(id))
+            return a;
+
+        HandleT h;
+        auto k = key(a, id);
+        if (lookup(adds, k, a, 0, h))
+            return h;
+
+        BitsT tmp(sets[a].bits);
+        tmp.set(id);
+        h = intern(std::move(tmp));
+        remember(adds, k, memo(a, 0, h));
+        return h;
+    }
+
+    // the number of sets in the pool
+    size_t size() const { return sets.size() - freeHandles.size(); }
+};
+
+///
+// Points-to set that keeps only a handle to the pool
+// of canonical sets. Two sets are equal iff their handles
+// are equal, so checking whether a merge changed the set
+// is just a comparison of handles.
+class InternedPointsToSet {
+    using HandleT = PointsToSetsPool::HandleT;
+
+    // the canonical sets of the registry that is active
+    // at the time of construction
+    PointsToSetsPool *pool{PointsToSetsPool::get(PointerIdRegistry::get())};
+    HandleT handle{0};
+
+    //if the pointer doesn't have ID, it's assigned one
+    size_t getPointerID(const Pointer& ptr) const {
+        return pool->getRegistry()->getPointerID(ptr);
+    }
+
+    const PointerIdRegistry *getRegistry() const { return pool->getRegistry(); }
+
+    const PointsToSetsPool::BitsT& bits() const { return pool->get(handle); }
+
+    bool setHandle(HandleT h) {
+        if (h == handle)
+            return false;
+        pool->acquire(h);
+        pool->release(handle);
+        handle = h;
+        return true;
+    }
+
+    bool addWithUnknownOffset(PSNode* node) {
+        removeAny(node);
+        return setHandle(pool->add(handle, getPointerID({node, Offset::UNKNOWN})));
+    }
+
+public:
+    InternedPointsToSet() { PointsToSetsPool::addUser(pool); }
+    InternedPointsToSet(std::initializer_list<Pointer> elems)
+    : InternedPointsToSet() { add(elems); }
+
+    InternedPointsToSet(const InternedPointsToSet& rhs)
+    : pool(rhs.pool), handle(rhs.handle) {
+        PointsToSetsPool::addUser(pool);
+        pool->acquire(handle);
+    }
+
+    InternedPointsToSet(InternedPointsToSet&& rhs)
+    : pool(rhs.pool), handle(rhs.handle) {
+        PointsToSetsPool::addUser(pool);
+        rhs.handle = 0;
+    }
+
+    InternedPointsToSet& operator=(InternedPointsToSet rhs) {
+        swap(rhs);
+        return *this;
+    }
+
+    ~InternedPointsToSet() {
+        pool->release(handle);
+        PointsToSetsPool::removeUser(pool);
+    }
+
+    HandleT getHandle() const { return handle; }
+
+    bool operator==(const InternedPointsToSet& rhs) const {
+        return handle == rhs.handle && pool == rhs.pool;
+    }
+
+    bool operator!=(const InternedPointsToSet& rhs) const {
+        return !operator==(rhs);
+    }
+
+    bool add(PSNode *target, Offset off) {
+        return add(Pointer(target,off));
+    }
+
+    bool add(const Pointer& ptr) {
+        if(has({ptr.target, Offset::UNKNOWN})) {
+            return false;
+        }
+        if(ptr.offset.isUnknown()) {
+            return addWithUnknownOffset(ptr.target);
+        }
+        return setHandle(pool->add(handle, getPointerID(ptr)));
+    }
+
+    bool add(const InternedPointsToSet& S) {
+        if (S.pool != pool) {
+            // the sets are numbered differently
+            bool changed = false;
+            for (const auto& ptr : S)
+                changed |= add(ptr);
+            return changed;
+        }
+
+        return setHandle(pool->unite(handle, S.handle));
+    }
+
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
+    bool remove(const Pointer& ptr) {
+        auto id = getPointerID(ptr);
+        if (!bits().get(id))
+            return false;
+
+        PointsToSetsPool::BitsT tmp(bits());
+        tmp.unset(id);
+        return setHandle(pool->intern(std::move(tmp)));
+    }
+
+    bool remove(PSNode *target, Offset offset) {
+        return remove(Pointer(target,offset));
+    }
+
+    bool removeAny(PSNode *target) {
+        std::vector<size_t> toRemove;
+        for (auto ptrID : getRegistry()->getPointerIDs(target)) {
+            if(bits().get(ptrID)) {
+                toRemove.push_back(ptrID);
+            }
+        }
+
+        if (toRemove.empty())
+            return false;
+
+        PointsToSetsPool::BitsT tmp(bits());
+        for (auto ptrID : toRemove)  {
+            tmp.unset(ptrID);
+        }
+        return setHandle(pool->intern(std::move(tmp)));
+    }
+
+    void clear() {
+        setHandle(0);
+    }
+
+    bool pointsTo(const Pointer& ptr) const {
+        return bits().get(getPointerID(ptr));
+    }
+
+    bool mayPointTo(const Pointer& ptr) const {
+        return pointsTo(ptr)
+                || pointsTo(Pointer(ptr.target, Offset::UNKNOWN));
+    }
+
+    bool mustPointTo(const Pointer& ptr) const {
+        assert(!ptr.offset.isUnknown() && "Makes no sense");
+        return pointsTo(ptr) && isSingleton();
+    }
+
+    bool pointsToTarget(PSNode *target) const {
+        for (auto ptrID : getRegistry()->getPointerIDs(target)) {
+            if(bits().get(ptrID)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool isSingleton() const {
+        return bits().size() == 1;
+    }
+
+    bool empty() const {
+        return handle == 0;
+    }
+
+    size_t count(const Pointer& ptr) const {
+        return pointsTo(ptr);
+    }
+
+    bool has(const Pointer& ptr) const {
+        return count(ptr) > 0;
+    }
+
+    bool hasUnknown() const {
+        return pointsToTarget(UNKNOWN_MEMORY);
+    }
+
+    bool hasNull() const {
+        return pointsToTarget(NULLPTR);
+    }
+
+    bool hasInvalidated() const {
+        return pointsToTarget(INVALIDATED);
+    }
+
+    size_t size() const {
+        return bits().size();
+    }
+
+    void swap(InternedPointsToSet& rhs) {
+        std::swap(handle, rhs.handle);
+        std::swap(pool, rhs.pool);
+    }
+
+    // the number of distinct sets that are in use in the pool of this set
+    size_t getPoolSize() const { return pool->size(); }
+
+    class const_iterator {
+
+        typename PointsToSetsPool::BitsT::const_iterator container_it;
+        const PointerIdRegistry *registry;
+
+        const_iterator(const InternedPointsToSet& S, bool end = false) :
+        container_it(end ? S.bits().end() : S.bits().begin()),
+        registry(S.getRegistry()) {}
+
+    public:
+        const_iterator& operator++() {
+            container_it++;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            auto tmp = *this;
+            operator++();
+            return tmp;
+        }
+
+        Pointer operator*() const {
+            return registry->getPointer(*container_it);
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            return container_it == rhs.container_it;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return !operator==(rhs);
+        }
+
+        friend class InternedPointsToSet;
+    };
+
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
+
+    friend class const_iterator;
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif /* INTERNEDPOINTSTOSET_H */
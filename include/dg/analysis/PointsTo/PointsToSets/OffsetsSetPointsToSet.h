@@ -69,7 +69,16 @@ public:
     bool add(const OffsetsSetPointsToSet& S) {
         bool changed = false;
         for (auto& it : S.pointers) {
-            changed |= pointers[it.first].set(it.second);
+            // the unknown offset subsumes the other offsets (as in add()),
+            // so the result does not depend on the order of the unions
+            if (it.second.get(Offset::UNKNOWN)) {
+                changed |= addWithUnknownOffset(it.first);
+                continue;
+            }
+
+            auto& offsets = pointers[it.first];
+            if (!offsets.get(Offset::UNKNOWN))
+                changed |= offsets.set(it.second);
         }
         return changed;
     }
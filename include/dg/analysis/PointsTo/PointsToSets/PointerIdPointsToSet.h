@@ -2,10 +2,11 @@
 #define SINGLEBITVECTORPOINTSTOSET_H
 
 #include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
 #include "dg/ADT/Bitvector.h"
 
-#include <map>
 #include <vector>
+#include <utility>
 #include <cassert>
 
 namespace dg {
@@ -17,17 +18,12 @@ class PSNode;
 class PointerIdPointsToSet {
 
     ADT::SparseBitvector pointers;
-    static std::map<Pointer, size_t> ids; //pointers are numbered 1, 2, ...
-    static std::vector<Pointer> idVector; //starts from 0 (pointer = idVector[id - 1])
+    // the numbering of pointers in this set
+    PointerIdRegistry *registry{PointerIdRegistry::get()};
 
     //if the pointer doesn't have ID, it's assigned one
     size_t getPointerID(const Pointer& ptr) const {
-        auto it = ids.find(ptr);
-        if(it != ids.end()) {
-            return it->second;
-        }
-        idVector.push_back(ptr);
-        return ids.emplace_hint(it, ptr, ids.size() + 1)->second;
+        return registry->getPointerID(ptr);
     }
 
     bool addWithUnknownOffset(PSNode* node) {
@@ -54,9 +50,25 @@ public:
     }
 
     bool add(const PointerIdPointsToSet& S) {
+        if (S.registry != registry) {
+            // the sets are numbered differently
+            bool changed = false;
+            for (const auto& ptr : S)
+                changed |= add(ptr);
+            return changed;
+        }
+
         return pointers.set(S.pointers);
     }
 
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
     bool remove(const Pointer& ptr) {
         return pointers.unset(getPointerID(ptr));
     }
@@ -66,17 +78,11 @@ public:
     }
 
     bool removeAny(PSNode *target) {
-        std::vector<size_t> toRemove;
-        for (const auto& ptrID : pointers) {
-            if(idVector[ptrID - 1].target == target) {
-                toRemove.push_back(ptrID);
-            }
-        }
-
-        for (auto ptrID : toRemove)  {
-            pointers.unset(ptrID);
+        bool removed = false;
+        for (auto ptrID : registry->getPointerIDs(target)) {
+            removed |= pointers.unset(ptrID);
         }
-        return !toRemove.empty();
+        return removed;
     }
 
     void clear() {
@@ -98,8 +104,8 @@ public:
     }
 
     bool pointsToTarget(PSNode *target) const {
-        for(const auto& kv : ids) {
-            if(kv.first.target == target && pointers.get(kv.second)) {
+        for(auto ptrID : registry->getPointerIDs(target)) {
+            if(pointers.get(ptrID)) {
                 return true;
             }
         }
@@ -141,14 +147,17 @@ public:
 
     void swap(PointerIdPointsToSet& rhs) {
         pointers.swap(rhs.pointers);
+        std::swap(registry, rhs.registry);
     }
 
     class const_iterator {
 
         typename ADT::SparseBitvector::const_iterator container_it;
+        const PointerIdRegistry *registry;
 
-        const_iterator(const ADT::SparseBitvector& pointers, bool end = false) :
-        container_it(end ? pointers.end() : pointers.begin()) {}
+        const_iterator(const PointerIdPointsToSet& S, bool end = false) :
+        container_it(end ? S.pointers.end() : S.pointers.begin()),
+        registry(S.registry) {}
 
     public:
         const_iterator& operator++() {
@@ -163,7 +172,7 @@ public:
         }
 
         Pointer operator*() const {
-            return Pointer(idVector[*container_it - 1]);
+            return registry->getPointer(*container_it);
         }
 
         bool operator==(const const_iterator& rhs) const {
@@ -177,8 +186,8 @@ public:
         friend class PointerIdPointsToSet;
     };
 
-    const_iterator begin() const { return const_iterator(pointers); }
-    const_iterator end() const { return const_iterator(pointers, true /* end */); }
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
 
     friend class const_iterator;
 };
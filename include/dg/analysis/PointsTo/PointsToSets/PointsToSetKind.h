@@ -0,0 +1,27 @@
+#ifndef POINTSTOSETKIND_H
+#define POINTSTOSETKIND_H
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+// the implementations of points-to sets that can be selected
+// at runtime (see DynamicPointsToSet)
+enum class PointsToSetKind {
+    OFFSETS_SET,
+    SIMPLE,
+    SEPARATE_OFFSETS,
+    POINTER_ID,
+    SMALL_OFFSETS,
+    ALIGNED_SMALL_OFFSETS,
+    ALIGNED_POINTER_ID,
+    HYBRID_POINTER_ID,
+    INTERNED,
+    BDD
+};
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
+
+#endif /* POINTSTOSETKIND_H */
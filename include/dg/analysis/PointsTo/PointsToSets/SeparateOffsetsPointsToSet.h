@@ -2,10 +2,11 @@
 #define SEPARATEOFFSETSPOINTSTOSET_H
 
 #include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
 #include "dg/ADT/Bitvector.h"
 
-#include <map>
 #include <vector>
+#include <utility>
 
 namespace dg {
 namespace analysis {
@@ -17,17 +18,12 @@ class SeparateOffsetsPointsToSet {
 
     ADT::SparseBitvector nodes;
     ADT::SparseBitvector offsets;
-    static std::map<PSNode*,size_t> ids;  //nodes are numbered 1, 2, ...
-    static std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
+    // the numbering of nodes in this set
+    PointerIdRegistry *registry{PointerIdRegistry::get()};
 
     //if the node doesn't have ID, it is assigned one
     size_t getNodeID(PSNode *node) const {
-        auto it = ids.find(node);
-        if(it != ids.end()) {
-            return it->second;
-        }
-        idVector.push_back(node);
-        return ids.emplace_hint(it, node, ids.size() + 1)->second;
+        return registry->getNodeID(node);
     }
 
 public:
@@ -50,10 +46,26 @@ public:
     }
 
     bool add(const SeparateOffsetsPointsToSet& S) {
+        if (S.registry != registry) {
+            // the sets are numbered differently
+            bool changed = false;
+            for (const auto& ptr : S)
+                changed |= add(ptr);
+            return changed;
+        }
+
         bool changed = nodes.set(S.nodes);
         return offsets.set(S.offsets) || changed;
     }
 
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
     bool remove(__attribute__((unused)) const Pointer& ptr) {
         abort();
     }
@@ -125,6 +137,7 @@ public:
     void swap(SeparateOffsetsPointsToSet& rhs) {
         nodes.swap(rhs.nodes);
         offsets.swap(rhs.offsets);
+        std::swap(registry, rhs.registry);
     }
 
     //iterates through all the possible combinations of nodes and their offsets stored in this points-to set
@@ -135,13 +148,15 @@ public:
         typename ADT::SparseBitvector::const_iterator offsets_it;
         typename ADT::SparseBitvector::const_iterator offsets_begin;
         typename ADT::SparseBitvector::const_iterator offsets_end;
-
-        const_iterator(const ADT::SparseBitvector& nodes, const ADT::SparseBitvector& offsets, bool end = false) :
-        nodes_it(end ? nodes.end() : nodes.begin()),
-        nodes_end(nodes.end()),
-        offsets_it(offsets.begin()),
-        offsets_begin(offsets.begin()),
-        offsets_end(offsets.end()) {
+        const PointerIdRegistry *registry;
+
+        const_iterator(const SeparateOffsetsPointsToSet& S, bool end = false) :
+        nodes_it(end ? S.nodes.end() : S.nodes.begin()),
+        nodes_end(S.nodes.end()),
+        offsets_it(S.offsets.begin()),
+        offsets_begin(S.offsets.begin()),
+        offsets_end(S.offsets.end()),
+        registry(S.registry) {
             if(nodes_it == nodes_end) {
                 offsets_it = offsets_end;
             }
@@ -166,7 +181,7 @@ public:
         }
 
         Pointer operator*() const {
-            return Pointer(idVector[*nodes_it - 1], *offsets_it);
+            return Pointer(registry->getNode(*nodes_it), *offsets_it);
         }
 
         bool operator==(const const_iterator& rhs) const {
@@ -181,8 +196,8 @@ public:
         friend class SeparateOffsetsPointsToSet;
     };
 
-    const_iterator begin() const { return const_iterator(nodes, offsets); }
-    const_iterator end() const { return const_iterator(nodes, offsets, true /* end */); }
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
 
     friend class const_iterator;
 };
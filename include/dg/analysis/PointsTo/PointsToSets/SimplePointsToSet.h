@@ -59,8 +59,11 @@ public:
     // into 'this' set (i.e. merge rhs to this set)
     bool add(const SimplePointsToSet& rhs) {
         bool changed = false;
+        // add the pointers one by one, so that a pointer with unknown
+        // offset subsumes the other pointers to the target regardless
+        // of the order in which the sets were united
         for (const auto& ptr : rhs.pointers) {
-            changed |= pointers.insert(ptr).second;
+            changed |= add(ptr);
         }
 
         return changed;
@@ -135,10 +138,10 @@ public:
         return pointers.size() == 1;
     }
 
-    size_t count(const Pointer& ptr) { return pointers.count(ptr); }
+    size_t count(const Pointer& ptr) const { return pointers.count(ptr); }
     size_t size() const { return pointers.size(); }
     bool empty() const { return pointers.empty(); }
-    bool has(const Pointer& ptr) { return count(ptr) > 0; }
+    bool has(const Pointer& ptr) const { return count(ptr) > 0; }
     bool hasUnknown() const { return pointsToTarget(UNKNOWN_MEMORY); }
     bool hasNull() const { return pointsToTarget(NULLPTR); }
     bool hasInvalidated() const { return pointsToTarget(INVALIDATED); }
@@ -2,11 +2,12 @@
 #define SMALLOFFSETSPOINTSTOSET_H
 
 #include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerIdRegistry.h"
 #include "dg/ADT/Bitvector.h"
 
-#include <map>
 #include <set>
 #include <vector>
+#include <utility>
 #include <cassert>
 
 namespace dg {
@@ -19,17 +20,12 @@ class SmallOffsetsPointsToSet {
 
     ADT::SparseBitvector pointers;
     std::set<Pointer> largePointers;
-    static std::map<PSNode*,size_t> ids;  //nodes are numbered 1,2, ...
-    static std::vector<PSNode*> idVector; //starts from 0 (node = idVector[id - 1])
+    // the numbering of nodes in this set
+    PointerIdRegistry *registry{PointerIdRegistry::get()};
 
     //if the node doesn't have ID, it's assigned one
     size_t getNodeID(PSNode *node) const {
-        auto it = ids.find(node);
-        if(it != ids.end()) {
-            return it->second;
-        }
-        idVector.push_back(node);
-        return ids.emplace_hint(it, node, ids.size() + 1)->second;
+        return registry->getNodeID(node);
     }
 
     size_t getNodePosition(PSNode *node) const {
@@ -74,6 +70,14 @@ public:
     }
 
     bool add(const SmallOffsetsPointsToSet& S) {
+        if (S.registry != registry) {
+            // the sets are numbered differently
+            bool changed = false;
+            for (const auto& ptr : S)
+                changed |= add(ptr);
+            return changed;
+        }
+
         bool changed = pointers.set(S.pointers);
         for (const auto& ptr : S.largePointers) {
             changed |= largePointers.insert(ptr).second;
@@ -81,6 +85,14 @@ public:
         return changed;
     }
 
+    bool add(std::initializer_list<Pointer> elems) {
+        bool changed = false;
+        for (const auto& e : elems) {
+            changed |= add(e);
+        }
+        return changed;
+    }
+
     bool remove(const Pointer& ptr) {
         if(isOffsetValid(ptr.offset)) {
             return pointers.unset(getPosition(ptr.target, ptr.offset));
@@ -183,6 +195,7 @@ public:
     void swap(SmallOffsetsPointsToSet& rhs) {
         pointers.swap(rhs.pointers);
         largePointers.swap(rhs.largePointers);
+        std::swap(registry, rhs.registry);
     }
 
     size_t overflowSetSize() const {
@@ -196,12 +209,13 @@ public:
         typename ADT::SparseBitvector::const_iterator bitvector_end;
         typename std::set<Pointer>::const_iterator set_it;
         bool secondContainer;
+        const PointerIdRegistry *registry;
 
-        const_iterator(const ADT::SparseBitvector& pointers, const std::set<Pointer>& largePointers, bool end = false)
-        : bitvector_it(end ? pointers.end() : pointers.begin()),
-        bitvector_end(pointers.end()),
-        set_it(end ? largePointers.end() : largePointers.begin()),
-        secondContainer(end) {
+        const_iterator(const SmallOffsetsPointsToSet& S, bool end = false)
+        : bitvector_it(end ? S.pointers.end() : S.pointers.begin()),
+        bitvector_end(S.pointers.end()),
+        set_it(end ? S.largePointers.end() : S.largePointers.begin()),
+        secondContainer(end), registry(S.registry) {
             if(bitvector_it == bitvector_end) {
                 secondContainer = true;
             }
@@ -230,7 +244,7 @@ public:
             if(!secondContainer) {
                 size_t offsetID = *bitvector_it % 64;
                 size_t nodeID = ((*bitvector_it - offsetID) / 64) + 1;
-                return offsetID == 63 ? Pointer(idVector[nodeID - 1], Offset::UNKNOWN) : Pointer(idVector[nodeID - 1], offsetID);
+                return offsetID == 63 ? Pointer(registry->getNode(nodeID), Offset::UNKNOWN) : Pointer(registry->getNode(nodeID), offsetID);
             }
             return *set_it;
         }
@@ -247,8 +261,8 @@ public:
         friend class SmallOffsetsPointsToSet;
     };
 
-    const_iterator begin() const { return const_iterator(pointers, largePointers); }
-    const_iterator end() const { return const_iterator(pointers, largePointers, true /* end */); }
+    const_iterator begin() const { return const_iterator(*this); }
+    const_iterator end() const { return const_iterator(*this, true /* end */); }
 
     friend class const_iterator;
 };
@@ -7,6 +7,7 @@
 #include <cassert>
 #include <memory>
 
+#include "dg/ADT/Arena.h"
 #include "dg/analysis/Offset.h"
 #include "dg/analysis/BFS.h"
 
@@ -116,7 +117,7 @@ class ReachingDefinitionsGraph {
     size_t lastNodeID{0};
     RDNode *root{nullptr};
     using BBlocksVecT = std::vector<std::unique_ptr<RDBBlock>>;
-    using NodesT = std::vector<std::unique_ptr<RDNode>>;
+    using NodesT = std::vector<ADT::ArenaPtr<RDNode>>;
 
     // iterator over the bblocks that returns the bblock,
     // not the unique_ptr to the bblock
@@ -144,11 +145,19 @@ class ReachingDefinitionsGraph {
         block_iterator end() { return block_iterator(blocks.end()); }
     };
 
+    // the nodes are allocated in the arena and are destroyed
+    // before the arena goes away (see the destructor)
     NodesT _nodes;
+    ADT::SizeClassArena _arena;
 
 public:
     ReachingDefinitionsGraph() = default;
     ReachingDefinitionsGraph(RDNode *r) : root(r) {};
+    ~ReachingDefinitionsGraph() {
+        // destroy the nodes while the arena is alive
+        _nodes.clear();
+    }
+
     ReachingDefinitionsGraph(ReachingDefinitionsGraph&&) = default;
     ReachingDefinitionsGraph& operator=(ReachingDefinitionsGraph&&) = default;
 
@@ -169,7 +178,7 @@ public:
     }
 
     RDNode *create(RDNodeType t) {
-      _nodes.emplace_back(new RDNode(++lastNodeID, t));
+      _nodes.emplace_back(_arena.create<RDNode>(++lastNodeID, t));
       return _nodes.back().get();
     }
 
@@ -1,33 +1,158 @@
 #ifndef _DG_SCC_H_
 #define  _DG_SCC_H_
 
+#include <cassert>
+#include <iterator>
 #include <vector>
 #include <set>
 
-#include "dg/ADT/Queue.h"
-
 namespace dg {
 namespace analysis {
 
-// implementation of tarjan's algorithm for
-// computing strongly connected components
-// for a directed graph that has a starting vertex
-// from which are all other vertices reachable
+// Strongly connected components stored in one array of nodes,
+// every component is a range of this array. Changing a component
+// (assign(), clear()) does not move the nodes of other components,
+// the unused parts of the array are dropped once they take
+// more space than the components.
+template <typename NodeT>
+class SCCComponents {
+public:
+    // the nodes of one component, valid until the components change
+    class Component {
+    public:
+        using iterator = NodeT *const *;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+
+        Component() = default;
+        Component(iterator f, iterator l) : first(f), last(l) {}
+
+        iterator begin() const { return first; }
+        iterator end() const { return last; }
+        reverse_iterator rbegin() const { return reverse_iterator(last); }
+        reverse_iterator rend() const { return reverse_iterator(first); }
+
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+
+        NodeT *operator[](size_t idx) const
+        {
+            assert(idx < size());
+            return first[idx];
+        }
+
+    private:
+        iterator first{nullptr};
+        iterator last{nullptr};
+    };
+
+    size_t size() const { return ranges.size(); }
+    bool empty() const { return ranges.empty(); }
+
+    Component operator[](unsigned idx) const
+    {
+        assert(idx < ranges.size());
+        return Component(nodes.data() + ranges[idx].begin,
+                         nodes.data() + ranges[idx].end);
+    }
+
+    // add a new component with the given nodes, return its index
+    template <typename IteratorT>
+    unsigned add(IteratorT first, IteratorT last)
+    {
+        unsigned begin = nodes.size();
+        nodes.insert(nodes.end(), first, last);
+        ranges.push_back({begin, static_cast<unsigned>(nodes.size())});
+        used += nodes.size() - begin;
+
+        return ranges.size() - 1;
+    }
+
+    // set the nodes of the component 'idx'
+    void assign(unsigned idx, const std::vector<NodeT *>& comp)
+    {
+        clear(idx);
+        ranges[idx].begin = nodes.size();
+        nodes.insert(nodes.end(), comp.begin(), comp.end());
+        ranges[idx].end = nodes.size();
+        used += comp.size();
+
+        if (nodes.size() > 2*used)
+            compact();
+    }
+
+    // make the component 'idx' empty
+    void clear(unsigned idx)
+    {
+        assert(idx < ranges.size());
+        used -= ranges[idx].end - ranges[idx].begin;
+        ranges[idx].begin = ranges[idx].end = 0;
+    }
+
+    void clear()
+    {
+        nodes.clear();
+        ranges.clear();
+        used = 0;
+    }
+
+private:
+    struct Range {
+        unsigned begin;
+        unsigned end;
+    };
+
+    std::vector<NodeT *> nodes;
+    std::vector<Range> ranges;
+    // the number of nodes that are in some component
+    size_t used{0};
+
+    void compact()
+    {
+        std::vector<NodeT *> tmp;
+        tmp.reserve(used);
+        for (Range& r : ranges) {
+            unsigned begin = tmp.size();
+            tmp.insert(tmp.end(), nodes.begin() + r.begin, nodes.begin() + r.end);
+            r.begin = begin;
+            r.end = tmp.size();
+        }
+
+        nodes.swap(tmp);
+    }
+};
+
+// Implementation of the Pearce's variant of the Tarjan's algorithm for
+// computing strongly connected components for a directed graph that has
+// a starting vertex from which are all other vertices reachable.
+// The algorithm is iterative (the depth of the graph is not limited
+// by the size of the stack) and keeps only one number (dfs_id) per node:
+// the index of the node that is lowered to the lowest index reachable
+// from the node (the lowpoint) during the search.
 template <typename NodeT>
 class SCC {
 public:
-    using SCC_component_t = std::vector<NodeT *>;
-    using SCC_t = std::vector<SCC_component_t>;
+    using SCC_t = SCCComponents<NodeT>;
+    using SCC_component_t = typename SCC_t::Component;
 
     SCC<NodeT>(unsigned not_visit = 0)
     : index(not_visit), NOT_VISITED(not_visit) {}
 
-    // returns a vector of vectors - every inner vector
-    // contains the nodes that for a SCC
+    // number the visited nodes from 'first_index'. With not_visit = 0,
+    // the nodes that were visited by any previous computation are skipped
+    // (used to compute only the components of newly added nodes)
+    SCC<NodeT>(unsigned not_visit, unsigned first_index)
+    : index(first_index), NOT_VISITED(not_visit) {
+        assert(first_index >= not_visit);
+    }
+
+    // returns the components in the reverse topological order,
+    // the nodes of every component are in the order in which
+    // the search left them (the first visited node is the last)
     SCC_t& compute(NodeT *start)
     {
         _compute(start);
         assert(stack.empty());
+        assert(frames.empty());
 
         return scc;
     }
@@ -37,7 +162,7 @@ public:
         return scc;
     }
 
-    SCC_component_t& operator[](unsigned idx)
+    SCC_component_t operator[](unsigned idx) const
     {
         assert(idx < scc.size());
         return scc[idx];
@@ -46,7 +171,18 @@ public:
     unsigned getIndex() const { return index; }
 
 private:
-    ADT::QueueLIFO<NodeT *> stack;
+    // the nodes that are on the path of the search
+    struct Frame {
+        NodeT *node;
+        // the index of the next successor to search
+        unsigned next_succ;
+        // is the node the first node of its component?
+        bool root;
+    };
+
+    std::vector<Frame> frames;
+    // the searched nodes that wait for their component
+    std::vector<NodeT *> stack;
     unsigned index;
     // it the dfsid is less or equal to this value,
     // then it is considered not to be visited.
@@ -59,45 +195,76 @@ private:
 
     bool not_visited(NodeT *n) { return n->dfs_id <= NOT_VISITED; }
 
-    void _compute(NodeT *n)
+    void visit(NodeT *n)
     {
         // here we using the fact that we are a friend class
         // of SubgraphNode. If we would need to make this
         // algorithm more generinc, we add setters/getters.
-        n->dfs_id = n->lowpt = ++index;
-        stack.push(n);
+        n->dfs_id = ++index;
+        // on_stack means that the component of the node is not known yet
         n->on_stack = true;
+        frames.push_back({n, 0, true});
+    }
 
-        for (NodeT *succ : n->getSuccessors()) {
-            if (not_visited(succ)) {
-                assert(!succ->on_stack);
-                _compute(succ);
-                n->lowpt = std::min(n->lowpt, succ->lowpt);
-            } else if (succ->on_stack) {
-                n->lowpt = std::min(n->lowpt, succ->dfs_id);
-            }
+    // the edge from the node in the frame to 'succ' was searched
+    static void searched(Frame& frame, NodeT *succ)
+    {
+        if (succ->on_stack && succ->dfs_id < frame.node->dfs_id) {
+            frame.node->dfs_id = succ->dfs_id;
+            frame.root = false;
         }
+    }
 
-        if (n->lowpt == n->dfs_id) {
-            SCC_component_t component;
-            size_t component_num = scc.size();
-
-            NodeT *w;
-            while (stack.top()->dfs_id >= n->dfs_id) {
-                w = stack.pop();
-                w->on_stack = false;
-                component.push_back(w);
-                // the numbers scc_id give
-                // a reverse topological order
-                w->scc_id = component_num;
-
-                if (stack.empty())
-                    break;
+    void _compute(NodeT *start)
+    {
+        visit(start);
+
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            NodeT *n = frame.node;
+            const auto& successors = n->getSuccessors();
+            if (frame.next_succ < successors.size()) {
+                NodeT *succ = successors[frame.next_succ++];
+                if (not_visited(succ))
+                    visit(succ);
+                else
+                    searched(frame, succ);
+                continue;
             }
 
-            scc.push_back(std::move(component));
+            bool root = frame.root;
+            frames.pop_back();
+
+            if (root)
+                addComponent(n);
+            else
+                stack.push_back(n);
+
+            if (!frames.empty())
+                searched(frames.back(), n);
         }
     }
+
+    void addComponent(NodeT *root)
+    {
+        // the nodes searched from the root (the top of the stack)
+        // that did not lower their index below the index of the root
+        size_t first = stack.size();
+        while (first > 0 && stack[first - 1]->dfs_id >= root->dfs_id)
+            --first;
+
+        stack.push_back(root);
+
+        // the numbers scc_id give a reverse topological order
+        unsigned component_num = scc.size();
+        for (size_t i = first; i < stack.size(); ++i) {
+            stack[i]->on_stack = false;
+            stack[i]->scc_id = component_num;
+        }
+
+        scc.add(stack.begin() + first, stack.end());
+        stack.resize(first);
+    }
 };
 
 template <typename NodeT>
@@ -106,10 +273,10 @@ class SCCCondensation {
     using SCC_component_t = typename SCC<NodeT>::SCC_component_t;
 
     struct Node {
-        const SCC_component_t& component;
+        SCC_component_t component;
         std::set<unsigned> successors;
 
-        Node(SCC_component_t& comp) : component(comp) {}
+        Node(const SCC_component_t& comp) : component(comp) {}
 
         void addSuccessor(unsigned idx)
         {
@@ -137,30 +304,27 @@ public:
         return nodes[idx];
     }
 
-    void compute(SCC_t& scc)
+    void compute(const SCC_t& scc)
     {
         // we know the size before-hand
         nodes.reserve(scc.size());
 
         // create the nodes in our condensation graph
-        for (auto& comp : scc)
-            nodes.push_back(Node(comp));
+        for (unsigned idx = 0; idx < scc.size(); ++idx)
+            nodes.push_back(Node(scc[idx]));
 
         assert(nodes.size() == scc.size());
 
-        int idx = 0;
-        for (auto& comp : scc) {
-            for (NodeT *node : comp) {
+        for (unsigned idx = 0; idx < scc.size(); ++idx) {
+            for (NodeT *node : scc[idx]) {
                 // we can get from this component
                 // to the component of succ
                 for (NodeT *succ : node->getSuccessors()) {
                     unsigned succ_idx = succ->getSCCId();
-                    if (static_cast<int>(succ_idx) != idx)
+                    if (succ_idx != idx)
                         nodes[idx].addSuccessor(succ_idx);
                 }
             }
-
-            ++idx;
         }
     }
 
@@ -170,7 +334,7 @@ public:
         compute(S.getSCC());
     }
 
-    SCCCondensation<NodeT>(SCC_t& s)
+    SCCCondensation<NodeT>(const SCC_t& s)
     {
         compute(s);
     }
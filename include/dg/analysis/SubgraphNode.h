@@ -55,7 +55,6 @@ protected:
 public:
     // FIXME: get rid of these things
     unsigned int dfs_id{0};
-    unsigned int lowpt{0};
 
     // id of scc component
     unsigned int scc_id{0};
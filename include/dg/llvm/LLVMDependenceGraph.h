@@ -11,6 +11,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <memory>
 
 #include "dg/llvm/analysis/ThreadRegions/ControlFlowGraph.h"
 
@@ -57,6 +58,14 @@ using LLVMBBlock = dg::BBlock<LLVMNode>;
 /// ------------------------------------------------------------------
 class LLVMDependenceGraph : public DependenceGraph<LLVMNode>
 {
+    // the arena for nodes, blocks and parameters of this graph
+    // and of all its subgraphs. It is owned by the graph that was
+    // built by build(Module) and the subgraphs only refer to it.
+    // The subgraphs are deleted before the owner, so the arena
+    // is released at once when all the objects are gone
+    ADT::SizeClassArena *arena{nullptr};
+    std::unique_ptr<ADT::SizeClassArena> ownedArena{};
+
     // our artificial unified exit block
     std::unique_ptr<LLVMBBlock> unifiedExitBB{};
     llvm::Function *entryFunction{nullptr};
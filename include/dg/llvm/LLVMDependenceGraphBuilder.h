@@ -29,7 +29,11 @@
 #include "dg/llvm/analysis/ReachingDefinitions/ReachingDefinitions.h"
 
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFIParallel.h"
+#include "dg/analysis/PointsTo/PointerAnalysisAndersen.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSteensgaard.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFSSparse.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/Offset.h"
@@ -96,10 +100,19 @@ class LLVMDependenceGraphBuilder {
 
         if (_options.PTAOptions.isFS())
             _PTA->run<analysis::pta::PointerAnalysisFS>();
+        else if (_options.PTAOptions.isFI() &&
+                 _options.PTAOptions.solverThreads > 1)
+            _PTA->run<analysis::pta::PointerAnalysisFIParallel>();
         else if (_options.PTAOptions.isFI())
             _PTA->run<analysis::pta::PointerAnalysisFI>();
         else if (_options.PTAOptions.isFSInv())
             _PTA->run<analysis::pta::PointerAnalysisFSInv>();
+        else if (_options.PTAOptions.isFIAndersen())
+            _PTA->run<analysis::pta::PointerAnalysisAndersen>();
+        else if (_options.PTAOptions.isSteensgaard())
+            _PTA->run<analysis::pta::PointerAnalysisSteensgaard>();
+        else if (_options.PTAOptions.isFSSparse())
+            _PTA->run<analysis::pta::PointerAnalysisFSSparse>();
         else {
             assert(0 && "Wrong pointer analysis");
             abort();
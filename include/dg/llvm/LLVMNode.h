@@ -32,6 +32,7 @@
 #endif
 
 #include "dg/Node.h"
+#include "dg/ADT/Arena.h"
 
 namespace dg {
 
@@ -45,7 +46,10 @@ using LLVMDGParameters = dg::DGParameters<LLVMNode>;
 /// ------------------------------------------------------------------
 //  -- LLVMNode
 /// ------------------------------------------------------------------
-class LLVMNode : public Node<LLVMDependenceGraph, llvm::Value *, LLVMNode>
+// LLVMNode is allocated in the arena of the dependence graph
+// that is being built (see LLVMDependenceGraph::build)
+class LLVMNode : public Node<LLVMDependenceGraph, llvm::Value *, LLVMNode>,
+                 public ADT::ArenaAllocated
 {
 #if LLVM_VERSION_MAJOR >= 5
     struct LLVMValueDeleter {
@@ -3,18 +3,27 @@
 
 #include "dg/llvm/analysis/LLVMAnalysisOptions.h"
 #include "dg/analysis/PointsTo/PointerAnalysisOptions.h"
+#include "dg/analysis/PointsTo/PointsToSet.h"
 
 namespace dg {
 namespace analysis {
 
 struct LLVMPointerAnalysisOptions : public LLVMAnalysisOptions, PointerAnalysisOptions
 {
-    enum class AnalysisType { fi, fs, inv } analysisType{AnalysisType::fi};
+    // fi_andersen is flow-insensitive analysis
+    // that solves the constraints extracted from the graph,
+    // steens is unification-based flow-insensitive analysis,
+    // fs_sparse is flow-sensitive analysis solved along def-use chains
+    // found by flow-insensitive analysis
+    enum class AnalysisType { fi, fs, inv, fi_andersen, steens, fs_sparse } analysisType{AnalysisType::fi};
 
     bool threads;
     bool isFS() const { return analysisType == AnalysisType::fs; }
     bool isFSInv() const { return analysisType == AnalysisType::inv; }
     bool isFI() const { return analysisType == AnalysisType::fi; }
+    bool isFIAndersen() const { return analysisType == AnalysisType::fi_andersen; }
+    bool isSteensgaard() const { return analysisType == AnalysisType::steens; }
+    bool isFSSparse() const { return analysisType == AnalysisType::fs_sparse; }
 };
 
 } // namespace analysis
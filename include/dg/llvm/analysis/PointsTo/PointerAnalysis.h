@@ -1,6 +1,8 @@
 #ifndef _LLVM_DG_POINTS_TO_ANALYSIS_H_
 #define _LLVM_DG_POINTS_TO_ANALYSIS_H_
 
+#include <type_traits>
+
 // ignore unused parameters in LLVM libraries
 #if (__clang__)
 #pragma clang diagnostic push
@@ -23,6 +25,7 @@
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
 #include "dg/analysis/PointsTo/PointerAnalysis.h"
 #include "dg/analysis/PointsTo/PointerSubgraphOptimizations.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFSInv.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 
@@ -47,52 +50,41 @@ class LLVMPointerAnalysisImpl : public PTType
     LLVMPointerSubgraphBuilder *builder;
 
 public:
-    LLVMPointerAnalysisImpl(PointerSubgraph *PS, LLVMPointerSubgraphBuilder *b)
-    : PTType(PS), builder(b) {}
+    LLVMPointerAnalysisImpl(PointerSubgraph *PS, LLVMPointerSubgraphBuilder *b,
+                            const LLVMPointerAnalysisOptions& opts)
+    : PTType(PS, opts), builder(b) {}
 
     // build new subgraphs on calls via pointer
     bool functionPointerCall(PSNode *callsite, PSNode *called) override
     {
-        using namespace analysis::pta;
-        const llvm::Function *F
-            = llvm::dyn_cast<llvm::Function>(called->getUserData<llvm::Value>());
-        // with vararg it may happen that we get pointer that
-        // is not to function, so just bail out here in that case
-        if (!F)
-            return false;
-
-        if (F->isDeclaration()) {
-            if (builder->threads()) {
-                if (F->getName() == "pthread_create") {
-                    builder->insertPthreadCreateByPtrCall(callsite);
-                    return true;
-                } else if (F->getName() == "pthread_join") {
-                    builder->insertPthreadJoinByPtrCall(callsite);
-                    return true;
-                }
-            }
-            return callsite->getPairedNode()->addPointsTo(analysis::pta::UnknownPointer);
-        }
-
-        if (!LLVMPointerSubgraphBuilder::callIsCompatible(callsite, called)) {
-            return false;
-        } else {
-            builder->insertFunctionCall(callsite, called);
-        }
+        return functionPointerCalls(callsite, {called});
+    }
 
+    // build the subgraphs of all the functions that the callsite
+    // newly calls (the subgraph of a function is built only once,
+    // the calls of the same function reuse it)
+    bool functionPointerCalls(PSNode *callsite,
+                              const std::vector<PSNode *>& called) override
+    {
+        bool changed = false;
+        for (PSNode *F : called)
+            changed |= insertFunctionCall(callsite, F);
 
 #ifndef NDEBUG
         // check the graph after rebuilding, but do not check for connectivity,
-        // because we can call a function that will disconnect the graph
-        if (!builder->validateSubgraph(true)) {
+        // because we can call a function that will disconnect the graph.
+        // The graph is checked once for all the functions.
+        if (changed && !builder->validateSubgraph(true)) {
             llvm::errs() << "Pointer Subgraph is broken!\n";
-            llvm::errs() << "This happend after building this function called via pointer: "
-                         <<  F->getName() << "\n";
+            llvm::errs() << "This happend after building these functions called via pointer:";
+            for (PSNode *F : called)
+                llvm::errs() << " " << F->getUserData<llvm::Value>()->getName();
+            llvm::errs() << "\n";
             abort();
         }
 #endif // NDEBUG
 
-        return true; // we changed the graph
+        return changed;
     }
 
     bool handleFork(PSNode *forkNode) override
@@ -118,12 +110,48 @@ public:
         return builder->matchJoinToRightCreate(joinNode);
         builder->setAdHocBuilding(false);
     }
+
+private:
+    // connect the called function to the callsite,
+    // return true if the graph changed
+    bool insertFunctionCall(PSNode *callsite, PSNode *called)
+    {
+        using namespace analysis::pta;
+        const llvm::Function *F
+            = llvm::dyn_cast<llvm::Function>(called->getUserData<llvm::Value>());
+        // with vararg it may happen that we get pointer that
+        // is not to function, so just bail out here in that case
+        if (!F)
+            return false;
+
+        if (F->isDeclaration()) {
+            if (builder->threads()) {
+                if (F->getName() == "pthread_create") {
+                    builder->insertPthreadCreateByPtrCall(callsite);
+                    return true;
+                } else if (F->getName() == "pthread_join") {
+                    builder->insertPthreadJoinByPtrCall(callsite);
+                    return true;
+                }
+            }
+            return callsite->getPairedNode()->addPointsTo(analysis::pta::UnknownPointer);
+        }
+
+        if (!LLVMPointerSubgraphBuilder::callIsCompatible(callsite, called))
+            return false;
+
+        builder->insertFunctionCall(callsite, called);
+        return true; // we changed the graph
+    }
 };
 
 class LLVMPointerAnalysis
 {
     PointerSubgraph *PS = nullptr;
     std::unique_ptr<LLVMPointerSubgraphBuilder> _builder;
+    const LLVMPointerAnalysisOptions _options;
+    // statistics of the last run()
+    analysis::pta::PointerAnalysis::Statistics _statistics{};
 
     LLVMPointerAnalysisOptions createOptions(const char *entry_func,
                                              uint64_t field_sensitivity,
@@ -151,7 +179,7 @@ public:
         : LLVMPointerAnalysis(m, createOptions(entry_func, field_sensitivity, threads)) {}
 
     LLVMPointerAnalysis(const llvm::Module *m, const LLVMPointerAnalysisOptions opts)
-        : _builder(new LLVMPointerSubgraphBuilder(m, opts)) {}
+        : _builder(new LLVMPointerSubgraphBuilder(m, opts)), _options(opts) {}
 
     ///
     // Get the node from pointer analysis that holds the points-to set.
@@ -219,7 +247,7 @@ public:
         return _builder->getNodesMap();
     }
 
-    const std::vector<std::unique_ptr<PSNode>>& getNodes()
+    const PointerSubgraph::NodesT& getNodes()
     {
         return PS->getNodes();
     }
@@ -231,6 +259,10 @@ public:
     PointerSubgraph *getPS() { return PS; }
     const PointerSubgraph *getPS() const { return PS; }
 
+    const analysis::pta::PointerAnalysis::Statistics& getStatistics() const {
+        return _statistics;
+    }
+
     void buildSubgraph()
     {
         // run the analysis itself
@@ -265,13 +297,42 @@ public:
 
     }
 
+    // merge the nodes that compute the same value,
+    // loads of the same pointer are merged only if 'mergeLoads' is set
+    // (they have the same value in the flow-insensitive analysis)
+    void mergeEquivalentValues(bool mergeLoads)
+    {
+        analysis::pta::PSValueNumberingMerger merger(PS, mergeLoads);
+        if (merger.run() == 0)
+            return;
+
+        _builder->composeMapping(std::move(merger.getMapping()));
+
+#ifndef NDEBUG
+        if (!_builder->validateSubgraph()) {
+            llvm::errs() << "Pointer Subgraph is broken!\n";
+            llvm::errs() << "This happend after merging equivalent values.\n";
+            abort();
+        }
+#endif // NDEBUG
+    }
+
+    template <typename PTType>
+    void optimizeSubgraph()
+    {
+        if (std::is_base_of<analysis::pta::PointerAnalysisFI, PTType>::value)
+            mergeEquivalentValues(true);
+    }
+
     template <typename PTType>
     void run()
     {
         buildSubgraph();
+        optimizeSubgraph<PTType>();
 
-        LLVMPointerAnalysisImpl<PTType> PTA(PS, _builder.get());
+        LLVMPointerAnalysisImpl<PTType> PTA(PS, _builder.get(), _options);
         PTA.run();
+        _statistics = PTA.getStatistics();
     }
 
     // this method creates PointerAnalysis object and returns it.
@@ -282,7 +343,8 @@ public:
     analysis::pta::PointerAnalysis *createPTA()
     {
         buildSubgraph();
-        return new LLVMPointerAnalysisImpl<PTType>(PS, _builder.get());
+        optimizeSubgraph<PTType>();
+        return new LLVMPointerAnalysisImpl<PTType>(PS, _builder.get(), _options);
     }
 };
 
@@ -294,8 +356,9 @@ inline void LLVMPointerAnalysis::run<analysis::pta::PointerAnalysisFSInv>()
     _builder->setInvalidateNodesFlag(true);
     buildSubgraph();
 
-    LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv> PTA(PS, _builder.get());
+    LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv> PTA(PS, _builder.get(), _options);
     PTA.run();
+    _statistics = PTA.getStatistics();
 }
 
 template <>
@@ -306,7 +369,7 @@ inline analysis::pta::PointerAnalysis *LLVMPointerAnalysis::createPTA<analysis::
     _builder->setInvalidateNodesFlag(true);
     buildSubgraph();
 
-    return new LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv>(PS, _builder.get());
+    return new LLVMPointerAnalysisImpl<analysis::pta::PointerAnalysisFSInv>(PS, _builder.get(), _options);
 }
 
 } // namespace dg
@@ -40,7 +40,7 @@ using PSNodesSeq = std::pair<PSNode *, PSNode *>;
 
 class LLVMPointerSubgraphBuilder
 {
-    PointerSubgraph PS{};
+    PointerSubgraph PS;
     // mapping from llvm values to PSNodes that contain
     // the points-to information
     PointsToMapping<const llvm::Value *> mapping;
@@ -122,7 +122,8 @@ public:
     inline bool threads() const { return threads_; }
 
     LLVMPointerSubgraphBuilder(const llvm::Module *m, const LLVMPointerAnalysisOptions& opts)
-        : M(m), DL(new llvm::DataLayout(m)), _options(opts), threads_(opts.threads) {}
+        : PS(opts.pointsToSetKind), M(m), DL(new llvm::DataLayout(m)),
+          _options(opts), threads_(opts.threads) {}
 
     ~LLVMPointerSubgraphBuilder();
 
@@ -189,6 +190,16 @@ public:
     }
 
     void composeMapping(PointsToMapping<PSNode *>&& rhs) {
+        // the nodes in 'rhs' were removed from the graph, use
+        // the nodes that replaced them also for looking up operands
+        // (the graph may be still built during the analysis)
+        for (auto& it : nodes_map) {
+            if (PSNode *nd = rhs.get(it.second.first))
+                it.second.first = nd;
+            if (PSNode *nd = rhs.get(it.second.second))
+                it.second.second = nd;
+        }
+
         mapping.compose(std::move(rhs));
     }
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "dg/analysis/PointsTo/Pointer.h"
 #include "dg/analysis/PointsTo/PointsToSet.h"
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
@@ -20,17 +22,34 @@ PSNode *INVALIDATED = &INVALIDATED_LOC;
 const Pointer UnknownPointer(UNKNOWN_MEMORY, Offset::UNKNOWN);
 const Pointer NullPointer(NULLPTR, 0);
 
-// Return true if it makes sense to dereference this pointer.
-// PTA is over-approximation, so this is a filter.
-static inline bool canBeDereferenced(const Pointer& ptr)
+bool PointerAnalysis::operandChanged(PSNode *node, size_t idx)
 {
-    if (!ptr.isValid() || ptr.isInvalidated() || ptr.isUnknown())
+    if (node->getID() >= seen_inputs.size())
+        seen_inputs.resize(node->getID() + 1);
+
+    auto& seen = seen_inputs[node->getID()].operands;
+    if (seen.size() <= idx)
+        seen.resize(node->operands.size());
+
+    const PSNode *op = node->getOperand(idx);
+    if (seen[idx].first == op && seen[idx].second == op->pointsToVersion)
         return false;
 
-    // if the pointer points to a function, we can not dereference it
-    if (ptr.target->getType() == PSNodeType::FUNCTION)
+    seen[idx] = {op, op->pointsToVersion};
+    return true;
+}
+
+bool PointerAnalysis::memoryChanged(PSNode *node)
+{
+    if (node->getID() >= seen_inputs.size())
+        seen_inputs.resize(node->getID() + 1);
+
+    auto& seen = seen_inputs[node->getID()];
+    if (seen.memorySeen && seen.memory == memory_version)
         return false;
 
+    seen.memorySeen = true;
+    seen.memory = memory_version;
     return true;
 }
 
@@ -169,9 +188,12 @@ bool PointerAnalysis::processMemcpy(PSNode *node)
                 return changed;
             }
 
-            changed |= processMemcpy(srcObjects, destObjects,
-                                     ptr, dptr,
-                                     memcpy->getLength());
+            if (processMemcpy(srcObjects, destObjects,
+                              ptr, dptr, memcpy->getLength())) {
+                changed = true;
+                for (MemoryObject *o : destObjects)
+                    objectChanged(o);
+            }
         }
     }
 
@@ -267,6 +289,10 @@ bool PointerAnalysis::processGep(PSNode *node) {
     PSNodeGep *gep = PSNodeGep::get(node);
     assert(gep && "Non-GEP given");
 
+    // the source did not change, we already have all the pointers
+    if (!operandChanged(node, 0))
+        return false;
+
     for (const Pointer& ptr : gep->getSource()->pointsTo) {
         Offset::type new_offset;
         if (ptr.offset.isUnknown() || gep->getOffset().isUnknown())
@@ -299,9 +325,16 @@ bool PointerAnalysis::processNode(PSNode *node)
 
     switch(node->type) {
         case PSNodeType::LOAD:
-            changed |= processLoad(node);
+            // evaluate both, both must remember the current state
+            if ((operandChanged(node, 0) | memoryChanged(node))
+                || !memoryChangesOnlyByStores())
+                changed |= processLoad(node);
             break;
         case PSNodeType::STORE:
+            if (!(operandChanged(node, 0) | operandChanged(node, 1))
+                && memoryChangesOnlyByStores())
+                break;
+
             for (const Pointer& ptr : node->getOperand(1)->pointsTo) {
                 assert(ptr.target && "Got nullptr as target");
 
@@ -311,10 +344,16 @@ bool PointerAnalysis::processNode(PSNode *node)
                 objects.clear();
                 getMemoryObjects(node, ptr, objects);
                 for (MemoryObject *o : objects) {
-                    changed |= o->addPointsTo(ptr.offset,
-                                              node->getOperand(0)->pointsTo);
+                    if (o->addPointsTo(ptr.offset,
+                                       node->getOperand(0)->pointsTo)) {
+                        changed = true;
+                        objectChanged(o);
+                    }
                 }
             }
+
+            if (changed)
+                ++memory_version;
             break;
         case PSNodeType::INVALIDATE_OBJECT:
         case PSNodeType::FREE:
@@ -328,8 +367,16 @@ bool PointerAnalysis::processNode(PSNode *node)
             changed |= processGep(node);
             break;
         case PSNodeType::CAST:
+            if (PSNode *rep = getCycleRep(node)) {
+                changed |= processCycleMember(node, rep);
+                break;
+            }
+
             // cast only copies the pointers
-            changed |= node->addPointsTo(node->getOperand(0)->pointsTo);
+            if (operandChanged(node, 0)) {
+                changed |= node->addPointsTo(node->getOperand(0)->pointsTo);
+                changed |= detectCycle(node, node->getOperand(0));
+            }
             break;
         case PSNodeType::CONSTANT:
             // maybe warn? It has no sense to insert the constants into the graph.
@@ -340,6 +387,8 @@ bool PointerAnalysis::processNode(PSNode *node)
             break;
         case PSNodeType::CALL_RETURN:
             if (options.invalidateNodes) {
+                // NOTE: do not skip unchanged operands here,
+                // the operands are merged (and remembered) below
                 for (PSNode *op : node->operands) {
                     for (const Pointer& ptr : op->pointsTo) {
                         if (!canBeDereferenced(ptr))
@@ -357,14 +406,31 @@ bool PointerAnalysis::processNode(PSNode *node)
             // gather pointers returned from subprocedure - the same way
             // as PHI works
         case PSNodeType::PHI:
-            for (PSNode *op : node->operands)
-                changed |= node->addPointsTo(op->pointsTo);
+            if (PSNode *rep = getCycleRep(node)) {
+                changed |= processCycleMember(node, rep);
+                break;
+            }
+
+            // merge only the operands that changed
+            for (size_t i = 0; i < node->operands.size(); ++i) {
+                if (operandChanged(node, i)) {
+                    changed |= node->addPointsTo(node->operands[i]->pointsTo);
+                    changed |= detectCycle(node, node->operands[i]);
+                }
+            }
             break;
         case PSNodeType::CALL_FUNCPTR:
             // call via function pointer:
             // first gather the pointers that can be used to the
             // call and if something changes, let backend take some action
             // (for example build relevant subgraph)
+            if (!operandChanged(node, 0))
+                break;
+
+            {
+            // the newly called functions are connected to the graph
+            // at once, so that the SCCs are updated only once
+            std::vector<PSNode *> called;
             for (const Pointer& ptr : node->getOperand(0)->pointsTo) {
                 // do not add pointers that do not point to functions
                 // (but do not do that when we are looking for invalidated
@@ -373,18 +439,30 @@ bool PointerAnalysis::processNode(PSNode *node)
                     && ptr.target->getType() != PSNodeType::FUNCTION)
                     continue;
 
+                const bool valid = ptr.isValid() && !ptr.isInvalidated();
+                // the function may be called already (with another offset)
+                const bool known = valid &&
+                                   node->pointsTo.pointsToTarget(ptr.target);
                 if (node->addPointsTo(ptr)) {
                     changed = true;
 
-                    if (ptr.isValid() && !ptr.isInvalidated()) {
-                        if (functionPointerCall(node, ptr.target))
-                            recomputeSCCs();
-                    } else {
+                    if (!valid) {
                         error(node, "Calling invalid pointer as a function!");
                         continue;
                     }
+
+                    if (!known)
+                        called.push_back(ptr.target);
                 }
             }
+
+            if (!called.empty()) {
+                unsigned first_new_id = PS->size();
+                std::vector<PSNode *> successors = node->getSuccessors();
+                if (functionPointerCalls(node, called))
+                    updateSCCs(node, successors, first_new_id);
+            }
+            }
             break;
         case PSNodeType::FORK:
             changed |= handleFork(node);
@@ -393,7 +471,13 @@ bool PointerAnalysis::processNode(PSNode *node)
             changed |= handleJoin(node);
             break;
         case PSNodeType::MEMCPY:
-            changed |= processMemcpy(node);
+            if ((operandChanged(node, 0) | operandChanged(node, 1)
+                 | memoryChanged(node)) || !memoryChangesOnlyByStores()) {
+                if (processMemcpy(node)) {
+                    changed = true;
+                    ++memory_version;
+                }
+            }
             break;
         case PSNodeType::ALLOC:
         case PSNodeType::DYN_ALLOC:
@@ -422,6 +506,715 @@ bool PointerAnalysis::processNode(PSNode *node)
     return changed;
 }
 
+bool PointerAnalysis::isCopyNode(const PSNode *n) const
+{
+    switch (n->getType()) {
+        case PSNodeType::PHI:
+        case PSNodeType::CAST:
+        case PSNodeType::RETURN:
+            return true;
+        case PSNodeType::CALL_RETURN:
+            // adds pointers to invalidated memory
+            return !options.invalidateNodes;
+        default:
+            return false;
+    }
+}
+
+bool PointerAnalysis::detectCycle(PSNode *node, PSNode *operand)
+{
+    // Lazy cycle detection: if the node has the same points-to set
+    // as its operand after merging it, the two may lie on a cycle.
+    // Search for it only once for every copy edge.
+    // (the node copying itself, e.g. a PHI in a loop, is not a cycle to collapse)
+    if (!collapsingCycles() || !isCopyNode(operand) || operand == node)
+        return false;
+    // the node has become the representative of a cycle while merging
+    // its previous operands, the operand may be on this cycle already
+    if (getCycleRep(node) && getCycleRep(node) == getCycleRep(operand))
+        return false;
+    if (operand->pointsTo.empty() ||
+        operand->pointsTo.size() != node->pointsTo.size())
+        return false;
+    if (!cycle_checked.emplace(operand->getID(), node->getID()).second)
+        return false;
+
+    // the copy nodes reachable from the node by copy edges
+    std::set<PSNode *> reachable{node};
+    std::vector<PSNode *> stack{node};
+    while (!stack.empty()) {
+        PSNode *cur = stack.back();
+        stack.pop_back();
+        for (PSNode *user : cur->getUsers()) {
+            if (isCopyNode(user) && reachable.insert(user).second)
+                stack.push_back(user);
+        }
+    }
+
+    if (reachable.count(operand) == 0)
+        return false;
+
+    // the cycle is formed by the reachable nodes
+    // from which we can get back to the node
+    std::set<PSNode *> cycle{node};
+    stack.push_back(node);
+    while (!stack.empty()) {
+        PSNode *cur = stack.back();
+        stack.pop_back();
+        for (PSNode *op : cur->operands) {
+            if (reachable.count(op) > 0 && cycle.insert(op).second)
+                stack.push_back(op);
+        }
+    }
+
+    assert(cycle.size() > 1 && "The operand is not on the cycle");
+    // the node is not a member of another cycle (otherwise we would not
+    // get here), so it becomes (or stays) the representative
+    assert(!getCycleRep(node) || getCycleRep(node) == node);
+    return collapseCycle(node,
+                         std::vector<PSNode *>(cycle.begin(), cycle.end()));
+}
+
+bool PointerAnalysis::collapseCycle(PSNode *rep,
+                                    const std::vector<PSNode *>& nodes)
+{
+    bool changed = false;
+    auto setRep = [this](PSNode *n, PSNode *r) {
+        if (n->getID() >= cycle_rep.size())
+            cycle_rep.resize(n->getID() + 1, nullptr);
+        cycle_rep[n->getID()] = r;
+    };
+
+    auto& members = cycle_members[rep->getID()];
+    if (members.empty()) {
+        setRep(rep, rep);
+        members.push_back(rep);
+        ++statistics.collapsedNodes;
+    }
+
+    for (PSNode *n : nodes) {
+        PSNode *old = getCycleRep(n);
+        if (old == rep)
+            continue;
+
+        if (!old) {
+            setRep(n, rep);
+            members.push_back(n);
+            changed |= rep->addPointsTo(n->pointsTo);
+            ++statistics.collapsedNodes;
+            continue;
+        }
+
+        // merge the cycles
+        auto it = cycle_members.find(old->getID());
+        assert(it != cycle_members.end());
+        for (PSNode *m : it->second) {
+            setRep(m, rep);
+            members.push_back(m);
+            changed |= rep->addPointsTo(m->pointsTo);
+        }
+        cycle_members.erase(it);
+    }
+
+    ++cycles_version;
+    return changed;
+}
+
+bool PointerAnalysis::processCycleMember(PSNode *node, PSNode *rep)
+{
+    bool changed = false;
+
+    // gather the pointers coming from outside of the cycle
+    // in the representative
+    for (size_t i = 0; i < node->operands.size(); ++i) {
+        PSNode *op = node->operands[i];
+        if (getCycleRep(op) == rep)
+            continue;
+        if (operandChanged(node, i))
+            changed |= rep->addPointsTo(op->pointsTo);
+    }
+
+    return changed;
+}
+
+bool PointerAnalysis::syncCycleMember(PSNode *node)
+{
+    PSNode *rep = getCycleRep(node);
+    if (!rep || rep == node)
+        return false;
+
+    if (node->getID() >= cycle_synced.size())
+        cycle_synced.resize(node->getID() + 1, {nullptr, 0});
+
+    auto& synced = cycle_synced[node->getID()];
+    if (synced.first == rep && synced.second == rep->pointsToVersion)
+        return false;
+
+    synced = {rep, rep->pointsToVersion};
+    return node->addPointsTo(rep->pointsTo);
+}
+
+void PointerAnalysis::syncCycleMembers()
+{
+    for (auto& it : cycle_members) {
+        for (PSNode *m : it.second)
+            syncCycleMember(m);
+    }
+}
+
+void PointerAnalysis::addNewSCCs(PSNode *callsite, unsigned first_new_id)
+{
+    // the nodes that were not visited by any computation of SCCs
+    // have dfs_id 0, compute the components of these nodes only
+    SCC<PSNode> scc_comp(0, sccs_index);
+    SCC<PSNode>::SCC_t *comps = nullptr;
+    auto visit = [&](PSNode *n) {
+        if (n->dfs_id == 0)
+            comps = &scc_comp.compute(n);
+    };
+
+    for (PSNode *succ : callsite->getSuccessors())
+        visit(succ);
+    const auto& nodes = PS->getNodes();
+    for (unsigned id = first_new_id; id < nodes.size(); ++id) {
+        if (nodes[id])
+            visit(nodes[id].get());
+    }
+
+    if (!comps)
+        return;
+
+    sccs_index = scc_comp.getIndex();
+
+    // the components are in the reverse topological order,
+    // place them right after the component of the callsite
+    // (if the callsite is not reachable, the new edges place them)
+    std::vector<unsigned> ids;
+    ids.reserve(comps->size());
+    for (unsigned i = comps->size(); i > 0; --i) {
+        const auto comp = (*comps)[i - 1];
+        unsigned id = SCCs.add(comp.begin(), comp.end());
+        for (PSNode *n : comp)
+            n->scc_id = id;
+        numberSCC(id);
+        ids.push_back(id);
+    }
+
+    scc_pos.resize(SCCs.size());
+    scc_marks.resize(SCCs.size(), 0);
+    insertSCCs(inSCCs(callsite) ? callsite->getSCCId() : UNORDERED, ids);
+}
+
+void PointerAnalysis::insertSCCs(unsigned after, const std::vector<unsigned>& ids)
+{
+    if (ids.empty())
+        return;
+
+    // The components between 'first' and 'last' get new positions
+    // together with the new components. Grow this window until
+    // there is room for all of them, so that only the neighbours
+    // of the new components move (usually none of them).
+    const uint64_t END = static_cast<uint64_t>(1) << 32;
+    auto first = after == UNORDERED ? scc_order.end()
+                                    : std::next(scc_order.find(scc_pos[after]));
+    auto last = first;
+    size_t num = ids.size();
+    uint64_t lo, hi;
+    for (size_t grow = 1; ; grow *= 2) {
+        lo = first == scc_order.begin() ? 0 : std::prev(first)->first;
+        hi = last == scc_order.end() ? END : last->first;
+        // leave some room for the next insertions
+        if (hi - lo > 2 * (num + 1) ||
+            (first == scc_order.begin() && last == scc_order.end()))
+            break;
+
+        for (size_t i = 0; i < grow && first != scc_order.begin(); ++i) {
+            --first;
+            ++num;
+        }
+        for (size_t i = 0; i < grow && last != scc_order.end(); ++i) {
+            ++last;
+            ++num;
+        }
+    }
+    assert(hi - lo > num && "No room for the components");
+
+    std::vector<unsigned> window;
+    window.reserve(num);
+    bool inserted = false;
+    for (auto it = first; it != last; ++it) {
+        window.push_back(it->second);
+        if (it->second == after) {
+            window.insert(window.end(), ids.begin(), ids.end());
+            inserted = true;
+        }
+    }
+    if (!inserted) {
+        // 'after' is right before the window or the window is at the end
+        window.insert(after == UNORDERED ? window.end() : window.begin(),
+                      ids.begin(), ids.end());
+    }
+    assert(window.size() == num);
+
+    // spread the positions evenly in the window
+    auto hint = scc_order.erase(first, last);
+    for (size_t i = 0; i < num; ++i) {
+        unsigned pos = lo + (hi - lo) * (i + 1) / (num + 1);
+        scc_pos[window[i]] = pos;
+        scc_order.emplace_hint(hint, pos, window[i]);
+    }
+}
+
+unsigned PointerAnalysis::mergeSCCs(std::vector<unsigned>& components)
+{
+    // keep the nodes in the topological order of the merged
+    // components (the nodes are stored in the reverse order)
+    std::sort(components.begin(), components.end(),
+              [this](unsigned a, unsigned b) { return scc_pos[a] > scc_pos[b]; });
+
+    unsigned to = components.back();
+    std::vector<PSNode *> merged;
+    for (unsigned id : components) {
+        for (PSNode *n : SCCs[id]) {
+            n->scc_id = to;
+            merged.push_back(n);
+        }
+        SCCs.clear(id);
+    }
+
+    SCCs.assign(to, merged);
+    numberSCC(to);
+    return to;
+}
+
+void PointerAnalysis::addSCCEdge(PSNode *from, PSNode *to)
+{
+    enum : unsigned char { FORWARD = 1, BACKWARD = 2 };
+
+    const unsigned U = from->getSCCId();
+    const unsigned V = to->getSCCId();
+    if (U == V || scc_pos[U] < scc_pos[V])
+        return;
+
+    // The edge breaks the order. Search the components between V and U
+    // in the order: the components reachable from V and the components
+    // from which U is reachable. Moving the latter before the former
+    // fixes the order. If U is reachable from V, the edge closes a cycle.
+    const unsigned lb = scc_pos[V];
+    const unsigned ub = scc_pos[U];
+    auto inWindow = [&](unsigned id) {
+        return scc_pos[id] > lb && scc_pos[id] < ub;
+    };
+
+    bool cycle = false;
+    std::vector<unsigned> forward{V};
+    scc_marks[V] |= FORWARD;
+    for (size_t i = 0; i < forward.size(); ++i) {
+        for (PSNode *n : SCCs[forward[i]]) {
+            for (PSNode *succ : n->getSuccessors()) {
+                if (!inSCCs(succ))
+                    continue;
+                unsigned id = succ->getSCCId();
+                if (id == U) {
+                    cycle = true;
+                    continue;
+                }
+                if ((scc_marks[id] & FORWARD) || !inWindow(id))
+                    continue;
+                scc_marks[id] |= FORWARD;
+                forward.push_back(id);
+            }
+        }
+    }
+
+    std::vector<unsigned> backward{U};
+    scc_marks[U] |= BACKWARD;
+    for (size_t i = 0; i < backward.size(); ++i) {
+        for (PSNode *n : SCCs[backward[i]]) {
+            for (PSNode *pred : n->getPredecessors()) {
+                if (!inSCCs(pred))
+                    continue;
+                unsigned id = pred->getSCCId();
+                if ((scc_marks[id] & BACKWARD) || !inWindow(id))
+                    continue;
+                scc_marks[id] |= BACKWARD;
+                backward.push_back(id);
+            }
+        }
+    }
+
+    // the positions that the components take
+    std::vector<unsigned> slots;
+    slots.reserve(forward.size() + backward.size());
+    for (unsigned id : forward)
+        slots.push_back(scc_pos[id]);
+    for (unsigned id : backward) {
+        if (!(scc_marks[id] & FORWARD))
+            slots.push_back(scc_pos[id]);
+    }
+    std::sort(slots.begin(), slots.end());
+
+    auto byPos = [this](unsigned a, unsigned b) { return scc_pos[a] < scc_pos[b]; };
+    std::sort(forward.begin(), forward.end(), byPos);
+    std::sort(backward.begin(), backward.end(), byPos);
+
+    // the components on the cycle (reachable from V and reaching U)
+    std::vector<unsigned> cycle_components;
+    if (cycle) {
+        for (unsigned id : forward) {
+            if (id == V || (scc_marks[id] & BACKWARD))
+                cycle_components.push_back(id);
+        }
+        cycle_components.push_back(U);
+    }
+
+    for (unsigned id : forward)
+        scc_marks[id] = 0;
+    for (unsigned id : backward)
+        scc_marks[id] = 0;
+
+    std::vector<unsigned> new_order;
+    new_order.reserve(slots.size());
+    if (!cycle) {
+        new_order.insert(new_order.end(), backward.begin(), backward.end());
+        new_order.insert(new_order.end(), forward.begin(), forward.end());
+    } else {
+        for (unsigned id : cycle_components)
+            scc_marks[id] = FORWARD;
+        for (unsigned id : backward) {
+            if (!scc_marks[id])
+                new_order.push_back(id);
+        }
+        // the merged component goes between the others, the emptied
+        // components take the positions right after it, so that
+        // the other components do not move in the wrong direction
+        std::vector<unsigned> merged = cycle_components;
+        new_order.push_back(mergeSCCs(merged));
+        for (unsigned id : cycle_components) {
+            if (SCCs[id].empty())
+                new_order.push_back(id);
+        }
+        for (unsigned id : forward) {
+            if (!scc_marks[id])
+                new_order.push_back(id);
+        }
+        for (unsigned id : cycle_components)
+            scc_marks[id] = 0;
+    }
+
+    assert(new_order.size() == slots.size());
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const unsigned id = new_order[i];
+        scc_pos[id] = slots[i];
+        // the merged components are dropped from the order
+        if (SCCs[id].empty())
+            scc_order.erase(slots[i]);
+        else
+            scc_order[slots[i]] = id;
+    }
+}
+
+bool PointerAnalysis::stillConnected(PSNode *from, PSNode *to)
+{
+    assert(from->getSCCId() == to->getSCCId());
+    const unsigned id = from->getSCCId();
+
+    std::set<PSNode *> visited{from};
+    std::vector<PSNode *> stack{from};
+    while (!stack.empty()) {
+        PSNode *cur = stack.back();
+        stack.pop_back();
+        for (PSNode *succ : cur->getSuccessors()) {
+            if (succ == to)
+                return true;
+            if (succ->getSCCId() == id && inSCCs(succ) &&
+                visited.insert(succ).second)
+                stack.push_back(succ);
+        }
+    }
+
+    return false;
+}
+
+void PointerAnalysis::updateSCCs(PSNode *callsite,
+                                 const std::vector<PSNode *>& old_successors,
+                                 unsigned first_new_id)
+{
+    const unsigned first_new_scc = SCCs.size();
+    addNewSCCs(callsite, first_new_id);
+
+    auto isNew = [first_new_scc](const PSNode *n) {
+        return n->getSCCId() >= first_new_scc;
+    };
+
+    // the new edges that connect the new nodes to the rest of the graph
+    // (gather them before the components get merged)
+    std::vector<std::pair<PSNode *, PSNode *>> edges;
+    for (unsigned id = first_new_scc; id < SCCs.size(); ++id) {
+        for (PSNode *n : SCCs[id]) {
+            for (PSNode *succ : n->getSuccessors()) {
+                if (inSCCs(succ) && !isNew(succ))
+                    edges.emplace_back(n, succ);
+            }
+            for (PSNode *pred : n->getPredecessors()) {
+                if (inSCCs(pred) && !isNew(pred))
+                    edges.emplace_back(pred, n);
+            }
+        }
+    }
+
+    // the callsite may be unreachable (e.g. it follows a call
+    // of a function that does not return), the new nodes
+    // may be still reachable from a called function
+    const bool reachable = inSCCs(callsite);
+    for (PSNode *succ : callsite->getSuccessors()) {
+        if (reachable && inSCCs(succ) && !isNew(succ) &&
+            std::find(old_successors.begin(), old_successors.end(), succ)
+                == old_successors.end())
+            edges.emplace_back(callsite, succ);
+    }
+
+    for (auto& edge : edges)
+        addSCCEdge(edge.first, edge.second);
+
+    // Removing an edge can split a component. That does not happen
+    // if the target of the edge is still reachable inside of the component
+    // (e.g. through the called function), otherwise compute the SCCs again.
+    const auto& successors = callsite->getSuccessors();
+    for (PSNode *succ : old_successors) {
+        if (std::find(successors.begin(), successors.end(), succ)
+                != successors.end())
+            continue;
+
+        if (reachable && inSCCs(succ) &&
+            succ->getSCCId() == callsite->getSCCId() &&
+            !stillConnected(callsite, succ)) {
+            computeSCCs();
+            return;
+        }
+    }
+}
+
+// can processing the node add nodes or edges to the PointerSubgraph?
+static inline bool canChangeGraph(const PSNode *node)
+{
+    return node->getType() == PSNodeType::CALL_FUNCPTR ||
+           node->getType() == PSNodeType::FORK ||
+           node->getType() == PSNodeType::JOIN;
+}
+
+void PointerAnalysis::solveWorklist()
+{
+    ADT::SparsePriorityWorklist<PSNode *> worklist;
+    // the nodes that have been processed at least once
+    std::vector<bool> visited;
+    // the nodes whose predecessor changed the memory
+    std::vector<bool> memory_input;
+    // When the memory is shared by the whole program, loads and memcpy
+    // nodes are indexed by the memory objects that their pointer operand
+    // may point to and only the readers of changed objects are re-checked.
+    std::unordered_map<const MemoryObject *, std::vector<PSNode *>> object_readers;
+    std::set<std::pair<const MemoryObject *, const PSNode *>> registered_readers;
+    // the version of the pointer operand of a reader (indexed by ID)
+    // when the reader was registered for its targets
+    std::vector<std::pair<const PSNode *, unsigned>> readers_versions;
+    std::vector<MemoryObject *> objects;
+    // the readers of changed objects that precede the node that changed
+    // the objects are processed in the next pass over the nodes, so that
+    // they merge the memory once per pass and not after every store
+    ADT::SparsePriorityWorklist<PSNode *> next_pass;
+    // forks and joins read points-to sets of nodes that
+    // are not their operands, so we re-check them
+    // whenever the worklist gets empty
+    std::vector<PSNode *> forks_joins;
+
+    // the nodes changed while processing a node, processing
+    // a node may change also other nodes than the processed one
+    // (e.g. the hooks for calls via function pointers set
+    // the points-to sets of the call-return nodes)
+    PSNode::ChangesLog changes;
+
+    auto registerReader = [&](PSNode *reader) {
+        PSNode *ptr = reader->getType() == PSNodeType::LOAD
+                        ? reader->getOperand(0)
+                        : PSNodeMemcpy::get(reader)->getSource();
+        size_t id = reader->getID();
+        if (id >= readers_versions.size())
+            readers_versions.resize(id + 1, {nullptr, 0});
+
+        auto& seen = readers_versions[id];
+        if (seen.first == ptr && seen.second == ptr->pointsToVersion)
+            return;
+        seen = {ptr, ptr->pointsToVersion};
+
+        for (const Pointer& p : ptr->pointsTo) {
+            if (!canBeDereferenced(p))
+                continue;
+
+            objects.clear();
+            getMemoryObjects(reader, p, objects);
+            for (MemoryObject *o : objects) {
+                if (registered_readers.emplace(o, reader).second)
+                    object_readers[o].push_back(reader);
+            }
+        }
+    };
+
+    record_changed_objects = memoryChangesOnlyByStores();
+
+    auto push = [&](PSNode *n, bool memory) {
+        if (memory) {
+            if (n->getID() >= memory_input.size())
+                memory_input.resize(n->getID() + 1, false);
+            memory_input[n->getID()] = true;
+        }
+        worklist.push(n, getPriority(n));
+    };
+
+    for (PSNode *n : PS->getNodes(PS->getRoot()))
+        push(n, false);
+
+    bool progress = false;
+    uint64_t last_priority = 0;
+    if (!worklist.empty())
+        ++statistics.iterations;
+
+    while (true) {
+        while (!worklist.empty() || !next_pass.empty()) {
+            if (worklist.empty()) {
+                while (!next_pass.empty())
+                    push(next_pass.pop(), false);
+            }
+
+            PSNode *cur = worklist.pop();
+            size_t id = cur->getID();
+
+            uint64_t priority = getPriority(cur);
+            if (priority < last_priority)
+                ++statistics.iterations;
+            last_priority = priority;
+
+            if (id >= visited.size())
+                visited.resize(id + 1, false);
+            if (id >= memory_input.size())
+                memory_input.resize(id + 1, false);
+
+            bool first = !visited[id];
+            bool memory_in = memory_input[id];
+            visited[id] = true;
+            memory_input[id] = false;
+
+            if (first && (cur->getType() == PSNodeType::FORK ||
+                          cur->getType() == PSNodeType::JOIN))
+                forks_joins.push_back(cur);
+
+            // the members of cycles that the node reads
+            // must have the set of the cycle
+            syncOperands(cur);
+
+            unsigned version = cur->pointsToVersion;
+            PSNode *rep = getCycleRep(cur);
+            unsigned rep_version = rep ? rep->pointsToVersion : 0;
+            unsigned cycles = cycles_version;
+
+            changes.clear();
+            changed_objects.clear();
+            bool changed = beforeProcessed(cur);
+            changed |= processNode(cur);
+            bool after_changed = afterProcessed(cur);
+            changed |= after_changed;
+            ++statistics.processedNodes;
+
+            progress |= changed;
+
+            // the nodes that use the points-to set of this node
+            if (cur->pointsToVersion != version) {
+                for (PSNode *user : cur->getUsers())
+                    push(user, false);
+            }
+
+            PSNode *last = cur;
+            for (PSNode *n : changes.getNodes()) {
+                if (n == cur || n == last)
+                    continue;
+                last = n;
+                for (PSNode *user : n->getUsers())
+                    push(user, false);
+            }
+
+            // the points-to set of the cycle of this node changed
+            // (or the cycle has just been created), the nodes
+            // that read any member of the cycle must see it
+            PSNode *new_rep = getCycleRep(cur);
+            if (new_rep && (new_rep != rep ||
+                            cycles_version != cycles ||
+                            new_rep->pointsToVersion != rep_version)) {
+                for (PSNode *m : cycle_members[new_rep->getID()]) {
+                    for (PSNode *user : m->getUsers()) {
+                        if (getCycleRep(user) != new_rep)
+                            push(user, false);
+                    }
+                }
+            }
+
+            if (memoryChangesOnlyByStores()) {
+                // the memory is shared by all nodes, re-check
+                // the nodes that read the changed objects
+                if (cur->getType() == PSNodeType::LOAD ||
+                    cur->getType() == PSNodeType::MEMCPY)
+                    registerReader(cur);
+
+                for (MemoryObject *o : changed_objects) {
+                    auto it = object_readers.find(o);
+                    if (it == object_readers.end())
+                        continue;
+                    for (PSNode *reader : it->second) {
+                        if (getPriority(reader) > priority)
+                            push(reader, false);
+                        else
+                            next_pass.push(reader, getPriority(reader));
+                    }
+                }
+
+                // successors matter only if they were not
+                // processed yet (possibly new nodes)
+                if (first || (changed && canChangeGraph(cur))) {
+                    for (PSNode *succ : cur->getSuccessors())
+                        push(succ, false);
+                }
+            } else {
+                // the memory of this node may have changed after
+                // the node was processed (e.g. by merging the memory
+                // of predecessors), so process it again
+                if (after_changed)
+                    push(cur, true);
+
+                // the memory (or the graph) may have changed,
+                // the successors need to see it
+                if (first || changed ||
+                    (memory_in && usesPredecessorsMemory(cur))) {
+                    for (PSNode *succ : cur->getSuccessors())
+                        push(succ, true);
+                }
+            }
+        }
+
+        if (!progress || forks_joins.empty())
+            break;
+
+        // forks and joins may read the members of cycles
+        // that are not their operands
+        syncCycleMembers();
+
+        progress = false;
+        for (PSNode *n : forks_joins)
+            push(n, false);
+    }
+
+    record_changed_objects = false;
+    syncCycleMembers();
+}
+
 void PointerAnalysis::sanityCheck() {
 #ifndef NDEBUG
     assert(NULLPTR->pointsTo.size() == 1
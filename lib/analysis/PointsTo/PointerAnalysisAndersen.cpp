@@ -0,0 +1,478 @@
+#include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointsToSet.h"
+#include "dg/analysis/PointsTo/PointerSubgraph.h"
+#include "dg/analysis/PointsTo/PointerAnalysisAndersen.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+void PointerAnalysisAndersen::queue(PSNode *node)
+{
+    // special nodes (null, unknown memory) never change
+    if (!isGraphNode(node))
+        return;
+
+    if (node->getID() >= node_queued.size())
+        node_queued.resize(node->getID() + 1, false);
+
+    if (!node_queued[node->getID()]) {
+        node_queued[node->getID()] = true;
+        node_worklist.push_back(node);
+    }
+}
+
+void PointerAnalysisAndersen::queue(unsigned loc)
+{
+    if (loc >= loc_queued.size())
+        loc_queued.resize(loc + 1, false);
+
+    if (!loc_queued[loc]) {
+        loc_queued[loc] = true;
+        loc_worklist.push_back(loc);
+    }
+}
+
+void PointerAnalysisAndersen::addConstraint(Constraint::Kind kind,
+                                            PSNode *node, PSNode *operand)
+{
+    size_t idx = constraints.size();
+    constraints.emplace_back(kind, node, operand);
+
+    auto addUse = [this, idx](PSNode *n) {
+        if (!isGraphNode(n))
+            return;
+        if (n->getID() >= uses.size())
+            uses.resize(n->getID() + 1);
+        uses[n->getID()].push_back(idx);
+    };
+
+    if (kind == Constraint::Kind::STORE || kind == Constraint::Kind::MEMCPY) {
+        addUse(node->getOperand(0));
+        addUse(node->getOperand(1));
+    } else {
+        addUse(operand);
+    }
+
+    new_constraints.push_back(idx);
+}
+
+void PointerAnalysisAndersen::extractConstraints(PSNode *node)
+{
+    if (node->getID() >= extracted.size())
+        extracted.resize(node->getID() + 1, -1);
+
+    int seen = extracted[node->getID()];
+    int operands = static_cast<int>(node->getOperandsNum());
+    if (seen == operands)
+        return;
+
+    bool first = seen < 0;
+    extracted[node->getID()] = operands;
+
+    // address-of constraints are the initial points-to sets
+    if (first && !node->pointsTo.empty())
+        queue(node);
+
+    switch (node->getType()) {
+        case PSNodeType::PHI:
+        case PSNodeType::CAST:
+        case PSNodeType::RETURN:
+        case PSNodeType::CALL_RETURN:
+            // the operands of these nodes are added
+            // when calls via pointers are resolved
+            for (int i = first ? 0 : seen; i < operands; ++i) {
+                if (node->getOperand(i) != node)
+                    addConstraint(Constraint::Kind::COPY, node,
+                                  node->getOperand(i));
+            }
+            break;
+        case PSNodeType::GEP:
+            if (first)
+                addConstraint(Constraint::Kind::GEP, node, node->getOperand(0));
+            break;
+        case PSNodeType::LOAD:
+            if (first)
+                addConstraint(Constraint::Kind::LOAD, node, node->getOperand(0));
+            break;
+        case PSNodeType::STORE:
+            if (first)
+                addConstraint(Constraint::Kind::STORE, node, node->getOperand(1));
+            break;
+        case PSNodeType::MEMCPY:
+            if (first)
+                addConstraint(Constraint::Kind::MEMCPY, node, node->getOperand(0));
+            break;
+        case PSNodeType::CALL_FUNCPTR:
+            if (first)
+                addConstraint(Constraint::Kind::CALL, node, node->getOperand(0));
+            break;
+        case PSNodeType::FORK:
+        case PSNodeType::JOIN:
+            if (first)
+                forks_joins.push_back(node);
+            break;
+        default:
+            // no constraints
+            break;
+    }
+}
+
+void PointerAnalysisAndersen::extractConstraints()
+{
+    for (PSNode *node : getPS()->getNodes(getPS()->getRoot()))
+        extractConstraints(node);
+}
+
+unsigned PointerAnalysisAndersen::getLocation(PSNode *object, Offset off)
+{
+    Object& obj = objects[object];
+    auto it = obj.fields.find(off);
+    if (it != obj.fields.end())
+        return it->second;
+
+    unsigned loc = locations.size();
+    locations.emplace_back(object, off);
+    obj.fields.emplace(off, loc);
+
+    // the loads from unknown offset read also this field
+    for (PSNode *reader : obj.wildcardReaders)
+        locations[loc].readers.insert(reader);
+    // memcpy may need to copy this field too
+    for (size_t mc : obj.memcpys)
+        new_constraints.push_back(mc);
+
+    return loc;
+}
+
+const PointsToSetT *
+PointerAnalysisAndersen::getMemoryPointsTo(PSNode *object, Offset off) const
+{
+    auto oit = objects.find(object);
+    if (oit == objects.end())
+        return nullptr;
+
+    auto it = oit->second.fields.find(off);
+    if (it == oit->second.fields.end())
+        return nullptr;
+
+    return &locations[it->second].pointsTo;
+}
+
+void PointerAnalysisAndersen::addToLocation(unsigned loc, const PointsToSetT& ptrs)
+{
+    if (!ptrs.empty() && locations[loc].pointsTo.add(ptrs))
+        queue(loc);
+}
+
+void PointerAnalysisAndersen::addToLocation(unsigned loc, const Pointer& ptr)
+{
+    if (locations[loc].pointsTo.add(ptr))
+        queue(loc);
+}
+
+void PointerAnalysisAndersen::addReader(unsigned loc, PSNode *reader)
+{
+    if (locations[loc].readers.insert(reader).second &&
+        reader->addPointsTo(locations[loc].pointsTo))
+        queue(reader);
+}
+
+void PointerAnalysisAndersen::addCopy(unsigned from, unsigned to)
+{
+    if (from == to)
+        return;
+
+    if (locations[from].copies.insert(to).second)
+        addToLocation(to, locations[from].pointsTo);
+}
+
+void PointerAnalysisAndersen::applyGep(PSNode *node)
+{
+    PSNodeGep *gep = PSNodeGep::get(node);
+    assert(gep && "Non-GEP given");
+
+    bool changed = false;
+    for (const Pointer& ptr : gep->getSource()->pointsTo) {
+        Offset::type new_offset;
+        if (ptr.offset.isUnknown() || gep->getOffset().isUnknown())
+            // set it like this to avoid overflow when adding
+            new_offset = Offset::UNKNOWN;
+        else
+            new_offset = *ptr.offset + *gep->getOffset();
+
+        // the same as in PointerAnalysis::processGep()
+        if ((new_offset == 0 || new_offset < ptr.target->getSize())
+            && new_offset < *getOptions().fieldSensitivity)
+            changed |= node->addPointsTo(ptr.target, new_offset);
+        else
+            changed |= node->addPointsTo(ptr.target, Offset::UNKNOWN);
+    }
+
+    if (changed)
+        queue(node);
+}
+
+void PointerAnalysisAndersen::applyLoad(PSNode *node)
+{
+    bool changed = false;
+    for (const Pointer& ptr : node->getOperand(0)->pointsTo) {
+        if (ptr.isUnknown()) {
+            // load from unknown pointer yields unknown pointer
+            changed |= node->addPointsTo(UnknownPointer);
+            continue;
+        }
+
+        if (!canBeDereferenced(ptr))
+            continue;
+
+        PSNode *object = getAllocationNode(ptr.target);
+        if (object->getType() == PSNodeType::FUNCTION)
+            continue;
+
+        // we do not know whether the memory is written
+        // before the load, so the load may read the zeros
+        PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
+        if (target && target->isZeroInitialized())
+            changed |= node->addPointsTo(NullPointer);
+
+        if (ptr.offset.isUnknown()) {
+            // read all the fields of the object, even the future ones
+            Object& obj = objects[object];
+            if (obj.wildcardReaders.insert(node).second) {
+                for (auto& it : obj.fields)
+                    addReader(it.second, node);
+            }
+        } else {
+            addReader(getLocation(object, ptr.offset), node);
+            // the pointers at unknown offset can be what we need too
+            addReader(getLocation(object, Offset::UNKNOWN), node);
+        }
+    }
+
+    if (changed)
+        queue(node);
+}
+
+void PointerAnalysisAndersen::applyStore(PSNode *node)
+{
+    PSNode *value = node->getOperand(0);
+    for (const Pointer& ptr : node->getOperand(1)->pointsTo) {
+        if (!canBeDereferenced(ptr))
+            continue;
+
+        PSNode *object = getAllocationNode(ptr.target);
+        if (object->getType() == PSNodeType::FUNCTION)
+            continue;
+
+        addToLocation(getLocation(object, ptr.offset), value->pointsTo);
+    }
+}
+
+void PointerAnalysisAndersen::applyMemcpy(size_t idx)
+{
+    PSNodeMemcpy *memcpy = PSNodeMemcpy::get(constraints[idx].node);
+    Offset len = memcpy->getLength();
+    assert(*len > 0 && "Memcpy of length 0");
+
+    for (const Pointer& sptr : memcpy->getSource()->pointsTo) {
+        if (!canBeDereferenced(sptr))
+            continue;
+
+        PSNode *srcObject = getAllocationNode(sptr.target);
+        if (srcObject->getType() == PSNodeType::FUNCTION)
+            continue;
+
+        // copy also the fields of the source that are created later
+        objects[srcObject].memcpys.insert(idx);
+
+        PSNodeAlloc *sourceAlloc = PSNodeAlloc::get(sptr.target);
+        assert(sourceAlloc && "Pointer's target in memcpy is not an allocation");
+        // if the source is zero initialized, we may copy null pointer
+        // somewhere to the destination
+        bool contains_null = sourceAlloc->isZeroInitialized();
+
+        for (const Pointer& dptr : memcpy->getDestination()->pointsTo) {
+            if (!canBeDereferenced(dptr))
+                continue;
+
+            PSNode *destObject = getAllocationNode(dptr.target);
+            if (destObject->getType() == PSNodeType::FUNCTION)
+                continue;
+
+            if (contains_null)
+                addToLocation(getLocation(destObject, Offset::UNKNOWN),
+                              NullPointer);
+
+            // creating the fields of the destination may create fields
+            // of the source (if it is the same object), so take a copy
+            std::vector<std::pair<Offset, unsigned>> fields(
+                                        objects[srcObject].fields.begin(),
+                                        objects[srcObject].fields.end());
+
+            Offset srcOffset = sptr.offset;
+            Offset destOffset = dptr.offset;
+            for (auto& field : fields) {
+                // copy the pointers in the range of the copied memory
+                // (the same as in PointerAnalysis::processMemcpy())
+                if (!(field.first.isUnknown() ||
+                      srcOffset.isUnknown() ||
+                      (srcOffset <= field.first &&
+                       (len.isUnknown() ||
+                        *field.first - *srcOffset < *len))))
+                    continue;
+
+                Offset newOff = Offset::UNKNOWN;
+                if (!field.first.isUnknown() && !srcOffset.isUnknown() &&
+                    !destOffset.isUnknown() &&
+                    // check that new offset does not overflow Offset::UNKNOWN
+                    Offset::UNKNOWN - *destOffset > *field.first - *srcOffset) {
+                    newOff = *field.first - *srcOffset + *destOffset;
+                    if (newOff >= destObject->getSize() ||
+                        newOff >= getOptions().fieldSensitivity)
+                        newOff = Offset::UNKNOWN;
+                }
+
+                addCopy(field.second, getLocation(destObject, newOff));
+            }
+        }
+    }
+}
+
+void PointerAnalysisAndersen::applyCall(PSNode *node)
+{
+    bool changed = false;
+    std::vector<PSNode *> called;
+
+    for (const Pointer& ptr : node->getOperand(0)->pointsTo) {
+        // do not add pointers that do not point to functions
+        if (!getOptions().invalidateNodes
+            && ptr.target->getType() != PSNodeType::FUNCTION)
+            continue;
+
+        const bool valid = ptr.isValid() && !ptr.isInvalidated();
+        // the function may be called already (with another offset)
+        const bool known = valid && node->pointsTo.pointsToTarget(ptr.target);
+        if (node->addPointsTo(ptr)) {
+            changed = true;
+
+            if (!valid)
+                error(node, "Calling invalid pointer as a function!");
+            else if (!known)
+                called.push_back(ptr.target);
+        }
+    }
+
+    // connect all the new functions before extracting the constraints
+    if (!called.empty() && functionPointerCalls(node, called)) {
+        // the points-to set of the return site may have been set
+        // directly (e.g. for calls of undefined functions)
+        if (node->getPairedNode())
+            queue(node->getPairedNode());
+        extractConstraints();
+    }
+
+    if (changed)
+        queue(node);
+}
+
+void PointerAnalysisAndersen::applyConstraint(size_t idx)
+{
+    const Constraint& c = constraints[idx];
+    switch (c.kind) {
+        case Constraint::Kind::COPY:
+            if (c.node->addPointsTo(c.operand->pointsTo))
+                queue(c.node);
+            break;
+        case Constraint::Kind::GEP:
+            applyGep(c.node);
+            break;
+        case Constraint::Kind::LOAD:
+            applyLoad(c.node);
+            break;
+        case Constraint::Kind::STORE:
+            applyStore(c.node);
+            break;
+        case Constraint::Kind::MEMCPY:
+            applyMemcpy(idx);
+            break;
+        case Constraint::Kind::CALL:
+            applyCall(c.node);
+            break;
+    }
+}
+
+void PointerAnalysisAndersen::solve()
+{
+    while (true) {
+        ++statistics.iterations;
+
+        while (!new_constraints.empty() ||
+               !loc_worklist.empty() || !node_worklist.empty()) {
+            if (!new_constraints.empty()) {
+                size_t idx = new_constraints.back();
+                new_constraints.pop_back();
+                applyConstraint(idx);
+                continue;
+            }
+
+            if (!loc_worklist.empty()) {
+                unsigned loc = loc_worklist.back();
+                loc_worklist.pop_back();
+                loc_queued[loc] = false;
+
+                Location& L = locations[loc];
+                for (PSNode *reader : L.readers) {
+                    if (reader->addPointsTo(L.pointsTo))
+                        queue(reader);
+                }
+                for (unsigned to : L.copies)
+                    addToLocation(to, L.pointsTo);
+                continue;
+            }
+
+            PSNode *node = node_worklist.back();
+            node_worklist.pop_back();
+            node_queued[node->getID()] = false;
+            ++statistics.processedNodes;
+
+            if (node->getID() >= uses.size())
+                continue;
+
+            // applying a constraint may add new constraints
+            // (calls via pointers), so do not use iterators
+            for (size_t i = 0; i < uses[node->getID()].size(); ++i)
+                applyConstraint(uses[node->getID()][i]);
+        }
+
+        // forks and joins read points-to sets of nodes
+        // that are not their operands, check them now
+        bool changed = false;
+        for (size_t i = 0; i < forks_joins.size(); ++i) {
+            PSNode *n = forks_joins[i];
+            if (n->getType() == PSNodeType::FORK)
+                changed |= handleFork(n);
+            else
+                changed |= handleJoin(n);
+        }
+
+        if (!changed)
+            break;
+
+        extractConstraints();
+    }
+}
+
+void PointerAnalysisAndersen::run()
+{
+    // the sets created during the analysis use the numbering of PS
+    PointerIdRegistry::Scope scope(getPS()->getIdRegistry());
+
+    preprocess();
+    extractConstraints();
+    solve();
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
@@ -0,0 +1,432 @@
+#include <thread>
+
+#include "dg/analysis/PointsTo/PointerAnalysisFIParallel.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+namespace {
+
+// lock the points-to sets of two nodes (that may share the lock)
+class NodesLock {
+    std::unique_lock<std::mutex> first;
+    std::unique_lock<std::mutex> second;
+
+public:
+    NodesLock(std::mutex& a, std::mutex& b) {
+        if (&a == &b) {
+            first = std::unique_lock<std::mutex>(a);
+            return;
+        }
+
+        std::lock(a, b);
+        first = std::unique_lock<std::mutex>(a, std::adopt_lock);
+        second = std::unique_lock<std::mutex>(b, std::adopt_lock);
+    }
+};
+
+} // anonymous namespace
+
+void PointerAnalysisFIParallel::push(PSNode *n, unsigned worker)
+{
+    if (queued[n->getID()].exchange(true))
+        return;
+
+    // count the node before it can be popped
+    ++pending;
+    queues[worker]->push(n);
+}
+
+void PointerAnalysisFIParallel::pushUsers(PSNode *n, unsigned worker)
+{
+    // do not write the shared flag on every change
+    if (!progress.load(std::memory_order_relaxed))
+        progress = true;
+    for (PSNode *user : n->getUsers())
+        push(user, worker);
+}
+
+void PointerAnalysisFIParallel::pushMemoryReaders(unsigned worker)
+{
+    if (!progress.load(std::memory_order_relaxed))
+        progress = true;
+    // the memory is shared by the whole program
+    for (PSNode *reader : memory_readers)
+        push(reader, worker);
+}
+
+bool PointerAnalysisFIParallel::processCopy(PSNode *node)
+{
+    bool changed = false;
+    for (PSNode *op : node->getOperands()) {
+        NodesLock lock(nodeLock(node), nodeLock(op));
+        if (node->getType() == PSNodeType::CALL_RETURN &&
+            getOptions().invalidateNodes) {
+            for (const Pointer& ptr : op->pointsTo) {
+                if (!canBeDereferenced(ptr))
+                    continue;
+                PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
+                assert(target && "Target is not memory allocation");
+                if (!target->isHeap() && !target->isGlobal())
+                    changed |= node->addPointsTo(INVALIDATED, 0);
+            }
+        }
+
+        changed |= node->addPointsTo(op->pointsTo);
+    }
+
+    return changed;
+}
+
+bool PointerAnalysisFIParallel::processGep(PSNode *node)
+{
+    bool changed = false;
+    PSNodeGep *gep = PSNodeGep::get(node);
+    PSNode *source = gep->getSource();
+    const Offset fieldSensitivity = getOptions().fieldSensitivity;
+
+    NodesLock lock(nodeLock(node), nodeLock(source));
+    for (const Pointer& ptr : source->pointsTo) {
+        Offset::type new_offset;
+        if (ptr.offset.isUnknown() || gep->getOffset().isUnknown())
+            new_offset = Offset::UNKNOWN;
+        else
+            new_offset = *ptr.offset + *gep->getOffset();
+
+        // the same as in PointerAnalysis::processGep()
+        if ((new_offset == 0 || new_offset < ptr.target->getSize())
+            && new_offset < *fieldSensitivity)
+            changed |= node->addPointsTo(ptr.target, new_offset);
+        else
+            changed |= node->addPointsTo(ptr.target, Offset::UNKNOWN);
+    }
+
+    return changed;
+}
+
+bool PointerAnalysisFIParallel::processLoad(PSNode *node)
+{
+    bool changed = false;
+    PSNode *operand = node->getOperand(0);
+
+    NodesLock lock(nodeLock(node), nodeLock(operand));
+    if (operand->pointsTo.empty())
+        return error(operand, "Load's operand has no points-to set");
+
+    // the same as PointerAnalysis::processLoad(), every target
+    // has exactly one memory object in the flow-insensitive analysis
+    for (const Pointer& ptr : operand->pointsTo) {
+        if (ptr.isUnknown()) {
+            changed |= node->addPointsTo(UnknownPointer);
+            continue;
+        }
+
+        if (!canBeDereferenced(ptr))
+            continue;
+
+        PSNodeAlloc *target = PSNodeAlloc::get(ptr.target);
+        assert(target && "Target is not memory allocation");
+        MemoryObject *o = getObject(ptr.target);
+
+        std::lock_guard<std::mutex> memory(memoryLock(o));
+        if (ptr.offset.isUnknown()) {
+            if (o->pointsTo.empty()) {
+                if (target->isZeroInitialized())
+                    changed |= node->addPointsTo(NullPointer);
+                else
+                    changed |= errorEmptyPointsTo(node, target);
+            }
+
+            for (auto& it : o->pointsTo)
+                changed |= node->addPointsTo(it.second);
+            continue;
+        }
+
+        auto it = o->pointsTo.find(ptr.offset);
+        if (it == o->pointsTo.end()) {
+            if (target->isZeroInitialized())
+                changed |= node->addPointsTo(NullPointer);
+            else if (!o->pointsTo.count(Offset::UNKNOWN))
+                changed |= errorEmptyPointsTo(node, target);
+        } else {
+            changed |= node->addPointsTo(it->second);
+        }
+
+        it = o->pointsTo.find(Offset::UNKNOWN);
+        if (it != o->pointsTo.end())
+            changed |= node->addPointsTo(it->second);
+    }
+
+    return changed;
+}
+
+bool PointerAnalysisFIParallel::processStore(PSNode *node)
+{
+    bool changed = false;
+    PSNode *value = node->getOperand(0);
+    PSNode *pointer = node->getOperand(1);
+
+    NodesLock lock(nodeLock(value), nodeLock(pointer));
+    for (const Pointer& ptr : pointer->pointsTo) {
+        if (!canBeDereferenced(ptr))
+            continue;
+
+        MemoryObject *o = getObject(ptr.target);
+        std::lock_guard<std::mutex> memory(memoryLock(o));
+        changed |= o->addPointsTo(ptr.offset, value->pointsTo);
+    }
+
+    return changed;
+}
+
+bool PointerAnalysisFIParallel::processMemcpy(PSNode *node)
+{
+    bool changed = false;
+    PSNodeMemcpy *memcpy = PSNodeMemcpy::get(node);
+    PSNode *srcNode = memcpy->getSource();
+    PSNode *destNode = memcpy->getDestination();
+
+    std::lock_guard<std::mutex> memcpys(memcpy_lock);
+    NodesLock lock(nodeLock(srcNode), nodeLock(destNode));
+
+    std::vector<MemoryObject *> srcObjects;
+    std::vector<MemoryObject *> destObjects;
+    for (const Pointer& ptr : srcNode->pointsTo) {
+        if (!canBeDereferenced(ptr))
+            continue;
+
+        // copy the source object, so that we do not need
+        // to hold two locks of memory at once
+        MemoryObject *so = getObject(ptr.target);
+        MemoryObject source(so->node);
+        {
+            std::lock_guard<std::mutex> memory(memoryLock(so));
+            source.pointsTo = so->pointsTo;
+        }
+
+        srcObjects.assign(1, &source);
+        for (const Pointer& dptr : destNode->pointsTo) {
+            if (!canBeDereferenced(dptr))
+                continue;
+
+            MemoryObject *dest = getObject(dptr.target);
+            destObjects.assign(1, dest);
+
+            std::lock_guard<std::mutex> memory(memoryLock(dest));
+            changed |= PointerAnalysis::processMemcpy(srcObjects, destObjects,
+                                                      ptr, dptr,
+                                                      memcpy->getLength());
+        }
+    }
+
+    return changed;
+}
+
+void PointerAnalysisFIParallel::processNodeParallel(PSNode *node, unsigned worker)
+{
+    switch (node->getType()) {
+        case PSNodeType::LOAD:
+            if (processLoad(node))
+                pushUsers(node, worker);
+            break;
+        case PSNodeType::STORE:
+            if (processStore(node))
+                pushMemoryReaders(worker);
+            break;
+        case PSNodeType::MEMCPY:
+            if (processMemcpy(node))
+                pushMemoryReaders(worker);
+            break;
+        case PSNodeType::GEP:
+            if (processGep(node))
+                pushUsers(node, worker);
+            break;
+        case PSNodeType::CAST:
+        case PSNodeType::PHI:
+        case PSNodeType::RETURN:
+        case PSNodeType::CALL_RETURN:
+            if (processCopy(node))
+                pushUsers(node, worker);
+            break;
+        case PSNodeType::CALL_FUNCPTR:
+        case PSNodeType::FORK:
+        case PSNodeType::JOIN:
+        case PSNodeType::INVALIDATE_LOCALS:
+            {
+            // these may change the graph
+            std::lock_guard<std::mutex> guard(deferred_lock);
+            deferred.push_back(node);
+            }
+            break;
+        default:
+            // allocations, constants, ... have their points-to sets
+            // from the graph, the other nodes have no points-to sets
+            break;
+    }
+}
+
+void PointerAnalysisFIParallel::worker(unsigned idx)
+{
+    // the sets created by this thread use the numbering of PS
+    PointerIdRegistry::Scope scope(getPS()->getIdRegistry());
+
+    size_t num = 0;
+    size_t workers = queues.size();
+    PSNode *node;
+    while (true) {
+        bool found = queues[idx]->pop(node);
+        for (size_t i = 1; !found && i < workers; ++i)
+            found = queues[(idx + i) % workers]->steal(node);
+
+        if (!found) {
+            // the workers that are processing a node may queue new nodes
+            if (pending == 0)
+                break;
+            std::this_thread::yield();
+            continue;
+        }
+
+        // clear the flag before processing the node,
+        // so that it is queued again if its inputs change meanwhile
+        queued[node->getID()] = false;
+        processNodeParallel(node, idx);
+        ++num;
+        --pending;
+    }
+
+    processed += num;
+}
+
+void PointerAnalysisFIParallel::solveParallel()
+{
+    std::vector<std::thread> threads;
+    threads.reserve(queues.size());
+    for (unsigned i = 0; i < queues.size(); ++i)
+        threads.emplace_back(&PointerAnalysisFIParallel::worker, this, i);
+
+    for (auto& thread : threads)
+        thread.join();
+
+    assert(pending == 0);
+}
+
+void PointerAnalysisFIParallel::createMemoryObjects()
+{
+    std::vector<MemoryObject *> objects;
+    for (const auto& nd : getPS()->getNodes()) {
+        if (!nd || nd->getData<MemoryObject>())
+            continue;
+
+        if (nd->getType() == PSNodeType::ALLOC ||
+            nd->getType() == PSNodeType::DYN_ALLOC ||
+            nd->getType() == PSNodeType::UNKNOWN_MEM) {
+            objects.clear();
+            PointerAnalysisFI::getMemoryObjects(nd.get(), Pointer(nd.get(), 0),
+                                                objects);
+        }
+    }
+}
+
+void PointerAnalysisFIParallel::queueChanged(const std::vector<unsigned>& versions)
+{
+    PointerSubgraph *PS = getPS();
+    createMemoryObjects();
+
+    // all the queues are empty here
+    queued.reset(new std::atomic<bool>[PS->size()]);
+    for (size_t i = 0; i < PS->size(); ++i)
+        queued[i] = false;
+    operands_num.resize(PS->size(), -1);
+
+    memory_readers.clear();
+    forks_joins.clear();
+
+    unsigned worker = 0;
+    for (PSNode *n : PS->getNodes(PS->getRoot())) {
+        if (n->getType() == PSNodeType::LOAD ||
+            n->getType() == PSNodeType::MEMCPY)
+            memory_readers.push_back(n);
+        else if (n->getType() == PSNodeType::FORK ||
+                 n->getType() == PSNodeType::JOIN)
+            forks_joins.push_back(n);
+
+        size_t id = n->getID();
+        if (operands_num[id] != static_cast<int>(n->getOperandsNum())) {
+            operands_num[id] = static_cast<int>(n->getOperandsNum());
+            push(n, worker);
+        }
+
+        if (id < versions.size() && versions[id] != n->pointsToVersion) {
+            for (PSNode *user : n->getUsers())
+                push(user, worker);
+        }
+
+        worker = (worker + 1) % queues.size();
+    }
+}
+
+void PointerAnalysisFIParallel::processSequential()
+{
+    std::vector<PSNode *> nodes;
+    nodes.swap(deferred);
+    // forks and joins read points-to sets of nodes
+    // that are not their operands
+    if (progress)
+        nodes.insert(nodes.end(), forks_joins.begin(), forks_joins.end());
+
+    if (nodes.empty())
+        return;
+
+    PointerSubgraph *PS = getPS();
+    std::vector<unsigned> versions(PS->size(), 0);
+    for (const auto& nd : PS->getNodes()) {
+        if (nd)
+            versions[nd->getID()] = nd->pointsToVersion;
+    }
+
+    bool changed = false;
+    for (PSNode *n : nodes) {
+        changed |= processNode(n);
+        ++statistics.processedNodes;
+    }
+
+    if (changed)
+        queueChanged(versions);
+}
+
+void PointerAnalysisFIParallel::run()
+{
+    unsigned threadsNum = getOptions().solverThreads;
+    if (threadsNum <= 1 || !isThreadSafe(getPS()->getPointsToSetKind())) {
+        PointerAnalysisFI::run();
+        return;
+    }
+
+    // the sets created during the analysis use the numbering of PS
+    PointerIdRegistry::Scope scope(getPS()->getIdRegistry());
+
+    preprocess();
+    sanityCheck();
+
+    queues.clear();
+    for (unsigned i = 0; i < threadsNum; ++i)
+        queues.emplace_back(new ADT::WorkStealingQueue<PSNode *>());
+
+    // queue all the nodes
+    queueChanged({});
+
+    while (pending > 0) {
+        ++statistics.iterations;
+        progress = false;
+        solveParallel();
+        processSequential();
+    }
+
+    statistics.processedNodes += processed;
+    sanityCheck();
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
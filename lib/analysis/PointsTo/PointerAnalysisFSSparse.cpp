@@ -0,0 +1,456 @@
+#include <algorithm>
+#include <functional>
+
+#include "dg/analysis/PointsTo/PointerAnalysisFSSparse.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+// the nodes that may change the PointerSubgraph, these are processed
+// only in the flow-insensitive stage
+static inline bool canChangeGraph(const PSNode *node)
+{
+    return node->getType() == PSNodeType::CALL_FUNCPTR ||
+           node->getType() == PSNodeType::FORK ||
+           node->getType() == PSNodeType::JOIN;
+}
+
+// the nodes that see the memory of more predecessors
+static inline bool isJoin(const PSNode *node)
+{
+    return node->predecessorsNum() > 1;
+}
+
+static inline bool isMemoryNode(const PSNode *node)
+{
+    return node->getType() == PSNodeType::LOAD ||
+           node->getType() == PSNodeType::STORE ||
+           node->getType() == PSNodeType::MEMCPY ||
+           isJoin(node);
+}
+
+static inline bool targetLess(const PSNode *a, const PSNode *b)
+{
+    return std::less<const PSNode *>()(a, b);
+}
+
+PointerAnalysisFSSparse::Slot *
+PointerAnalysisFSSparse::getSlot(const PSNode *node, const PSNode *target) const
+{
+    if (node->getID() >= node_slots.size())
+        return nullptr;
+
+    const auto& nslots = node_slots[node->getID()];
+    auto it = std::lower_bound(nslots.begin(), nslots.end(), target,
+                               [](const Slot *s, const PSNode *t) {
+                                   return targetLess(s->target, t);
+                               });
+    if (it == nslots.end() || (*it)->target != target)
+        return nullptr;
+
+    return *it;
+}
+
+void PointerAnalysisFSSparse::queueSlot(Slot *slot)
+{
+    assert(slot->def && "Only defined memory flows to other slots");
+    if (slot->queued)
+        return;
+
+    slot->queued = true;
+    changed_slots.push_back(slot);
+}
+
+void PointerAnalysisFSSparse::getTargets(PSNode *ptr,
+                                         std::vector<PSNode *>& targets)
+{
+    for (const Pointer& p : ptr->pointsTo) {
+        if (canBeDereferenced(p))
+            targets.push_back(p.target);
+    }
+
+    std::sort(targets.begin(), targets.end(), targetLess);
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+}
+
+void PointerAnalysisFSSparse::getMemoryObjects(PSNode *where,
+                                               const Pointer& pointer,
+                                               std::vector<MemoryObject *>& objects)
+{
+    if (stage == Stage::FLOW_INSENSITIVE) {
+        // the same as in PointerAnalysisFI
+        PSNode *n = getAllocationNode(pointer.target);
+        if (n->getType() == PSNodeType::FUNCTION)
+            return;
+
+        auto& mo = fi_memory[n];
+        if (!mo)
+            mo.reset(new MemoryObject(n));
+
+        objects.push_back(mo.get());
+        return;
+    }
+
+    Slot *slot = getSlot(where, pointer.target);
+    // the flow-insensitive stage found every object
+    // that the node can access
+    assert(slot && "The node accesses an unexpected object");
+    if (!slot)
+        return;
+
+    // the write needs something to write to (see PointerAnalysisFS)
+    if (!slot->mo && canChangeMM(where)) {
+        slot->mo.reset(new MemoryObject(pointer.target));
+        if (slot->def)
+            queueSlot(slot);
+    }
+
+    if (slot->mo)
+        objects.push_back(slot->mo.get());
+}
+
+void PointerAnalysisFSSparse::runFlowInsensitive()
+{
+    stage = Stage::FLOW_INSENSITIVE;
+    PointerAnalysis::run();
+}
+
+void PointerAnalysisFSSparse::resetPointsTo(const std::vector<PSNode *>& nodes)
+{
+    for (PSNode *n : nodes) {
+        switch (n->getType()) {
+            case PSNodeType::ALLOC:
+            case PSNodeType::DYN_ALLOC:
+            case PSNodeType::FUNCTION:
+            case PSNodeType::CONSTANT:
+            // calls of unknown functions point to unknown memory
+            case PSNodeType::CALL:
+            // keep the results of the flow-insensitive stage
+            case PSNodeType::CALL_FUNCPTR:
+            case PSNodeType::FORK:
+            case PSNodeType::JOIN:
+                continue;
+            default:
+                break;
+        }
+
+        // the calls of undefined functions via pointers
+        // return unknown memory
+        PSNode *paired = n->getType() == PSNodeType::CALL_RETURN ?
+                            n->getPairedNode() : nullptr;
+        bool unknown = paired &&
+                       paired->getType() == PSNodeType::CALL_FUNCPTR &&
+                       n->pointsTo.count(UnknownPointer) > 0;
+
+        n->pointsTo.clear();
+        if (unknown)
+            n->pointsTo.add(UnknownPointer);
+        ++n->pointsToVersion;
+    }
+
+    // the operands changed, the nodes must merge them again
+    forgetSeenInputs();
+}
+
+void PointerAnalysisFSSparse::buildSlots(const std::vector<PSNode *>& nodes)
+{
+    const size_t size = getPS()->size();
+    node_slots.assign(size, {});
+
+    // the slots of the objects
+    std::unordered_map<PSNode *, std::vector<Slot *>> object_slots;
+    auto addSlot = [&](PSNode *n, PSNode *target, bool def) {
+        Slot *slot = new Slot(n, target, def);
+        slots.emplace_back(slot);
+        node_slots[n->getID()].push_back(slot);
+        object_slots[target].push_back(slot);
+        return slot;
+    };
+
+    // the objects accessed by the nodes
+    // (according to the flow-insensitive results)
+    std::vector<PSNode *> targets;
+    std::vector<PSNode *> written;
+    for (PSNode *n : nodes) {
+        targets.clear();
+        written.clear();
+        switch (n->getType()) {
+            case PSNodeType::LOAD:
+                getTargets(n->getOperand(0), targets);
+                break;
+            case PSNodeType::STORE:
+                getTargets(n->getOperand(1), written);
+                break;
+            case PSNodeType::MEMCPY:
+                getTargets(PSNodeMemcpy::get(n)->getDestination(), written);
+                getTargets(PSNodeMemcpy::get(n)->getSource(), targets);
+                break;
+            default:
+                continue;
+        }
+
+        for (PSNode *t : written)
+            addSlot(n, t, true);
+        for (PSNode *t : targets) {
+            if (!std::binary_search(written.begin(), written.end(),
+                                    t, targetLess))
+                addSlot(n, t, false);
+        }
+    }
+
+    // the nearest memory nodes (nodes that access memory or join paths)
+    // after a memory node. Every other node has at most one predecessor,
+    // so it is searched only from one memory node.
+    std::vector<std::vector<PSNode *>> memory_succs(size);
+    std::vector<PSNode *> stack;
+    for (PSNode *n : nodes) {
+        if (!isMemoryNode(n))
+            continue;
+
+        auto& succs = memory_succs[n->getID()];
+        stack.assign(n->getSuccessors().begin(), n->getSuccessors().end());
+        while (!stack.empty()) {
+            PSNode *cur = stack.back();
+            stack.pop_back();
+            if (isMemoryNode(cur)) {
+                succs.push_back(cur);
+                continue;
+            }
+
+            for (PSNode *s : cur->getSuccessors())
+                stack.push_back(s);
+        }
+    }
+
+    // the def-use chains of every object. The memory of an object
+    // flows from a def slot through the memory nodes to the next def slots.
+    // Joins that the memory reaches get their own def slot (a phi node).
+    std::unordered_map<PSNode *, Slot *> object_nodes;
+    std::vector<std::pair<Slot *, PSNode *>> worklist;
+    for (auto& it : object_slots) {
+        PSNode *target = it.first;
+        object_nodes.clear();
+        for (Slot *s : it.second)
+            object_nodes[s->node] = s;
+
+        auto pushSuccs = [&](Slot *from, PSNode *n) {
+            for (PSNode *s : memory_succs[n->getID()])
+                worklist.emplace_back(from, s);
+        };
+
+        for (Slot *s : it.second) {
+            if (s->def)
+                pushSuccs(s, s->node);
+        }
+
+        while (!worklist.empty()) {
+            Slot *from = worklist.back().first;
+            PSNode *cur = worklist.back().second;
+            worklist.pop_back();
+
+            Slot *&slot = object_nodes[cur];
+            if (slot && slot->def) {
+                from->successors.push_back(slot);
+                continue;
+            }
+
+            if (isJoin(cur)) {
+                // the memory is merged here
+                if (slot)
+                    slot->def = true;
+                else
+                    slot = addSlot(cur, target, true);
+
+                from->successors.push_back(slot);
+                pushSuccs(slot, cur);
+                continue;
+            }
+
+            // the node reads the memory (or does not care about it),
+            // the memory flows further
+            if (slot)
+                from->successors.push_back(slot);
+            pushSuccs(from, cur);
+        }
+    }
+
+    for (auto& slot : slots) {
+        auto& succs = slot->successors;
+        std::sort(succs.begin(), succs.end());
+        succs.erase(std::unique(succs.begin(), succs.end()), succs.end());
+        for (Slot *succ : succs)
+            succ->predecessors.push_back(slot.get());
+    }
+
+    for (auto& nslots : node_slots) {
+        std::sort(nslots.begin(), nslots.end(),
+                  [](const Slot *a, const Slot *b) {
+                      return targetLess(a->target, b->target);
+                  });
+    }
+}
+
+void PointerAnalysisFSSparse::propagate(Slot *slot,
+                                        std::vector<PSNode *>& pending)
+{
+    slot->queued = false;
+    if (!slot->mo)
+        return;
+
+    for (Slot *succ : slot->successors) {
+        PSNode *n = succ->node;
+        // the store merges the memory when it is processed,
+        // the strong update depends on the points-to set
+        // of its operand (the same as in PointerAnalysisFS)
+        if (n->getType() == PSNodeType::STORE) {
+            pending.push_back(n);
+            continue;
+        }
+
+        bool changed = false;
+        if (!succ->mo) {
+            succ->mo.reset(new MemoryObject(succ->target));
+            changed = true;
+        }
+
+        changed |= mergeObjects(succ->target, succ->mo.get(),
+                                slot->mo.get(), nullptr);
+        if (!changed)
+            continue;
+
+        if (succ->def)
+            queueSlot(succ);
+        if (n->getType() == PSNodeType::LOAD ||
+            n->getType() == PSNodeType::MEMCPY)
+            pending.push_back(n);
+    }
+}
+
+bool PointerAnalysisFSSparse::mergeStoreSlots(PSNode *store)
+{
+    assert(store->getType() == PSNodeType::STORE);
+
+    // every store that stores to a memory allocated
+    // not in a loop is a strong update
+    PointsToSetT *overwritten = nullptr;
+    if (!pointsToAllocationInLoop(store->getOperand(1)))
+        overwritten = &store->getOperand(1)->pointsTo;
+
+    bool changed = false;
+    for (Slot *slot : node_slots[store->getID()]) {
+        bool slot_changed = false;
+        for (Slot *pred : slot->predecessors) {
+            if (!pred->mo)
+                continue;
+
+            if (!slot->mo) {
+                slot->mo.reset(new MemoryObject(slot->target));
+                slot_changed = true;
+            }
+
+            slot_changed |= mergeObjects(slot->target, slot->mo.get(),
+                                         pred->mo.get(), overwritten);
+        }
+
+        if (slot_changed) {
+            queueSlot(slot);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+void PointerAnalysisFSSparse::solveSparse(const std::vector<PSNode *>& nodes)
+{
+    ADT::SparsePriorityWorklist<PSNode *> worklist;
+    std::vector<PSNode *> pending;
+
+    for (PSNode *n : nodes)
+        worklist.push(n, getPriority(n));
+
+    ++statistics.iterations;
+    while (true) {
+        // the memory flows along the def-use chains
+        while (!changed_slots.empty()) {
+            Slot *slot = changed_slots.back();
+            changed_slots.pop_back();
+            propagate(slot, pending);
+        }
+
+        for (PSNode *n : pending)
+            worklist.push(n, getPriority(n));
+        pending.clear();
+
+        if (worklist.empty())
+            break;
+
+        PSNode *cur = worklist.pop();
+        if (canChangeGraph(cur))
+            continue;
+
+        syncOperands(cur);
+
+        unsigned version = cur->pointsToVersion;
+        PSNode *rep = getCycleRep(cur);
+
+        bool changed = processNode(cur);
+        ++statistics.processedNodes;
+
+        if (cur->pointsToVersion != version) {
+            for (PSNode *user : cur->getUsers())
+                worklist.push(user, getPriority(user));
+        }
+
+        // the points-to set of the collapsed cycle changed,
+        // the nodes that read its members must see it
+        PSNode *new_rep = getCycleRep(cur);
+        if (new_rep && (new_rep != rep || changed)) {
+            for (PSNode *m : getCycleMembers(new_rep)) {
+                for (PSNode *user : m->getUsers()) {
+                    if (getCycleRep(user) != new_rep)
+                        worklist.push(user, getPriority(user));
+                }
+            }
+        }
+
+        // the written memory flows to the next nodes
+        if (changed && (cur->getType() == PSNodeType::STORE ||
+                        cur->getType() == PSNodeType::MEMCPY)) {
+            for (Slot *slot : node_slots[cur->getID()]) {
+                if (slot->def)
+                    queueSlot(slot);
+            }
+        }
+
+        if (cur->getType() == PSNodeType::STORE)
+            mergeStoreSlots(cur);
+    }
+
+    syncCycleMembers();
+}
+
+void PointerAnalysisFSSparse::run()
+{
+    // the sets created during the analysis use the numbering of PS
+    PointerIdRegistry::Scope scope(getPS()->getIdRegistry());
+
+    runFlowInsensitive();
+
+    // the flow-insensitive stage has built the subgraphs
+    // of the functions called via pointers, so the graph is final now
+    auto nodes = getPS()->getNodes(getPS()->getRoot());
+    buildSlots(nodes);
+    resetPointsTo(nodes);
+    fi_memory.clear();
+
+    stage = Stage::SPARSE;
+    solveSparse(nodes);
+
+    sanityCheck();
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
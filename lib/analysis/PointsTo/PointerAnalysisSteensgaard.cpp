@@ -0,0 +1,618 @@
+#include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointsToSet.h"
+#include "dg/analysis/PointsTo/PointerSubgraph.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSteensgaard.h"
+
+namespace dg {
+namespace analysis {
+namespace pta {
+
+const unsigned PointerAnalysisSteensgaard::NONE;
+
+unsigned PointerAnalysisSteensgaard::newCell()
+{
+    unsigned c = cells.size();
+    cells.emplace_back(c);
+    return c;
+}
+
+unsigned PointerAnalysisSteensgaard::findCell(unsigned c)
+{
+    unsigned root = c;
+    while (cells[root].parent != root)
+        root = cells[root].parent;
+
+    // path compression
+    while (cells[c].parent != root) {
+        unsigned next = cells[c].parent;
+        cells[c].parent = root;
+        c = next;
+    }
+
+    return root;
+}
+
+unsigned PointerAnalysisSteensgaard::findObject(unsigned o)
+{
+    unsigned root = o;
+    while (objects[root].parent != root)
+        root = objects[root].parent;
+
+    while (objects[o].parent != root) {
+        unsigned next = objects[o].parent;
+        objects[o].parent = root;
+        o = next;
+    }
+
+    return root;
+}
+
+unsigned PointerAnalysisSteensgaard::getCell(PSNode *node)
+{
+    if (!isGraphNode(node)) {
+        auto it = special_cells.find(node);
+        if (it != special_cells.end())
+            return it->second;
+
+        unsigned c = newCell();
+        cells[c].null = (node == NULLPTR);
+        cells[c].unknown = (node == UNKNOWN_MEMORY);
+        special_cells.emplace(node, c);
+        return c;
+    }
+
+    if (node->getID() >= node_cells.size())
+        node_cells.resize(node->getID() + 1, NONE);
+
+    if (node_cells[node->getID()] == NONE) {
+        unsigned c = newCell();
+        node_cells[node->getID()] = c;
+
+        // address-of: the pointers that the node has from the graph
+        // (the node may be only an operand, e.g. a constant)
+        if (isAddressNode(node)) {
+            for (const Pointer& ptr : node->pointsTo)
+                addPointer(c, ptr);
+        }
+    }
+
+    return node_cells[node->getID()];
+}
+
+unsigned PointerAnalysisSteensgaard::getObject(PSNode *alloc)
+{
+    assert(isGraphNode(alloc) && "The allocation is not in the graph");
+
+    if (alloc->getID() >= node_objects.size())
+        node_objects.resize(alloc->getID() + 1, NONE);
+
+    if (node_objects[alloc->getID()] == NONE) {
+        unsigned o = objects.size();
+        objects.emplace_back(o);
+        objects[o].nodes.push_back(alloc);
+        objects[o].size = alloc->getSize();
+
+        PSNodeAlloc *A = PSNodeAlloc::get(alloc);
+        objects[o].zeroInitialized = A && A->isZeroInitialized();
+
+        node_objects[alloc->getID()] = o;
+    }
+
+    return node_objects[alloc->getID()];
+}
+
+unsigned PointerAnalysisSteensgaard::getField(unsigned obj, Offset off)
+{
+    obj = findObject(obj);
+    if (!objects[obj].collapsed &&
+        (off.isUnknown() || off >= getOptions().fieldSensitivity))
+        collapse(obj);
+
+    if (objects[obj].collapsed)
+        off = Offset::UNKNOWN;
+
+    auto it = objects[obj].fields.find(off);
+    if (it != objects[obj].fields.end())
+        return it->second;
+
+    // memcpy may need to copy the new field
+    unsigned c = newCell();
+    objects[obj].fields.emplace(off, c);
+    progress = true;
+    return c;
+}
+
+Offset PointerAnalysisSteensgaard::getTargetOffset(unsigned cell)
+{
+    cell = findCell(cell);
+    if (cells[cell].object == NONE ||
+        objects[findObject(cells[cell].object)].collapsed)
+        return Offset::UNKNOWN;
+
+    return cells[cell].offset;
+}
+
+void PointerAnalysisSteensgaard::unifyCells(unsigned a, unsigned b)
+{
+    pending.emplace_back(a, b);
+    if (!unifying)
+        unifyPending();
+}
+
+void PointerAnalysisSteensgaard::unifyWithNode(unsigned cell, PSNode *node)
+{
+    // the cells of null and unknown pointers are shared by all
+    // their uses, unifying with them would put all the values
+    // that may be null (or unknown) into one class
+    if (!isGraphNode(node)) {
+        unsigned c = getCell(node);
+        if (cells[c].null)
+            setNull(cell);
+        if (cells[c].unknown)
+            setUnknown(cell);
+        return;
+    }
+
+    unifyCells(cell, getCell(node));
+}
+
+void PointerAnalysisSteensgaard::unifyPending()
+{
+    // unifying cells unifies their targets and unifying objects
+    // unifies their fields, so use a worklist instead of recursion
+    unifying = true;
+    while (!pending.empty()) {
+        unsigned a = findCell(pending.back().first);
+        unsigned b = findCell(pending.back().second);
+        pending.pop_back();
+
+        if (a == b)
+            continue;
+
+        if (cells[a].rank < cells[b].rank)
+            std::swap(a, b);
+        if (cells[a].rank == cells[b].rank)
+            ++cells[a].rank;
+        cells[b].parent = a;
+        progress = true;
+
+        cells[a].null |= cells[b].null;
+        cells[a].unknown |= cells[b].unknown;
+        if (cells[b].object != NONE)
+            addTarget(a, cells[b].object, cells[b].offset);
+    }
+    unifying = false;
+}
+
+unsigned PointerAnalysisSteensgaard::unifyObjects(unsigned a, unsigned b)
+{
+    a = findObject(a);
+    b = findObject(b);
+    if (a == b)
+        return a;
+
+    if (objects[a].rank < objects[b].rank)
+        std::swap(a, b);
+    if (objects[a].rank == objects[b].rank)
+        ++objects[a].rank;
+    objects[b].parent = a;
+    progress = true;
+
+    Object& A = objects[a];
+    Object& B = objects[b];
+
+    if (A.nodes.size() < B.nodes.size())
+        A.nodes.swap(B.nodes);
+    A.nodes.insert(A.nodes.end(), B.nodes.begin(), B.nodes.end());
+    B.nodes.clear();
+
+    if (A.size < B.size)
+        A.size = B.size;
+    A.zeroInitialized |= B.zeroInitialized;
+
+    // the fields at the same offsets are unified
+    for (auto& field : B.fields) {
+        auto it = A.fields.find(field.first);
+        if (it == A.fields.end())
+            A.fields.emplace(field.first, field.second);
+        else
+            pending.emplace_back(it->second, field.second);
+    }
+    B.fields.clear();
+
+    if (A.collapsed || B.collapsed)
+        collapse(a);
+
+    if (!unifying)
+        unifyPending();
+
+    return a;
+}
+
+void PointerAnalysisSteensgaard::collapse(unsigned obj)
+{
+    obj = findObject(obj);
+    auto& fields = objects[obj].fields;
+    if (objects[obj].collapsed && fields.size() <= 1)
+        return;
+
+    objects[obj].collapsed = true;
+    progress = true;
+
+    // unify all the fields to one at unknown offset
+    unsigned first = NONE;
+    for (auto& field : fields) {
+        if (first == NONE)
+            first = field.second;
+        else
+            pending.emplace_back(first, field.second);
+    }
+
+    fields.clear();
+    if (first != NONE)
+        fields.emplace(Offset::UNKNOWN, first);
+
+    if (!unifying)
+        unifyPending();
+}
+
+void PointerAnalysisSteensgaard::addTarget(unsigned cell, unsigned obj, Offset off)
+{
+    cell = findCell(cell);
+    obj = findObject(obj);
+
+    if (off.isUnknown() || off >= getOptions().fieldSensitivity) {
+        off = Offset::UNKNOWN;
+        collapse(obj);
+    }
+
+    if (cells[cell].object == NONE) {
+        cells[cell].object = obj;
+        cells[cell].offset = off;
+        progress = true;
+        return;
+    }
+
+    Offset cur_off = getTargetOffset(cell);
+    unsigned o = unifyObjects(cells[cell].object, obj);
+    // unifying may have changed the representative of the cell
+    cell = findCell(cell);
+    cells[cell].object = o;
+
+    // the cell points to different offsets of the object,
+    // we cannot distinguish the fields anymore
+    if (cur_off != off)
+        collapse(o);
+}
+
+void PointerAnalysisSteensgaard::setNull(unsigned cell)
+{
+    cell = findCell(cell);
+    if (!cells[cell].null) {
+        cells[cell].null = true;
+        progress = true;
+    }
+}
+
+void PointerAnalysisSteensgaard::setUnknown(unsigned cell)
+{
+    cell = findCell(cell);
+    if (!cells[cell].unknown) {
+        cells[cell].unknown = true;
+        progress = true;
+    }
+}
+
+void PointerAnalysisSteensgaard::addPointer(unsigned cell, const Pointer& ptr)
+{
+    if (ptr.isNull()) {
+        setNull(cell);
+        return;
+    }
+
+    if (ptr.isUnknown()) {
+        setUnknown(cell);
+        return;
+    }
+
+    PSNode *alloc = getAllocationNode(ptr.target);
+    if (alloc == NULLPTR)
+        setNull(cell);
+    else if (alloc == UNKNOWN_MEMORY)
+        setUnknown(cell);
+    else if (isGraphNode(alloc))
+        addTarget(cell, getObject(alloc), ptr.offset);
+}
+
+void PointerAnalysisSteensgaard::visitGep(PSNode *node)
+{
+    PSNodeGep *gep = PSNodeGep::get(node);
+    assert(gep && "Non-GEP given");
+
+    unsigned src = findCell(getCell(gep->getSource()));
+    unsigned cell = getCell(node);
+    if (cells[src].null)
+        setNull(cell);
+    if (cells[src].unknown)
+        setUnknown(cell);
+    if (cells[src].object == NONE)
+        return;
+
+    unsigned obj = findObject(cells[src].object);
+    Offset off = getTargetOffset(src);
+
+    Offset::type new_offset;
+    if (off.isUnknown() || gep->getOffset().isUnknown())
+        new_offset = Offset::UNKNOWN;
+    else
+        new_offset = *off + *gep->getOffset();
+
+    // the same as in PointerAnalysis::processGep()
+    if (!((new_offset == 0 || new_offset < *objects[obj].size)
+          && new_offset < *getOptions().fieldSensitivity))
+        new_offset = Offset::UNKNOWN;
+
+    addTarget(cell, obj, new_offset);
+}
+
+void PointerAnalysisSteensgaard::visitLoad(PSNode *node)
+{
+    unsigned ptr = findCell(getCell(node->getOperand(0)));
+    unsigned cell = getCell(node);
+
+    // load from unknown pointer yields unknown pointer
+    if (cells[ptr].unknown)
+        setUnknown(cell);
+    if (cells[ptr].object == NONE)
+        return;
+
+    unsigned obj = findObject(cells[ptr].object);
+    if (objects[obj].zeroInitialized)
+        setNull(cell);
+
+    unifyCells(cell, getField(obj, getTargetOffset(ptr)));
+}
+
+void PointerAnalysisSteensgaard::visitStore(PSNode *node)
+{
+    unsigned ptr = findCell(getCell(node->getOperand(1)));
+    if (cells[ptr].object == NONE)
+        return;
+
+    unsigned field = getField(cells[ptr].object, getTargetOffset(ptr));
+    unifyWithNode(field, node->getOperand(0));
+}
+
+void PointerAnalysisSteensgaard::visitMemcpy(PSNode *node)
+{
+    PSNodeMemcpy *memcpy = PSNodeMemcpy::get(node);
+    unsigned src = findCell(getCell(memcpy->getSource()));
+    unsigned dest = findCell(getCell(memcpy->getDestination()));
+    if (cells[src].object == NONE || cells[dest].object == NONE)
+        return;
+
+    unsigned srcObj = findObject(cells[src].object);
+    unsigned destObj = findObject(cells[dest].object);
+    if (objects[srcObj].zeroInitialized && !objects[destObj].zeroInitialized) {
+        objects[destObj].zeroInitialized = true;
+        progress = true;
+    }
+
+    Offset srcOffset = getTargetOffset(src);
+    Offset destOffset = getTargetOffset(dest);
+    Offset len = memcpy->getLength();
+
+    // creating the fields of the destination may create fields
+    // of the source (if it is the same object), so take a copy
+    std::vector<std::pair<Offset, unsigned>> fields(
+                                objects[srcObj].fields.begin(),
+                                objects[srcObj].fields.end());
+
+    for (auto& field : fields) {
+        // the pointers in the range of the copied memory
+        // (the same as in PointerAnalysis::processMemcpy())
+        if (!(field.first.isUnknown() ||
+              srcOffset.isUnknown() ||
+              (srcOffset <= field.first &&
+               (len.isUnknown() ||
+                *field.first - *srcOffset < *len))))
+            continue;
+
+        Offset newOff = Offset::UNKNOWN;
+        if (!field.first.isUnknown() && !srcOffset.isUnknown() &&
+            !destOffset.isUnknown() &&
+            Offset::UNKNOWN - *destOffset > *field.first - *srcOffset) {
+            newOff = *field.first - *srcOffset + *destOffset;
+            if (newOff >= objects[findObject(destObj)].size)
+                newOff = Offset::UNKNOWN;
+        }
+
+        unifyCells(getField(destObj, newOff), field.second);
+    }
+}
+
+void PointerAnalysisSteensgaard::visitCall(PSNode *node)
+{
+    unsigned ptr = findCell(getCell(node->getOperand(0)));
+    if (cells[ptr].object == NONE)
+        return;
+
+    unsigned obj = findObject(cells[ptr].object);
+    std::vector<PSNode *> called;
+    for (PSNode *F : objects[obj].nodes) {
+        if (F->getType() != PSNodeType::FUNCTION)
+            continue;
+
+        if (node->addPointsTo(F, 0)) {
+            progress = true;
+            called.push_back(F);
+        }
+    }
+
+    if (!called.empty())
+        graph_changed |= functionPointerCalls(node, called);
+}
+
+void PointerAnalysisSteensgaard::visitNode(PSNode *node)
+{
+    switch (node->getType()) {
+        case PSNodeType::CALL_RETURN:
+            // calls of undefined functions via pointers
+            // set the unknown pointer directly
+            for (const Pointer& ptr : node->pointsTo) {
+                if (ptr.isUnknown())
+                    setUnknown(getCell(node));
+            }
+            // fall-through
+        case PSNodeType::PHI:
+        case PSNodeType::CAST:
+        case PSNodeType::RETURN:
+            for (PSNode *op : node->getOperands())
+                unifyWithNode(getCell(node), op);
+            break;
+        case PSNodeType::GEP:
+            visitGep(node);
+            break;
+        case PSNodeType::LOAD:
+            visitLoad(node);
+            break;
+        case PSNodeType::STORE:
+            visitStore(node);
+            break;
+        case PSNodeType::MEMCPY:
+            visitMemcpy(node);
+            break;
+        case PSNodeType::CALL_FUNCPTR:
+            visitCall(node);
+            break;
+        default:
+            // nothing to unify
+            break;
+    }
+}
+
+void PointerAnalysisSteensgaard::setPointsTo()
+{
+    // the cells of a class have the same points-to set,
+    // so build it only once for every class
+    std::unordered_map<unsigned, PointsToSetT> sets;
+
+    for (const auto& nd : getPS()->getNodes()) {
+        if (!nd || nd->getID() >= node_cells.size() ||
+            node_cells[nd->getID()] == NONE)
+            continue;
+
+        // these have the pointers that they got from the graph
+        if (isAddressNode(nd.get()))
+            continue;
+
+        unsigned cell = findCell(node_cells[nd->getID()]);
+        auto it = sets.find(cell);
+        if (it == sets.end()) {
+            it = sets.emplace(cell, PointsToSetT()).first;
+            PointsToSetT& S = it->second;
+            if (cells[cell].null)
+                S.add(NullPointer);
+            if (cells[cell].unknown)
+                S.add(UnknownPointer);
+
+            if (cells[cell].object != NONE) {
+                Offset off = getTargetOffset(cell);
+                for (PSNode *target : objects[findObject(cells[cell].object)].nodes) {
+                    if (target->getType() == PSNodeType::FUNCTION)
+                        S.add(Pointer(target, 0));
+                    else if (off.isUnknown() || *off == 0 || *off < target->getSize())
+                        S.add(Pointer(target, off));
+                    else
+                        S.add(Pointer(target, Offset::UNKNOWN));
+                }
+            }
+        }
+
+        if (it->second.empty())
+            continue;
+
+        if (nd->pointsTo.empty()) {
+            // copying the set is much cheaper than adding the pointers
+            nd->pointsTo = it->second;
+            ++nd->pointsToVersion;
+        } else {
+            nd->addPointsTo(it->second);
+        }
+    }
+}
+
+bool PointerAnalysisSteensgaard::pointsToSameObjects(PSNode *a, PSNode *b)
+{
+    unsigned ca = findCell(getCell(a));
+    unsigned cb = findCell(getCell(b));
+    if (cells[ca].object == NONE || cells[cb].object == NONE)
+        return false;
+
+    return findObject(cells[ca].object) == findObject(cells[cb].object);
+}
+
+void PointerAnalysisSteensgaard::run()
+{
+    // the sets created during the analysis use the numbering of PS
+    PointerIdRegistry::Scope scope(getPS()->getIdRegistry());
+
+    preprocess();
+
+    auto nodes = getPS()->getNodes(getPS()->getRoot());
+    auto gatherForksJoins = [this, &nodes]() {
+        forks_joins.clear();
+        for (PSNode *n : nodes) {
+            if (n->getType() == PSNodeType::FORK ||
+                n->getType() == PSNodeType::JOIN)
+                forks_joins.push_back(n);
+        }
+    };
+    gatherForksJoins();
+
+    while (true) {
+        // every pass unifies more cells or collapses more objects,
+        // so there is only a few of them
+        do {
+            ++statistics.iterations;
+            progress = false;
+            graph_changed = false;
+
+            for (PSNode *n : nodes) {
+                visitNode(n);
+                ++statistics.processedNodes;
+            }
+
+            if (graph_changed) {
+                nodes = getPS()->getNodes(getPS()->getRoot());
+                gatherForksJoins();
+            }
+        } while (progress);
+
+        if (forks_joins.empty())
+            break;
+
+        // forks and joins read the points-to sets of nodes
+        setPointsTo();
+
+        bool changed = false;
+        for (PSNode *n : forks_joins) {
+            if (n->getType() == PSNodeType::FORK)
+                changed |= handleFork(n);
+            else
+                changed |= handleJoin(n);
+        }
+
+        if (!changed)
+            break;
+
+        nodes = getPS()->getNodes(getPS()->getRoot());
+        gatherForksJoins();
+    }
+
+    setPointsTo();
+}
+
+} // namespace pta
+} // namespace analysis
+} // namespace dg
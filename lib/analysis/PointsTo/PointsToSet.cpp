@@ -9,16 +9,12 @@
 namespace dg {
 namespace analysis {
 namespace pta {
-    std::vector<PSNode*> SeparateOffsetsPointsToSet::idVector;
-    std::vector<Pointer> PointerIdPointsToSet::idVector;
-    std::vector<PSNode*> SmallOffsetsPointsToSet::idVector;
-    std::vector<PSNode*> AlignedSmallOffsetsPointsToSet::idVector;
-    std::vector<Pointer> AlignedPointerIdPointsToSet::idVector;
-    std::map<PSNode*,size_t> SeparateOffsetsPointsToSet::ids;
-    std::map<Pointer,size_t> PointerIdPointsToSet::ids;
-    std::map<PSNode*,size_t> SmallOffsetsPointsToSet::ids;
-    std::map<PSNode*,size_t> AlignedSmallOffsetsPointsToSet::ids;
-    std::map<Pointer,size_t> AlignedPointerIdPointsToSet::ids;
+    PointerIdRegistry::~PointerIdRegistry() {
+        // the sets that use the pool may outlive the registry
+        if (setsPool)
+            PointsToSetsPool::detach(setsPool);
+        delete bddManager;
+    }
 } // namespace pta
 } // namespace analysis
 } // namespace debug
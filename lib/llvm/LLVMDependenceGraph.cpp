@@ -50,6 +50,7 @@
 #include "llvm-utils.h"
 
 #include "dg/ADT/Queue.h"
+#include "dg/ADT/Arena.h"
 
 #include "analysis/DefUse/DefUse.h"
 
@@ -118,6 +119,14 @@ LLVMDependenceGraph::~LLVMDependenceGraph()
 
     // delete post-dominator tree root
     delete getPostDominatorTreeRoot();
+
+#ifdef ENABLE_CFG
+    // the blocks may be in the arena that is released
+    // before the destructor of the base class is called
+    for (auto& it : getBlocks())
+        delete it.second;
+    getBlocks().clear();
+#endif
 }
 
 static void addGlobals(llvm::Module *m, LLVMDependenceGraph *dg)
@@ -165,6 +174,14 @@ bool LLVMDependenceGraph::build(llvm::Module *m, llvm::Function *entry)
 
     module = m;
 
+    // allocate all the nodes, blocks and parameters
+    // of the whole graph in one arena
+    if (!arena) {
+        ownedArena.reset(new ADT::SizeClassArena());
+        arena = ownedArena.get();
+    }
+    ADT::ArenaScope arenaScope(arena);
+
     // add global nodes. These will be shared across subgraphs
     addGlobals(m, this);
 
@@ -267,6 +284,10 @@ LLVMDependenceGraph::buildSubgraph(LLVMNode *node, llvm::Function *callFunc, boo
 
     LLVMBBlock *BB;
 
+    // the subgraph may be built after the whole graph
+    // (e.g. for calls via function pointers)
+    ADT::ArenaScope arenaScope(arena);
+
     // if we don't have this subgraph constructed, construct it
     // else just add call edge
     LLVMDependenceGraph *&subgraph = constructedFunctions[callFunc];
@@ -277,6 +298,7 @@ LLVMDependenceGraph::buildSubgraph(LLVMNode *node, llvm::Function *callFunc, boo
         // set global nodes to this one, so that
         // we'll share them
         subgraph->setGlobalNodes(getGlobalNodes());
+        subgraph->arena = arena;
         subgraph->module = module;
         subgraph->PTA = PTA;
         subgraph->threads = this->threads;
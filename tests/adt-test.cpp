@@ -1,10 +1,12 @@
 #include <assert.h>
 #include <cstdarg>
 #include <cstdio>
+#include <map>
 
 #include "test-runner.h"
 
 #include "dg/ADT/Queue.h"
+#include "dg/ADT/Arena.h"
 #include "dg/ADT/Bitvector.h"
 #include "dg/analysis/ReachingDefinitions/RDMap.h"
 
@@ -102,6 +104,180 @@ public:
     }
 };
 
+struct identity
+{
+    size_t operator()(int a) const
+    {
+        return a;
+    }
+};
+
+class TestPriorityWorklist : public Test
+{
+public:
+    TestPriorityWorklist() : Test("test priority worklist")
+    {}
+
+    void test()
+    {
+        PriorityWorklist<int, identity> queue;
+        check(queue.empty(), "empty queue not empty");
+
+        check(queue.push(1, 7), "Did not push element");
+        check(queue.push(13, 10000), "Did not push element");
+        check(queue.push(4, 3), "Did not push element");
+        check(!queue.push(4, 5), "Pushed queued element");
+        check(queue.push(2, 3), "Did not push element");
+
+        check(queue.size() == 4, "BUG in size");
+        check(queue.isQueued(4), "BUG in isQueued");
+
+        check(queue.pop() == 2, "Wrong pop order");
+        check(queue.pop() == 4, "Wrong pop order");
+        check(!queue.isQueued(4), "BUG in isQueued");
+
+        // popped element can be queued again
+        check(queue.push(4, 8), "Did not push element");
+        check(queue.pop() == 1, "Wrong pop order");
+        check(queue.pop() == 4, "Wrong pop order");
+        check(queue.pop() == 13, "Wrong pop order");
+        check(queue.empty(), "emptied queue not empty");
+
+        for (int i = 0; i < 20000; ++i)
+            queue.push(i, 20000 - i);
+        for (int i = 20000; i-- > 0;)
+            check(queue.pop() == i, "Wrong pop order");
+        check(queue.empty(), "emptied queue not empty");
+    }
+};
+
+class TestSparsePriorityWorklist : public Test
+{
+public:
+    TestSparsePriorityWorklist() : Test("test sparse priority worklist")
+    {}
+
+    void test()
+    {
+        SparsePriorityWorklist<int, identity> queue;
+        check(queue.empty(), "empty queue not empty");
+
+        check(queue.push(1, 7ull << 32), "Did not push element");
+        check(queue.push(13, ~0ull), "Did not push element");
+        check(queue.push(4, 3), "Did not push element");
+        check(!queue.push(4, 5), "Pushed queued element");
+        check(queue.push(2, 3), "Did not push element");
+
+        check(queue.size() == 4, "BUG in size");
+        check(queue.isQueued(4), "BUG in isQueued");
+
+        check(queue.pop() == 2, "Wrong pop order");
+        check(queue.pop() == 4, "Wrong pop order");
+        check(!queue.isQueued(4), "BUG in isQueued");
+
+        check(queue.push(4, (7ull << 32) + 1), "Did not push element");
+        check(queue.pop() == 1, "Wrong pop order");
+        check(queue.pop() == 4, "Wrong pop order");
+        check(queue.pop() == 13, "Wrong pop order");
+        check(queue.empty(), "emptied queue not empty");
+
+        for (int i = 0; i < 20000; ++i)
+            queue.push(i, static_cast<uint64_t>(20000 - i) << 20);
+        for (int i = 20000; i-- > 0;)
+            check(queue.pop() == i, "Wrong pop order");
+        check(queue.empty(), "emptied queue not empty");
+    }
+};
+
+class TestArena : public Test
+{
+    struct Obj {
+        int &destroyed;
+        uint64_t data[3];
+        Obj(int &d, uint64_t v) : destroyed(d), data{v, v, v} {}
+        ~Obj() { ++destroyed; }
+    };
+
+public:
+    TestArena() : Test("test size-class arena")
+    {}
+
+    void test()
+    {
+        int destroyed = 0;
+        SizeClassArena arena;
+        std::vector<ArenaPtr<Obj>> objs;
+
+        for (uint64_t i = 0; i < 10000; ++i) {
+            objs.emplace_back(arena.create<Obj>(destroyed, i));
+            // objects of a different size class in between
+            arena.create<char>('a');
+        }
+
+        // objects of the same size are packed in the slabs
+        check(arena.getSlabsNum() < 10, "Too many slabs");
+        check(reinterpret_cast<uintptr_t>(objs[1].get())
+              - reinterpret_cast<uintptr_t>(objs[0].get())
+              == (sizeof(Obj) + SizeClassArena::ALIGNMENT - 1)
+                 / SizeClassArena::ALIGNMENT * SizeClassArena::ALIGNMENT,
+              "Objects are not packed");
+
+        for (uint64_t i = 0; i < objs.size(); ++i) {
+            check(objs[i]->data[2] == i, "Wrong object contents");
+            check(reinterpret_cast<uintptr_t>(objs[i].get())
+                  % SizeClassArena::ALIGNMENT == 0, "Object is not aligned");
+        }
+
+        // big objects
+        auto *big = static_cast<char *>(arena.allocate(10000));
+        big[9999] = 1;
+
+        objs.clear();
+        check(destroyed == 10000, "Objects were not destroyed");
+
+        // objects allocated in the active arena
+        struct Node : public ArenaAllocated {
+            uint64_t data[5];
+        };
+
+        SizeClassArena nodesArena;
+        std::vector<Node *> nodes;
+        {
+            ArenaScope scope(&nodesArena);
+            for (int i = 0; i < 100; ++i)
+                nodes.push_back(new Node());
+        }
+        check(nodesArena.getAllocatedBytes() > 100 * sizeof(Node),
+              "Nodes were not allocated in the arena");
+
+        auto allocated = nodesArena.getAllocatedBytes();
+        Node *heapNode = new Node();
+        check(nodesArena.getAllocatedBytes() == allocated,
+              "Node allocated in inactive arena");
+        delete heapNode;
+
+        // the memory of deleted nodes goes back to the arena
+        for (Node *nd : nodes)
+            delete nd;
+        check(nodesArena.getAllocatedBytes() == 0,
+              "The nodes were not given back to the arena");
+
+        // containers that take the memory from the active arena
+        using MapT = std::map<int, int, std::less<int>,
+                              ArenaAllocator<std::pair<const int, int>>>;
+        {
+            ArenaScope scope(&nodesArena);
+            MapT map;
+            for (int i = 0; i < 100; ++i)
+                map.emplace(i, i);
+            check(nodesArena.getAllocatedBytes() > 100 * 2 * sizeof(int),
+                  "Map nodes were not allocated in the arena");
+        }
+        check(nodesArena.getAllocatedBytes() == 0,
+              "Map nodes were not given back to the arena");
+    }
+};
+
 class TestIntervalsHandling : public Test
 {
 public:
@@ -161,6 +337,9 @@ int main()
     Runner.add(new TestLIFO());
     Runner.add(new TestFIFO());
     Runner.add(new TestPrioritySet());
+    Runner.add(new TestPriorityWorklist());
+    Runner.add(new TestSparsePriorityWorklist());
+    Runner.add(new TestArena());
     Runner.add(new TestIntervalsHandling());
 
     return Runner();
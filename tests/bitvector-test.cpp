@@ -4,6 +4,7 @@
 #include <random>
 
 #include "dg/ADT/Bitvector.h"
+#include "dg/ADT/HybridBitvector.h"
 
 using dg::ADT::SparseBitvector;
 
@@ -205,3 +206,142 @@ TEST_CASE("Merge random bitvectors (union)", "SparseBitvector") {
 //    B2.merge(B1);
 //    REQUIRE(B1 == B2);
 }
+
+TEST_CASE("Size of bitvector", "SparseBitvector") {
+    SparseBitvector B;
+    REQUIRE(B.size() == 0);
+
+    REQUIRE(B.set(10) == false);
+    REQUIRE(B.set(10) == true);
+    REQUIRE(B.size() == 1);
+    B.set(11);
+    B.set(100000);
+    B.set(5);
+    REQUIRE(B.size() == 4);
+
+    REQUIRE(B.unset(11) == true);
+    REQUIRE(B.unset(11) == false);
+    REQUIRE(B.unset(12) == false);
+    REQUIRE(B.size() == 3);
+
+    SparseBitvector B2;
+    B2.set(10);
+    B2.set(64);
+    B2.set(1UL << 40);
+    REQUIRE(B.set(B2) == true);
+    REQUIRE(B.size() == 5);
+    REQUIRE(B.set(B2) == false);
+    REQUIRE(B.size() == 5);
+
+    B.reset();
+    REQUIRE(B.size() == 0);
+    REQUIRE(B.empty());
+}
+
+TEST_CASE("Compare with map-based bitvector", "SparseBitvector") {
+    SparseBitvector B1, B2;
+    dg::ADT::SparseBitvectorMap M1, M2;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<uint64_t> distribution(0, 5000);
+
+    for (int n = 0; n < 50; ++n) {
+        for (int i = 0; i < 20; ++i) {
+            auto x = distribution(generator);
+            auto y = distribution(generator);
+            REQUIRE(B1.set(x) == M1.set(x));
+            REQUIRE(B2.set(y) == M2.set(y));
+        }
+
+        REQUIRE(B1.set(B2) == M1.set(M2));
+        REQUIRE(B1.size() == M1.size());
+
+        auto mit = M1.begin();
+        for (auto x : B1) {
+            REQUIRE(mit != M1.end());
+            REQUIRE(x == *mit);
+            ++mit;
+        }
+        REQUIRE(mit == M1.end());
+    }
+}
+
+TEST_CASE("Hybrid bitvector representations", "HybridBitvector") {
+    using dg::ADT::HybridBitvector;
+    HybridBitvector B;
+
+    REQUIRE(B.getMode() == HybridBitvector::Mode::SMALL);
+    B.set(100000);
+    B.set(3);
+    REQUIRE(B.getMode() == HybridBitvector::Mode::SMALL);
+    for (int i = 0; i < 10; ++i)
+        B.set(200000 + 1000*i);
+    REQUIRE(B.getMode() == HybridBitvector::Mode::SPARSE);
+    for (int i = 0; i < 100000; i += 7)
+        B.set(i);
+    REQUIRE(B.getMode() == HybridBitvector::Mode::DENSE);
+
+    std::set<uint64_t> S{100000, 3};
+    for (int i = 0; i < 10; ++i)
+        S.insert(200000 + 1000*i);
+    for (int i = 0; i < 100000; i += 7)
+        S.insert(i);
+
+    REQUIRE(B.size() == S.size());
+    auto sit = S.begin();
+    for (auto x : B) {
+        REQUIRE(sit != S.end());
+        REQUIRE(x == *sit);
+        ++sit;
+    }
+    REQUIRE(sit == S.end());
+}
+
+TEST_CASE("Hybrid bitvector operations", "HybridBitvector") {
+    using dg::ADT::HybridBitvector;
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<uint64_t> small(0, 3000);
+    std::uniform_int_distribution<uint64_t> large(0, 1UL << 40);
+
+    for (int n = 0; n < 50; ++n) {
+        HybridBitvector B1, B2;
+        std::set<uint64_t> S1, S2;
+        auto& dist1 = (n % 2) ? small : large;
+        auto& dist2 = (n % 3) ? small : large;
+
+        for (int i = 0; i < 5*n; ++i) {
+            auto x = dist1(generator);
+            auto y = dist2(generator);
+            REQUIRE(B1.set(x) == (S1.count(x) > 0));
+            REQUIRE(B2.set(y) == (S2.count(y) > 0));
+            S1.insert(x);
+            S2.insert(y);
+        }
+
+        bool subset = std::includes(S1.begin(), S1.end(), S2.begin(), S2.end());
+        REQUIRE(B2.isSubsetOf(B1) == subset);
+
+        auto I = B1;
+        std::set<uint64_t> SI;
+        std::set_intersection(S1.begin(), S1.end(), S2.begin(), S2.end(),
+                              std::inserter(SI, SI.end()));
+        I.intersect(B2);
+        REQUIRE(I.size() == SI.size());
+        for (auto x : SI)
+            REQUIRE(I.get(x));
+
+        auto oldsize = S1.size();
+        S1.insert(S2.begin(), S2.end());
+        REQUIRE(B1.set(B2) == (oldsize != S1.size()));
+        REQUIRE(B1.size() == S1.size());
+        REQUIRE(B2.isSubsetOf(B1));
+
+        auto sit = S1.begin();
+        for (auto x : B1) {
+            REQUIRE(x == *sit);
+            ++sit;
+        }
+        REQUIRE(sit == S1.end());
+    }
+}
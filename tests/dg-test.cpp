@@ -161,6 +161,41 @@ public:
 
         check(IT == IT2, "containers with same content does not equal");
 #endif
+
+        // more elements than fit into the inline storage
+        DGContainer<int, 4> C;
+        for (int i = 20; i > 0; --i)
+            check(C.insert(2*i), "returned false with new element");
+        check(C.size() == 20, "size() bug");
+        check(!C.insert(10), "double inserted element");
+        check(!C.contains(11), "contains element that was not inserted");
+
+        int prev = 0;
+        for (int x : C) {
+            check(x > prev, "container is not sorted");
+            prev = x;
+        }
+
+        check(C.erase(10) == 1, "did not erase element");
+        check(C.erase(10) == 0, "erased element twice");
+        check(!C.contains(10) && C.contains(12), "erase() bug");
+
+        DGContainer<int, 4> C2(C);
+        check(C2 == C, "copy differs");
+
+        DGContainer<int, 4> small;
+        small.insert(4);
+        small.insert(5);
+        small.insert(12);
+        C.intersect(small);
+        check(C.size() == 2 && C.contains(4) && C.contains(12),
+              "intersect() bug");
+
+        small.swap(C2);
+        check(small.size() == 19 && C2.size() == 3, "swap() bug");
+
+        C2.clear();
+        check(C2.empty(), "clear() bug");
     }
 };
 
@@ -300,6 +335,19 @@ private:
         check(n2.getControlDependenciesNum() == 1, "add or size method bug");
         check(n1.getRevControlDependenciesNum() == 1, "add or size method bug");
         check(n2.getDataDependenciesNum() == 0, "remove bug");
+
+        // remove all edges at once, also the edge from the node to itself
+        n1.addDataDependence(&n1);
+        n1.addDataDependence(&n2);
+        n2.addDataDependence(&n1);
+        n1.removeOutcomingDDs();
+        check(n1.getDataDependenciesNum() == 0, "remove bug");
+        check(n1.getRevDataDependenciesNum() == 1, "remove bug");
+        check(n2.getRevDataDependenciesNum() == 0, "remove bug");
+        check(n2.getDataDependenciesNum() == 1, "remove bug");
+        n1.removeIncomingCDs();
+        check(n1.getRevControlDependenciesNum() == 0, "remove bug");
+        check(n2.getControlDependenciesNum() == 0, "remove bug");
     }
 
     #define NODES_NUM 10
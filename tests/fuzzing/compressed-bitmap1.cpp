@@ -0,0 +1,50 @@
+#undef NDEBUG
+
+#include <set>
+#include <cassert>
+#include <cstdint>
+
+#include "dg/ADT/CompressedBitmap.h"
+
+using namespace dg::ADT;
+
+extern "C"
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    std::set<uint64_t> S;
+    CompressedBitmap A, B;
+
+    // the numbers are 32-bit so that they often fall
+    // into the same chunks. Every number is added
+    // as a range of the length given by the top bits
+    const auto elems = size / (sizeof(uint32_t));
+    const uint32_t *numbers = reinterpret_cast<const uint32_t *>(data);
+    for (unsigned i = 0; i < elems; ++i) {
+        auto &C = i % 2 ? A : B;
+        uint64_t n = numbers[i] & 0xfffffff;
+        for (uint64_t j = 0; j <= (numbers[i] >> 28); ++j) {
+            C.set(n + j);
+            S.insert(n + j);
+        }
+    }
+
+    if (elems % 3 == 0)
+        A.optimize();
+
+    A.set(B);
+    assert(A.size() == S.size());
+
+    auto it = S.begin();
+    for (auto x : A) {
+        assert(it != S.end());
+        assert(*it == x);
+        ++it;
+    }
+    assert(it == S.end());
+
+    for (auto x : S) {
+        assert(A.get(x));
+        assert(A.get(x + 1) == (S.count(x + 1) > 0));
+    }
+
+    return 0;
+}
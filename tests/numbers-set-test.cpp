@@ -1,6 +1,9 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+#include <set>
+#include <vector>
+
 #include "dg/ADT/NumberSet.h"
 
 using namespace dg::ADT;
@@ -128,3 +131,107 @@ TEST_CASE("Iterate mixed elements", "SmallNumberSet") {
         REQUIRE(B.has(x));
 }
 
+
+template <typename SetT>
+static std::vector<uint64_t> elements(const SetT& C) {
+    std::vector<uint64_t> ret;
+    for (auto x : C)
+        ret.push_back(x);
+    return ret;
+}
+
+TEST_CASE("Compressed bitmap containers", "CompressedBitmap") {
+    CompressedBitmap C;
+    REQUIRE(C.empty());
+    REQUIRE(C.size() == 0);
+    REQUIRE(C.begin() == C.end());
+
+    // a sparse chunk, a range and a dense chunk
+    std::set<uint64_t> S;
+    for (uint64_t i = 0; i < 100; ++i)
+        S.insert(i * 97);
+    for (uint64_t i = 0; i < 20000; ++i)
+        S.insert((1 << 16) + 1000 + i);
+    for (uint64_t i = 0; i < 30000; ++i)
+        S.insert((5ull << 16) + 2*i);
+    S.insert(1000000000000000);
+
+    for (auto x : S)
+        REQUIRE(!C.set(x));
+    for (auto x : S)
+        REQUIRE(C.set(x));
+
+    REQUIRE(C.size() == S.size());
+    REQUIRE(C.getContainersNum() == 4);
+    REQUIRE(!C.get(1));
+    REQUIRE(!C.get((5ull << 16) + 1));
+    REQUIRE(!C.get(1000000000000001));
+
+    C.optimize();
+    REQUIRE(C.size() == S.size());
+    for (auto x : S)
+        REQUIRE(C.get(x));
+
+    // the iteration is in order
+    REQUIRE(elements(C) == std::vector<uint64_t>(S.begin(), S.end()));
+}
+
+TEST_CASE("Compressed bitmap union", "CompressedBitmap") {
+    CompressedBitmap A, B;
+    std::set<uint64_t> S;
+
+    for (uint64_t i = 0; i < 5000; ++i) {
+        A.set(3*i);
+        S.insert(3*i);
+    }
+    for (uint64_t i = 0; i < 70000; ++i) {
+        B.set(i + 10000);
+        S.insert(i + 10000);
+    }
+    B.optimize();
+    B.set(1ull << 40);
+    S.insert(1ull << 40);
+
+    REQUIRE(A.set(B));
+    REQUIRE(!A.set(B));
+    REQUIRE(A.size() == S.size());
+    REQUIRE(elements(A) == std::vector<uint64_t>(S.begin(), S.end()));
+
+    // union of runs
+    CompressedBitmap R1, R2;
+    for (uint64_t i = 0; i < 10000; ++i) {
+        R1.set(i);
+        R2.set(i + 5000);
+    }
+    R1.optimize();
+    R2.optimize();
+    REQUIRE(R1.set(R2));
+    REQUIRE(R1.size() == 15000);
+    REQUIRE(*R1.begin() == 0);
+}
+
+TEST_CASE("Compress big set", "BitvectorNumberSet") {
+    BitvectorNumberSet B, C;
+    std::set<uint64_t> S;
+
+    for (uint64_t i = 0; i < 10000; ++i) {
+        REQUIRE(B.add(100000 + i));
+        S.insert(100000 + i);
+    }
+    REQUIRE(B.isCompressed());
+    REQUIRE(!B.add(100000));
+    REQUIRE(B.size() == S.size());
+    REQUIRE(elements(B) == std::vector<uint64_t>(S.begin(), S.end()));
+
+    REQUIRE(C.add(1));
+    REQUIRE(C.add(B));
+    REQUIRE(!C.add(B));
+    REQUIRE(C.isCompressed());
+    REQUIRE(C.size() == S.size() + 1);
+
+    SmallNumberSet Sm;
+    for (auto x : S)
+        REQUIRE(Sm.add(x));
+    REQUIRE(Sm.size() == S.size());
+    REQUIRE(elements(Sm) == std::vector<uint64_t>(S.begin(), S.end()));
+}
@@ -1,9 +1,13 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 
+#include <random>
+#include <set>
+
 #include "dg/analysis/PointsTo/PSNode.h"
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
 #include "dg/analysis/PointsTo/Pointer.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFI.h"
 
 using dg::analysis::pta::PSNode;
 using dg::analysis::pta::PSNodeType;
@@ -17,6 +21,11 @@ using dg::analysis::pta::SmallOffsetsPointsToSet;
 using dg::analysis::pta::AlignedSmallOffsetsPointsToSet;
 using dg::analysis::pta::PointerIdPointsToSet;
 using dg::analysis::pta::AlignedPointerIdPointsToSet;
+using dg::analysis::pta::HybridPointerIdPointsToSet;
+using dg::analysis::pta::InternedPointsToSet;
+using dg::analysis::pta::BddPointsToSet;
+using dg::analysis::pta::DynamicPointsToSet;
+using dg::analysis::pta::PointsToSetKind;
 
 template<typename PTSetT>
 void queryingEmptySet() {
@@ -265,6 +274,9 @@ TEST_CASE("Querying empty set", "PointsToSet") {
     queryingEmptySet<SmallOffsetsPointsToSet>();
     queryingEmptySet<AlignedSmallOffsetsPointsToSet>();
     queryingEmptySet<AlignedPointerIdPointsToSet>();
+    queryingEmptySet<HybridPointerIdPointsToSet>();
+    queryingEmptySet<InternedPointsToSet>();
+    queryingEmptySet<BddPointsToSet>();
 }
 
 TEST_CASE("Add an element", "PointsToSet") {
@@ -275,6 +287,9 @@ TEST_CASE("Add an element", "PointsToSet") {
     addAnElement<SmallOffsetsPointsToSet>();
     addAnElement<AlignedSmallOffsetsPointsToSet>();
     addAnElement<AlignedPointerIdPointsToSet>();
+    addAnElement<HybridPointerIdPointsToSet>();
+    addAnElement<InternedPointsToSet>();
+    addAnElement<BddPointsToSet>();
 }
 
 TEST_CASE("Add few elements", "PointsToSet") {
@@ -285,6 +300,9 @@ TEST_CASE("Add few elements", "PointsToSet") {
     addFewElements<SmallOffsetsPointsToSet>();
     addFewElements<AlignedSmallOffsetsPointsToSet>();
     addFewElements<AlignedPointerIdPointsToSet>();
+    addFewElements<HybridPointerIdPointsToSet>();
+    addFewElements<InternedPointsToSet>();
+    addFewElements<BddPointsToSet>();
 }
 
 TEST_CASE("Add few elements 2", "PointsToSet") {
@@ -295,6 +313,9 @@ TEST_CASE("Add few elements 2", "PointsToSet") {
     addFewElements2<SmallOffsetsPointsToSet>();
     addFewElements2<AlignedSmallOffsetsPointsToSet>();
     addFewElements2<AlignedPointerIdPointsToSet>();
+    addFewElements2<HybridPointerIdPointsToSet>();
+    addFewElements2<InternedPointsToSet>();
+    addFewElements2<BddPointsToSet>();
 }
 
 TEST_CASE("Merge points-to sets", "PointsToSet") {
@@ -305,6 +326,9 @@ TEST_CASE("Merge points-to sets", "PointsToSet") {
     mergePointsToSets<SmallOffsetsPointsToSet>();
     mergePointsToSets<AlignedSmallOffsetsPointsToSet>();
     mergePointsToSets<AlignedPointerIdPointsToSet>();
+    mergePointsToSets<HybridPointerIdPointsToSet>();
+    mergePointsToSets<InternedPointsToSet>();
+    mergePointsToSets<BddPointsToSet>();
 }
 
 TEST_CASE("Remove element", "PointsToSet") { //SeparateOffsetsPointsToSet has different remove behavior, it isn't tested here
@@ -314,6 +338,9 @@ TEST_CASE("Remove element", "PointsToSet") { //SeparateOffsetsPointsToSet has di
     removeElement<SmallOffsetsPointsToSet>();
     removeElement<AlignedSmallOffsetsPointsToSet>();
     removeElement<AlignedPointerIdPointsToSet>();   
+    removeElement<HybridPointerIdPointsToSet>();
+    removeElement<InternedPointsToSet>();
+    removeElement<BddPointsToSet>();
 }
 
 TEST_CASE("Remove few elements", "PointsToSet") { //SeparateOffsetsPointsToSet has different remove behavior, it isn't tested here
@@ -323,6 +350,9 @@ TEST_CASE("Remove few elements", "PointsToSet") { //SeparateOffsetsPointsToSet h
     removeFewElements<SmallOffsetsPointsToSet>();
     removeFewElements<AlignedSmallOffsetsPointsToSet>();
     removeFewElements<AlignedPointerIdPointsToSet>();
+    removeFewElements<HybridPointerIdPointsToSet>();
+    removeFewElements<InternedPointsToSet>();
+    removeFewElements<BddPointsToSet>();
 }
 
 TEST_CASE("Remove all elements pointing to a target", "PointsToSet") { //SeparateOffsetsPointsToSet has different behavior, it isn't tested here
@@ -332,6 +362,9 @@ TEST_CASE("Remove all elements pointing to a target", "PointsToSet") { //Separat
     removeAnyTest<SmallOffsetsPointsToSet>();
     removeAnyTest<AlignedSmallOffsetsPointsToSet>();
     removeAnyTest<AlignedPointerIdPointsToSet>();
+    removeAnyTest<HybridPointerIdPointsToSet>();
+    removeAnyTest<InternedPointsToSet>();
+    removeAnyTest<BddPointsToSet>();
 }
 
 TEST_CASE("Test various points-to functions", "PointsToSet") {
@@ -342,6 +375,9 @@ TEST_CASE("Test various points-to functions", "PointsToSet") {
     pointsToTest<SmallOffsetsPointsToSet>();
     pointsToTest<AlignedSmallOffsetsPointsToSet>();
     pointsToTest<AlignedPointerIdPointsToSet>();
+    pointsToTest<HybridPointerIdPointsToSet>();
+    pointsToTest<InternedPointsToSet>();
+    pointsToTest<BddPointsToSet>();
 }
 
 TEST_CASE("Test small overflow set behavior", "PointsToSet") {
@@ -352,3 +388,393 @@ TEST_CASE("Test aligned overflow set behavior", "PointsToSet") {
     testAlignedOverflowBehavior<AlignedSmallOffsetsPointsToSet>();
     testAlignedOverflowBehavior<AlignedPointerIdPointsToSet>();
 }
+
+template<typename PTSetT>
+void denseSetsTest() { // the set goes through all its representations
+    PTSetT S1, S2;
+    PointerSubgraph PS;
+    std::vector<PSNode *> nodes;
+    for (int i = 0; i < 200; ++i)
+        nodes.push_back(PS.create(PSNodeType::ALLOC));
+
+    for (int i = 0; i < 200; i += 2)
+        REQUIRE(S1.add(Pointer(nodes[i], 0)) == true);
+    for (int i = 0; i < 200; i += 3)
+        S2.add(Pointer(nodes[i], 0));
+
+    REQUIRE(S1.size() == 100);
+    REQUIRE(S2.size() == 67);
+    REQUIRE(!S2.isSubsetOf(S1));
+
+    auto S3 = S1;
+    REQUIRE(S3.intersect(S2) == true);
+    REQUIRE(S3.size() == 34);
+    REQUIRE(S3.isSubsetOf(S1));
+    REQUIRE(S3.isSubsetOf(S2));
+    for (const auto& ptr : S3)
+        REQUIRE((S1.has(ptr) && S2.has(ptr)));
+
+    REQUIRE(S1.add(S2) == true);
+    REQUIRE(S1.add(S2) == false);
+    REQUIRE(S1.size() == 133);
+    REQUIRE(S2.isSubsetOf(S1));
+    for (int i = 0; i < 200; ++i)
+        REQUIRE(S1.has(Pointer(nodes[i], 0)) == (i % 2 == 0 || i % 3 == 0));
+
+    size_t n = 0;
+    for (const auto& ptr : S1) {
+        REQUIRE(ptr.offset == 0);
+        ++n;
+    }
+    REQUIRE(n == 133);
+
+    REQUIRE(S1.removeAny(nodes[0]) == true);
+    REQUIRE(S1.size() == 132);
+}
+
+TEST_CASE("Test dense sets", "PointsToSet") {
+    denseSetsTest<HybridPointerIdPointsToSet>();
+}
+
+TEST_CASE("Test interned sets", "PointsToSet") {
+    PointerSubgraph PS;
+    PSNode* A = PS.create(PSNodeType::ALLOC);
+    PSNode* B = PS.create(PSNodeType::ALLOC);
+
+    InternedPointsToSet S1, S2, S3;
+    REQUIRE(S1 == S2);
+    S1.add(Pointer(A, 0));
+    S1.add(Pointer(B, 8));
+    REQUIRE(S1 != S2);
+    // equal sets share the handle regardless of
+    // the order in which they were built
+    S2.add(Pointer(B, 8));
+    S2.add(Pointer(A, 0));
+    REQUIRE(S1 == S2);
+    REQUIRE(S1.getHandle() == S2.getHandle());
+
+    S3.add(Pointer(A, 0));
+    auto poolSize = S3.getPoolSize();
+    REQUIRE(S3.add(S1) == true);
+    REQUIRE(S3 == S1);
+    REQUIRE(S3.add(S1) == false);
+    // no new set, the old set of S3 was released
+    REQUIRE(S3.getPoolSize() == poolSize - 1);
+
+    REQUIRE(S3.remove(Pointer(B, 8)) == true);
+    REQUIRE(S3.size() == 1);
+    REQUIRE(S1.size() == 2);
+    REQUIRE(S3.add(Pointer(A, dg::analysis::Offset::UNKNOWN)) == true);
+    REQUIRE(S3.size() == 1);
+    REQUIRE(S3.has(Pointer(A, dg::analysis::Offset::UNKNOWN)));
+    REQUIRE(S1.has(Pointer(A, 0)));
+}
+
+TEST_CASE("Test interned sets are released", "PointsToSet") {
+    PointerSubgraph PS;
+    std::vector<PSNode *> nodes;
+    for (int i = 0; i < 100; ++i)
+        nodes.push_back(PS.create(PSNodeType::ALLOC));
+
+    InternedPointsToSet *S;
+    {
+        dg::analysis::pta::PointerIdRegistry::Scope scope(PS.getIdRegistry());
+        S = new InternedPointsToSet();
+    }
+
+    // the intermediate sets are not kept in the pool
+    for (PSNode *nd : nodes)
+        S->add(Pointer(nd, 0));
+    REQUIRE(S->size() == 100);
+    REQUIRE(S->getPoolSize() == 2);
+
+    {
+        dg::analysis::pta::PointerIdRegistry::Scope scope(PS.getIdRegistry());
+        InternedPointsToSet S2(*S);
+        REQUIRE(S2.remove(Pointer(nodes[0], 0)));
+        REQUIRE(S->getPoolSize() == 3);
+    }
+    REQUIRE(S->getPoolSize() == 2);
+
+    S->clear();
+    REQUIRE(S->getPoolSize() == 1);
+    delete S;
+
+    // the set may outlive the registry
+    {
+        PointerSubgraph PS2;
+        PSNode *A = PS2.create(PSNodeType::ALLOC);
+        dg::analysis::pta::PointerIdRegistry::Scope scope(PS2.getIdRegistry());
+        S = new InternedPointsToSet();
+        S->add(Pointer(A, 0));
+    }
+    delete S;
+}
+
+TEST_CASE("Test BDD sets", "PointsToSet") {
+    PointerSubgraph PS;
+    std::vector<PSNode *> nodes;
+    for (int i = 0; i < 50; ++i)
+        nodes.push_back(PS.create(PSNodeType::ALLOC));
+
+    std::default_random_engine generator;
+    std::uniform_int_distribution<uint64_t> node(0, nodes.size() - 1);
+    std::uniform_int_distribution<uint64_t> offset(0, 1000);
+
+    BddPointsToSet B1, B2;
+    std::set<Pointer> S1, S2;
+    for (int i = 0; i < 500; ++i) {
+        Pointer p1(nodes[node(generator)], offset(generator));
+        Pointer p2(nodes[node(generator)], offset(generator) % 8);
+        REQUIRE(B1.add(p1) == S1.insert(p1).second);
+        REQUIRE(B2.add(p2) == S2.insert(p2).second);
+    }
+
+    REQUIRE(B1.size() == S1.size());
+    REQUIRE(B2.size() == S2.size());
+
+    S1.insert(S2.begin(), S2.end());
+    REQUIRE(B1.add(B2) == true);
+    REQUIRE(B1.add(B2) == false);
+    REQUIRE(B1.size() == S1.size());
+
+    // iterate in the same order as std::set would
+    // (the nodes get IDs in the order of creation)
+    size_t n = 0;
+    for (const auto& ptr : B1) {
+        REQUIRE(S1.count(ptr) == 1);
+        ++n;
+    }
+    REQUIRE(n == S1.size());
+
+    for (int i = 0; i < 50; i += 3) {
+        bool had = B1.pointsToTarget(nodes[i]);
+        REQUIRE(B1.removeAny(nodes[i]) == had);
+        REQUIRE(!B1.pointsToTarget(nodes[i]));
+    }
+    for (const auto& ptr : S1) {
+        bool removed = false;
+        for (int i = 0; i < 50; i += 3)
+            removed |= ptr.target == nodes[i];
+        REQUIRE(B1.has(ptr) == !removed);
+    }
+
+    REQUIRE(B2.add(Pointer(nodes[1], dg::analysis::Offset::UNKNOWN)) == true);
+    REQUIRE(B2.has(Pointer(nodes[1], dg::analysis::Offset::UNKNOWN)));
+    for (const auto& ptr : B2) {
+        if (ptr.target == nodes[1])
+            REQUIRE(ptr.offset.isUnknown());
+    }
+}
+
+TEST_CASE("Test BDD sets are released", "PointsToSet") {
+    size_t globalNodes = BddPointsToSet().getBddNodesNum();
+
+    BddPointsToSet *S;
+    {
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        dg::analysis::pta::PointerIdRegistry::Scope scope(PS.getIdRegistry());
+        S = new BddPointsToSet{Pointer(A, 0), Pointer(A, 4)};
+        REQUIRE(PS.getIdRegistry()->getBddManager() != nullptr);
+        // the terminals and the nodes of the set
+        REQUIRE(S->getBddNodesNum() > 2);
+    }
+    // the set may outlive the registry (and its manager)
+    delete S;
+
+    // the nodes of the graph were not added to the manager
+    // of the process-wide registry
+    REQUIRE(BddPointsToSet().getBddNodesNum() == globalNodes);
+
+    // a new graph starts with a new manager
+    PointerSubgraph PS;
+    dg::analysis::pta::PointerIdRegistry::Scope scope(PS.getIdRegistry());
+    REQUIRE(PS.getIdRegistry()->getBddManager() == nullptr);
+    REQUIRE(BddPointsToSet().getBddNodesNum() == 2);
+}
+
+TEST_CASE("Test dynamic sets", "PointsToSet") {
+    for (unsigned i = 0; i <= static_cast<unsigned>(PointsToSetKind::BDD); ++i) {
+        auto kind = static_cast<PointsToSetKind>(i);
+        PointsToSetKind byName;
+        REQUIRE(DynamicPointsToSet::getKindByName(
+                    DynamicPointsToSet::getKindName(kind), byName));
+        REQUIRE(byName == kind);
+
+        // the sets get the kind of the graph whose registry is active
+        PointerSubgraph PS(kind);
+        REQUIRE(PS.getPointsToSetKind() == kind);
+        dg::analysis::pta::PointerIdRegistry::Scope scope(PS.getIdRegistry());
+        REQUIRE(DynamicPointsToSet().getKind() == kind);
+        REQUIRE(PS.create(PSNodeType::ALLOC)->pointsTo.getKind() == kind);
+
+        queryingEmptySet<DynamicPointsToSet>();
+        addAnElement<DynamicPointsToSet>();
+        addFewElements<DynamicPointsToSet>();
+        addFewElements2<DynamicPointsToSet>();
+        mergePointsToSets<DynamicPointsToSet>();
+        pointsToTest<DynamicPointsToSet>();
+        // SeparateOffsetsPointsToSet has different remove behavior
+        if (kind != PointsToSetKind::SEPARATE_OFFSETS) {
+            removeElement<DynamicPointsToSet>();
+            removeFewElements<DynamicPointsToSet>();
+            removeAnyTest<DynamicPointsToSet>();
+        }
+
+        // copying, moving and clearing keep the kind
+        PSNode* A = PS.create(PSNodeType::ALLOC);
+        DynamicPointsToSet S1{Pointer(A, 0), Pointer(A, 4)};
+        DynamicPointsToSet S2 = S1;
+        DynamicPointsToSet S3 = std::move(S2);
+        REQUIRE(S3.getKind() == kind);
+        REQUIRE(S3.size() == 2);
+        S2 = S3;
+        REQUIRE(S2.size() == 2);
+        S3.clear();
+        REQUIRE(S3.getKind() == kind);
+        REQUIRE(S3.empty());
+        S3.swap(S2);
+        REQUIRE(S3.size() == 2);
+        REQUIRE(S2.empty());
+    }
+
+    PointsToSetKind unused;
+    REQUIRE(!DynamicPointsToSet::getKindByName("no-such-set", unused));
+
+    // the sets of the default kind are stored inline
+    REQUIRE(sizeof(DynamicPointsToSet)
+            <= sizeof(OffsetsSetPointsToSet) + sizeof(void *));
+}
+
+template<typename PTSetT>
+void separateRegistriesTest() {
+    PointerSubgraph PS1, PS2;
+    PSNode* A = PS1.create(PSNodeType::ALLOC);
+    PSNode* B = PS2.create(PSNodeType::ALLOC);
+    PSNode* C = PS2.create(PSNodeType::ALLOC);
+
+    // the sets are numbered by the graph whose registry is active
+    dg::analysis::pta::PointerIdRegistry::Scope scope1(PS1.getIdRegistry());
+    PTSetT S1;
+    REQUIRE(S1.add(Pointer(A, 4)));
+    {
+        dg::analysis::pta::PointerIdRegistry::Scope scope2(PS2.getIdRegistry());
+        PTSetT S2;
+        REQUIRE(S2.add(Pointer(C, 8)));
+        REQUIRE(S2.add(Pointer(B, 0)));
+
+        // merging sets numbered differently
+        REQUIRE(S1.add(S2) == true);
+        REQUIRE(S1.add(S2) == false);
+        REQUIRE(S1.size() == 3);
+        REQUIRE(S1.has(Pointer(A, 4)));
+        REQUIRE(S1.has(Pointer(B, 0)));
+        REQUIRE(S1.has(Pointer(C, 8)));
+    }
+
+    // the registry of the second graph did not get the pointer of A
+    REQUIRE(PS1.getIdRegistry()->getNodesNum()
+            + PS1.getIdRegistry()->getPointersNum() > 0);
+    REQUIRE(PS2.getIdRegistry() != PS1.getIdRegistry());
+
+    size_t n = 0;
+    for (const auto& ptr : S1) {
+        REQUIRE((ptr.target == A || ptr.target == B || ptr.target == C));
+        ++n;
+    }
+    REQUIRE(n == 3);
+}
+
+// a set that took the pointers of a set of another graph
+// must not use the numbering of that graph
+template<typename PTSetT>
+void foreignSetTest() {
+    PointerSubgraph PS1;
+    PSNode* A = PS1.create(PSNodeType::ALLOC);
+    dg::analysis::pta::PointerIdRegistry::Scope scope1(PS1.getIdRegistry());
+    PTSetT S1;
+    {
+        PointerSubgraph PS2;
+        dg::analysis::pta::PointerIdRegistry::Scope scope2(PS2.getIdRegistry());
+        PTSetT S2{Pointer(A, 0), Pointer(A, 8)};
+        REQUIRE(S1.add(S2) == true);
+    }
+
+    REQUIRE(S1.size() == 2);
+    REQUIRE(S1.has(Pointer(A, 8)));
+    REQUIRE(S1.add(Pointer(A, 16)) == true);
+    REQUIRE(S1.pointsToTarget(A));
+    REQUIRE(S1.removeAny(A) == true);
+    REQUIRE(S1.empty());
+}
+
+TEST_CASE("Test separate ID registries", "PointsToSet") {
+    foreignSetTest<PointerIdPointsToSet>();
+    foreignSetTest<SmallOffsetsPointsToSet>();
+    foreignSetTest<AlignedSmallOffsetsPointsToSet>();
+    foreignSetTest<AlignedPointerIdPointsToSet>();
+    foreignSetTest<HybridPointerIdPointsToSet>();
+    foreignSetTest<InternedPointsToSet>();
+    foreignSetTest<BddPointsToSet>();
+
+    separateRegistriesTest<PointerIdPointsToSet>();
+    separateRegistriesTest<SmallOffsetsPointsToSet>();
+    separateRegistriesTest<AlignedSmallOffsetsPointsToSet>();
+    separateRegistriesTest<AlignedPointerIdPointsToSet>();
+    separateRegistriesTest<HybridPointerIdPointsToSet>();
+    separateRegistriesTest<InternedPointsToSet>();
+    separateRegistriesTest<BddPointsToSet>();
+
+    PointerSubgraph PS;
+    dg::analysis::pta::PointerIdRegistry::Scope scope(PS.getIdRegistry());
+    PSNode* A = PS.create(PSNodeType::ALLOC);
+    PointerIdPointsToSet S{Pointer(A, 0), Pointer(A, 4)};
+    // (A, 0), (A, 4) and (A, UNKNOWN) that was queried when adding
+    REQUIRE(PS.getIdRegistry()->getPointersNum() == 3);
+    REQUIRE(PS.getIdRegistry()->getPointer(
+                PS.getIdRegistry()->getPointerID(Pointer(A, 4))) == Pointer(A, 4));
+
+    // the pointers are indexed by their targets
+    REQUIRE(PS.getIdRegistry()->getPointerIDs(A).size() == 3);
+    PSNode* B = PS.create(PSNodeType::ALLOC);
+    REQUIRE(PS.getIdRegistry()->getPointerIDs(B).empty());
+    REQUIRE(!S.pointsToTarget(B));
+    REQUIRE(S.removeAny(B) == false);
+    REQUIRE(S.removeAny(A) == true);
+    REQUIRE(S.empty());
+
+    // a new graph starts with an empty numbering
+    PointerSubgraph PS2;
+    REQUIRE(PS2.getIdRegistry()->getPointersNum() == 0);
+}
+
+TEST_CASE("Test graphs of different kinds", "PointsToSet") {
+    // the static nodes are shared by all graphs, so the analysis
+    // of a graph does not depend on the graphs created after it
+    PointerSubgraph PS1(PointsToSetKind::POINTER_ID);
+    PSNode *A = PS1.create(PSNodeType::ALLOC);
+    PSNode *N = PS1.create(PSNodeType::CAST, dg::analysis::pta::NULLPTR);
+    PSNode *P = PS1.create(PSNodeType::PHI, dg::analysis::pta::UNKNOWN_MEMORY, A, nullptr);
+    A->addSuccessor(N);
+    N->addSuccessor(P);
+    PS1.setRoot(A);
+
+    {
+        PointerSubgraph PS2(PointsToSetKind::POINTER_ID);
+        PS2.create(PSNodeType::ALLOC);
+    }
+    PointerSubgraph PS3(PointsToSetKind::OFFSETS_SET);
+    PS3.create(PSNodeType::ALLOC);
+
+    dg::analysis::pta::PointerAnalysisFI PA(&PS1);
+    PA.run();
+
+    REQUIRE(N->pointsTo.getKind() == PointsToSetKind::POINTER_ID);
+    REQUIRE(N->pointsTo.size() == 1);
+    REQUIRE(N->doesPointsTo(dg::analysis::pta::NULLPTR, 0));
+    REQUIRE(P->pointsTo.size() == 2);
+    REQUIRE(P->doesPointsTo(A, 0));
+    REQUIRE(P->doesPointsTo(dg::analysis::pta::UnknownPointer));
+    REQUIRE(dg::analysis::pta::NULLPTR->pointsTo.isShared());
+}
@@ -2,13 +2,19 @@
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <map>
 
 #include "test-runner.h"
 #include "test-dg.h"
 
 #include "dg/analysis/PointsTo/PointerSubgraph.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFIParallel.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFSSparse.h"
+#include "dg/analysis/PointsTo/PointerAnalysisAndersen.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSteensgaard.h"
+#include "dg/analysis/PointsTo/PointerSubgraphOptimizations.h"
 
 namespace dg {
 namespace tests {
@@ -909,7 +915,375 @@ public:
         check(L3->doesPointsTo(NULLPTR), "L3 does not point to NULL");
     }
 
-    void test()
+    void loop_propagation()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *C = PS.create(PSNodeType::ALLOC);
+        PSNode *D = PS.create(PSNodeType::ALLOC);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, B);
+        PSNode *PHI = PS.create(PSNodeType::PHI, A, L1, nullptr);
+        PSNode *S1 = PS.create(PSNodeType::STORE, PHI, D);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, D);
+        PSNode *CAST = PS.create(PSNodeType::CAST, L1);
+        PSNode *S2 = PS.create(PSNodeType::STORE, C, B);
+
+        /* the pointer stored at the end of the loop gets
+         * to the PHI and to the loads only in the next iteration
+         *
+         *   A -> B -> C -> D -> PHI -> S1 -> L1 -> L2 -> CAST -> S2
+         *                        ^                               |
+         *                        +-------------------------------+
+         */
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(D);
+        D->addSuccessor(PHI);
+        PHI->addSuccessor(S1);
+        S1->addSuccessor(L1);
+        L1->addSuccessor(L2);
+        L2->addSuccessor(CAST);
+        CAST->addSuccessor(S2);
+        S2->addSuccessor(PHI);
+
+        PS.setRoot(A);
+        PTStoT PA(&PS);
+        PA.run();
+
+        check(L1->doesPointsTo(C), "L1 does not point to C");
+        check(PHI->doesPointsTo(A), "PHI does not point to A");
+        check(PHI->doesPointsTo(C), "PHI does not point to C");
+        check(L2->doesPointsTo(A), "L2 does not point to A");
+        check(L2->doesPointsTo(C), "L2 does not point to C");
+        check(CAST->doesPointsTo(C), "CAST does not point to C");
+        check(CAST->pointsTo.size() == L1->pointsTo.size(),
+              "CAST and L1 differ");
+    }
+
+    // build a loop with a store at its end and
+    // a long sequence of nodes before the loop
+    PSNode *buildLoopAfterSequence(PointerSubgraph& PS)
+    {
+        using namespace analysis;
+
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *last = B;
+        A->addSuccessor(B);
+        for (int i = 0; i < 20; ++i) {
+            PSNode *C = PS.create(PSNodeType::CAST, A);
+            last->addSuccessor(C);
+            last = C;
+        }
+
+        PSNode *L = PS.create(PSNodeType::LOAD, B);
+        PSNode *PHI = PS.create(PSNodeType::PHI, A, L, nullptr);
+        PSNode *G = PS.create(PSNodeType::GEP, PHI, 4);
+        PSNode *S = PS.create(PSNodeType::STORE, G, B);
+
+        last->addSuccessor(PHI);
+        PHI->addSuccessor(G);
+        G->addSuccessor(S);
+        S->addSuccessor(L);
+        L->addSuccessor(PHI);
+
+        PS.setRoot(A);
+        return PHI;
+    }
+
+    void worklist_fixpoint()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS1;
+        PSNode *PHI1 = buildLoopAfterSequence(PS1);
+        PTStoT PA1(&PS1, PointerAnalysisOptions().setWorklistFixpoint(false));
+        PA1.run();
+
+        PointerSubgraph PS2;
+        PSNode *PHI2 = buildLoopAfterSequence(PS2);
+        PTStoT PA2(&PS2, PointerAnalysisOptions().setWorklistFixpoint(true));
+        PA2.run();
+
+        // the graphs are the same, so are the IDs
+        check(PHI1->pointsTo.size() == PHI2->pointsTo.size(),
+              "The fixpoints differ");
+        for (const auto& ptr : PHI1->pointsTo) {
+            check(PHI2->doesPointsTo(PS2.getNodes()[ptr.target->getID()].get(),
+                                     ptr.offset),
+                  "The fixpoints differ");
+        }
+
+        // the nodes before the loop are processed only once
+        check(PA2.getStatistics().processedNodes
+                < PA1.getStatistics().processedNodes,
+              "Worklist processed more nodes than BFS");
+        check(PA1.getStatistics().iterations > 1, "BFS did not iterate");
+        check(PA2.getStatistics().iterations > 1, "Worklist did not iterate");
+    }
+
+    void copy_cycle(bool collapse)
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *P1 = PS.create(PSNodeType::PHI, A, nullptr);
+        PSNode *C1 = PS.create(PSNodeType::CAST, P1);
+        PSNode *P2 = PS.create(PSNodeType::PHI, C1, B, nullptr);
+        PSNode *C2 = PS.create(PSNodeType::CAST, P2);
+        PSNode *X = PS.create(PSNodeType::CAST, C1);
+        P1->addOperand(C2);
+        // a phi in a loop may copy itself
+        P1->addOperand(P1);
+
+        /* P1 -> C1 -> P2 -> C2 -> P1 is a cycle of copies,
+         * A and B come from outside of the cycle
+         *
+         *   A -> B -> P1 -> C1 -> P2 -> C2 -> X
+         *              ^                |
+         *              +----------------+
+         */
+        A->addSuccessor(B);
+        B->addSuccessor(P1);
+        P1->addSuccessor(C1);
+        C1->addSuccessor(P2);
+        P2->addSuccessor(C2);
+        C2->addSuccessor(P1);
+        C2->addSuccessor(X);
+
+        PS.setRoot(A);
+        PTStoT PA(&PS, PointerAnalysisOptions().setWorklistFixpoint(true)
+                                               .setCollapseCycles(collapse));
+        PA.run();
+
+        for (PSNode *n : {P1, C1, P2, C2, X}) {
+            check(n->doesPointsTo(A), "Node does not point to A");
+            check(n->doesPointsTo(B), "Node does not point to B");
+            check(n->pointsTo.size() == 2, "Node points to more pointers");
+        }
+
+        if (collapse) {
+            check(PA.getStatistics().collapsedNodes == 4,
+                  "Did not collapse the cycle");
+        } else {
+            check(PA.getStatistics().collapsedNodes == 0,
+                  "Collapsed a cycle");
+        }
+    }
+
+    // connects the called function to the callsite
+    // like the LLVM PointerSubgraph builder does
+    class FuncPtrPTA : public PTStoT
+    {
+    public:
+        // the entry and the return node (or nullptr) of a function
+        std::map<PSNode *, std::pair<PSNode *, PSNode *>> functions;
+        // the number of calls of functionPointerCalls()
+        unsigned batches{0};
+
+        FuncPtrPTA(PointerSubgraph *PS,
+                   const analysis::PointerAnalysisOptions& opts = {})
+        : PTStoT(PS, opts) {}
+
+        bool functionPointerCalls(PSNode *callsite,
+                                  const std::vector<PSNode *>& called) override
+        {
+            ++batches;
+            return PTStoT::functionPointerCalls(callsite, called);
+        }
+
+        bool functionPointerCall(PSNode *callsite, PSNode *called) override
+        {
+            // the function is only declared, it may return anything
+            auto it = functions.find(called);
+            if (it == functions.end()) {
+                callsite->getPairedNode()->addPointsTo(UnknownPointer);
+                return false;
+            }
+
+            auto& F = it->second;
+            PointerSubgraph *PS = this->getPS();
+            PSNode *CN = PS->create(PSNodeType::CALL, nullptr);
+            CN->addSuccessor(F.first);
+
+            PSNode *ret = callsite->getPairedNode();
+            if (F.second) {
+                PSNode *CR = PS->create(PSNodeType::CALL_RETURN,
+                                        F.second, nullptr);
+                CN->setPairedNode(CR);
+                CR->setPairedNode(CN);
+                F.second->addSuccessor(CR);
+                CR->addSuccessor(ret);
+            }
+
+            if (callsite->successorsNum() == 1 &&
+                callsite->getSingleSuccessor() == ret)
+                callsite->replaceSingleSuccessor(CN);
+            else
+                callsite->addSuccessor(CN);
+            return true;
+        }
+
+        // the groups of nodes are different components
+        // and the components are in the topological order
+        bool checkSCCs(const std::vector<std::vector<PSNode *>>& groups)
+        {
+            for (size_t i = 0; i < groups.size(); ++i) {
+                for (PSNode *n : groups[i]) {
+                    if (n->getSCCId() != groups[i][0]->getSCCId())
+                        return false;
+                    for (size_t j = 0; j < i; ++j) {
+                        if (n->getSCCId() == groups[j][0]->getSCCId())
+                            return false;
+                    }
+                }
+            }
+
+            for (const auto& nd : this->getPS()->getNodes()) {
+                if (!nd)
+                    continue;
+                for (PSNode *succ : nd->getSuccessors()) {
+                    if (succ->getSCCId() != nd->getSCCId() &&
+                        this->getPriority(nd.get()) >= this->getPriority(succ))
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        size_t getSCCSize(const PSNode *n) const {
+            return this->getSCCs()[n->getSCCId()].size();
+        }
+    };
+
+    void function_pointer_call()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *G = PS.create(PSNodeType::FUNCTION);
+        PSNode *H = PS.create(PSNodeType::FUNCTION);
+        PSNode *F = PS.create(PSNodeType::FUNCTION);
+        PSNode *FP = PS.create(PSNodeType::PHI, G, H, nullptr);
+        PSNode *C1 = PS.create(PSNodeType::CALL_FUNCPTR, FP);
+        PSNode *R1 = PS.create(PSNodeType::CALL_RETURN, nullptr);
+        PSNode *X = PS.create(PSNodeType::CAST, A);
+        PSNode *LF = PS.create(PSNodeType::CAST, F);
+        PSNode *FG = PS.create(PSNodeType::GEP, LF, 4);
+        C1->setPairedNode(R1);
+        R1->setPairedNode(C1);
+        FP->addOperand(LF);
+        FP->addOperand(FG);
+
+        /* G and H are called first, F is called later
+         * (the pointers to it are created in the loop),
+         * first with the offset 0, then with an unknown offset.
+         * G returns, F has a loop and returns,
+         * H has a loop and does not return
+         *
+         *   A -> G -> H -> F -> FP -> C1 -> R1 -> X -> LF -> FG
+         *                         ^                       |
+         *                         +-----------------------+
+         */
+        A->addSuccessor(G);
+        G->addSuccessor(H);
+        H->addSuccessor(F);
+        F->addSuccessor(FP);
+        FP->addSuccessor(C1);
+        C1->addSuccessor(R1);
+        R1->addSuccessor(X);
+        X->addSuccessor(LF);
+        LF->addSuccessor(FG);
+        FG->addSuccessor(C1);
+
+        PSNode *GE = PS.create(PSNodeType::ENTRY);
+        PSNode *GR = PS.create(PSNodeType::RETURN, nullptr);
+        GE->addSuccessor(GR);
+
+        PSNode *HE = PS.create(PSNodeType::ENTRY);
+        PSNode *HL1 = PS.create(PSNodeType::CAST, A);
+        PSNode *HL2 = PS.create(PSNodeType::CAST, HL1);
+        HE->addSuccessor(HL1);
+        HL1->addSuccessor(HL2);
+        HL2->addSuccessor(HL1);
+
+        PSNode *FE = PS.create(PSNodeType::ENTRY);
+        PSNode *FL = PS.create(PSNodeType::CAST, A);
+        PSNode *FR = PS.create(PSNodeType::RETURN, FL, nullptr);
+        FE->addSuccessor(FL);
+        FL->addSuccessor(FL);
+        FL->addSuccessor(FR);
+
+        PS.setRoot(A);
+        FuncPtrPTA PA(&PS);
+        PA.functions[G] = {GE, GR};
+        PA.functions[H] = {HE, nullptr};
+        PA.functions[F] = {FE, FR};
+        PA.run();
+
+        // G and H are connected at once, F only once
+        // although the callsite points to it with two offsets
+        check(PA.batches == 2, "Did not connect the functions at once");
+        check(C1->successorsNum() == 3, "Wrong number of called functions");
+
+        // the callsite is in a loop with the bodies of G and F
+        // (and the new call and call-return nodes),
+        // the loop in H is a component of its own
+        check(PA.checkSCCs({{C1, R1, X, LF, FG, GE, GR, FE, FL, FR},
+                            {HL1, HL2}, {HE}, {FP}}),
+              "Wrong SCCs after a call via function pointer");
+        check(PA.getSCCSize(C1) == 14, "Wrong size of the loop with F");
+        check(PA.getSCCSize(HL1) == 2, "Wrong size of the loop in H");
+    }
+
+    void undefined_function_call(bool worklist)
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *U = PS.create(PSNodeType::FUNCTION);
+        PSNode *R = PS.create(PSNodeType::CALL_RETURN, nullptr);
+        PSNode *X = PS.create(PSNodeType::CAST, R);
+        PSNode *FP = PS.create(PSNodeType::PHI, nullptr);
+        PSNode *C = PS.create(PSNodeType::CALL_FUNCPTR, FP);
+        PSNode *L = PS.create(PSNodeType::CAST, U);
+        FP->addOperand(L);
+        C->setPairedNode(R);
+        R->setPairedNode(C);
+
+        /* U is only declared, so calling it changes the points-to
+         * set of R while C is processed. The pointer to U gets
+         * to C through the loop, so C calls U when all nodes
+         * in the loop have already been processed
+         *
+         *   U -> X -> FP -> C -> R -> L
+         *        ^                    |
+         *        +--------------------+
+         */
+        U->addSuccessor(X);
+        X->addSuccessor(FP);
+        FP->addSuccessor(C);
+        C->addSuccessor(R);
+        R->addSuccessor(L);
+        L->addSuccessor(X);
+
+        PS.setRoot(U);
+        FuncPtrPTA PA(&PS, PointerAnalysisOptions().setWorklistFixpoint(worklist));
+        PA.run();
+
+        check(R->doesPointsTo(UnknownPointer), "R does not point to unknown");
+        check(X->doesPointsTo(UnknownPointer), "X does not point to unknown");
+    }
+
+    // the tests of the results that do not depend
+    // on the way how the analysis computes them
+    void test_results()
     {
         store_load();
         store_load2();
@@ -935,6 +1309,18 @@ public:
         memcpy_test6();
         memcpy_test7();
         memcpy_test8();
+        loop_propagation();
+    }
+
+    void test()
+    {
+        test_results();
+        worklist_fixpoint();
+        copy_cycle(true);
+        copy_cycle(false);
+        function_pointer_call();
+        undefined_function_call(false);
+        undefined_function_call(true);
     }
 };
 
@@ -954,6 +1340,567 @@ public:
     FlowSensitivePointsToTest()
         : PointsToTest<analysis::pta::PointerAnalysisFS>
           ("flow-sensitive points-to test") {}
+
+    void shared_objects()
+    {
+        using namespace analysis;
+        using MemoryMapT = PointerAnalysisFS::MemoryMapT;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *C = PS.create(PSNodeType::ALLOC);
+        PSNode *S1 = PS.create(PSNodeType::STORE, A, B);
+        PSNode *S2 = PS.create(PSNodeType::STORE, B, C);
+        PSNode *S3 = PS.create(PSNodeType::STORE, A, C);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, B);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, C);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S1->addSuccessor(S3);
+        S2->addSuccessor(L1);
+        S3->addSuccessor(L1);
+        L1->addSuccessor(L2);
+
+        PS.setRoot(A);
+        // the worklist processes the maps in the topological order,
+        // so every map merges its predecessors only once
+        PointerAnalysisFS PA(&PS,
+                             PointerAnalysisOptions().setWorklistFixpoint(true));
+        PA.run();
+
+        check(L1->doesPointsTo(A), "L1 does not point to A");
+        check(L2->doesPointsTo(A), "L2 does not point to A");
+        check(L2->doesPointsTo(B), "L2 does not point to B");
+
+        // the branches do not write to B, the memory map
+        // after the branches shares the object with the map before them
+        MemoryMapT *mm1 = S1->getData<MemoryMapT>();
+        MemoryMapT *mm2 = L1->getData<MemoryMapT>();
+        check(mm1 != mm2, "The branches do not have own memory map");
+        check(mm1->find(B)->second == mm2->find(B)->second,
+              "The object is not shared");
+        check(S2->getData<MemoryMapT>()->find(C)->second !=
+              S3->getData<MemoryMapT>()->find(C)->second,
+              "The written objects are shared");
+    }
+
+    void changed_objects()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+
+        MemoryMap from, to;
+        from.getWritable(A)->addPointsTo(0, Pointer(B, 0));
+        from.setChanged(A);
+
+        // the first merge goes over all the objects
+        check(from.getChanges(&to, false) == nullptr,
+              "The first merge does not merge everything");
+
+        from.getWritable(B)->addPointsTo(0, Pointer(A, 0));
+        from.setChanged(B);
+
+        auto *changes = from.getChanges(&to, false);
+        check(changes && changes->size() == 1 && *changes->begin() == B,
+              "Did not get only the changed object");
+        changes->clear();
+
+        changes = from.getChanges(&to, true);
+        check(changes && changes->empty(), "Got unchanged objects");
+
+        // the previous merge skipped overwritten pointers,
+        // they must be merged now
+        check(from.getChanges(&to, false) == nullptr,
+              "Weak update does not merge everything");
+    }
+
+    void test()
+    {
+        test_results();
+        shared_objects();
+        changed_objects();
+        function_pointer_call();
+        undefined_function_call(false);
+        undefined_function_call(true);
+    }
+};
+
+class SparseFlowSensitivePointsToTest
+    : public PointsToTest<analysis::pta::PointerAnalysisFSSparse>
+{
+public:
+    SparseFlowSensitivePointsToTest()
+        : PointsToTest<analysis::pta::PointerAnalysisFSSparse>
+          ("sparse flow-sensitive points-to test") {}
+
+    void strong_update()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *C = PS.create(PSNodeType::ALLOC);
+        PSNode *S1 = PS.create(PSNodeType::STORE, A, B);
+        PSNode *S2 = PS.create(PSNodeType::STORE, C, B);
+        PSNode *L = PS.create(PSNodeType::LOAD, B);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(L);
+
+        PS.setRoot(A);
+        PointerAnalysisFSSparse PA(&PS);
+        PA.run();
+
+        check(L->doesPointsTo(C), "L does not point to C");
+        check(!L->doesPointsTo(A), "The store to B was not a strong update");
+        check(PA.getSlotsNum() == 3, "Wrong number of slots");
+    }
+
+    // build a graph with branches and loops, with the same seed
+    // the nodes are created in the same order (and have the same IDs).
+    // The stores write to the allocations, so whether a store
+    // is a strong update does not depend on the order of processing
+    // and both analyses must compute the same results.
+    void buildRandomCFG(PointerSubgraph& PS, unsigned seed)
+    {
+        using namespace analysis;
+
+        auto rand = [&seed](unsigned n) {
+            seed = seed * 1103515245 + 12345;
+            return (seed >> 16) % n;
+        };
+
+        std::vector<PSNode *> pointers;
+        std::vector<PSNode *> cfg;
+        PSNode *root = PS.create(PSNodeType::ALLOC);
+        PSNode *last = root;
+        pointers.push_back(root);
+        for (int i = 0; i < 20; ++i) {
+            PSNode *A = PS.create(PSNodeType::ALLOC);
+            A->setSize(16);
+            last->addSuccessor(A);
+            last = A;
+            pointers.push_back(A);
+        }
+
+        for (int i = 0; i < 500; ++i) {
+            PSNode *p = pointers[rand(pointers.size())];
+            PSNode *q = pointers[rand(pointers.size())];
+            PSNode *n = nullptr;
+            switch (rand(5)) {
+                case 0: n = PS.create(PSNodeType::CAST, p); break;
+                case 1: n = PS.create(PSNodeType::GEP, p, rand(3) * 4); break;
+                case 2: n = PS.create(PSNodeType::LOAD, p); break;
+                case 3: n = PS.create(PSNodeType::STORE, p,
+                                      pointers[1 + rand(20)]); break;
+                case 4: n = PS.create(PSNodeType::PHI, p, q, nullptr); break;
+            }
+
+            last->addSuccessor(n);
+            if (!cfg.empty()) {
+                PSNode *other = cfg[rand(cfg.size())];
+                switch (rand(10)) {
+                    // a branch that joins here
+                    case 0: if (other != last) other->addSuccessor(n); break;
+                    // a loop
+                    case 1: n->addSuccessor(other); break;
+                }
+            }
+
+            last = n;
+            cfg.push_back(n);
+            if (n->getType() != PSNodeType::STORE)
+                pointers.push_back(n);
+        }
+
+        PS.setRoot(root);
+    }
+
+    void same_as_fs()
+    {
+        using namespace analysis;
+
+        for (unsigned seed : {1, 7, 42}) {
+            PointerSubgraph PS1;
+            buildRandomCFG(PS1, seed);
+            PointerAnalysisFS PA1(&PS1);
+            PA1.run();
+
+            PointerSubgraph PS2;
+            buildRandomCFG(PS2, seed);
+            PointerAnalysisFSSparse PA2(&PS2);
+            PA2.run();
+
+            for (const auto& nd : PS1.getNodes()) {
+                if (!nd)
+                    continue;
+
+                PSNode *nd2 = PS2.getNodes()[nd->getID()].get();
+                check(nd->pointsTo.size() == nd2->pointsTo.size(),
+                      "The results differ");
+                for (const auto& ptr : nd->pointsTo) {
+                    PSNode *target = ptr.target;
+                    if (target->getID() < PS2.size() &&
+                        PS1.getNodes()[target->getID()].get() == target)
+                        target = PS2.getNodes()[target->getID()].get();
+                    check(nd2->doesPointsTo(target, ptr.offset),
+                          "The results differ");
+                }
+            }
+        }
+    }
+
+    void test()
+    {
+        test_results();
+        strong_update();
+        same_as_fs();
+    }
+};
+
+class AndersenPointsToTest
+    : public PointsToTest<analysis::pta::PointerAnalysisAndersen>
+{
+public:
+    AndersenPointsToTest()
+        : PointsToTest<analysis::pta::PointerAnalysisAndersen>
+          ("andersen points-to test") {}
+
+    void same_as_fi()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS1;
+        PSNode *PHI1 = buildLoopAfterSequence(PS1);
+        PointerAnalysisFI PA1(&PS1);
+        PA1.run();
+
+        PointerSubgraph PS2;
+        PSNode *PHI2 = buildLoopAfterSequence(PS2);
+        PointerAnalysisAndersen PA2(&PS2);
+        PA2.run();
+
+        // the graphs are the same, so are the IDs
+        for (const auto& nd : PS1.getNodes()) {
+            if (!nd)
+                continue;
+
+            PSNode *nd2 = PS2.getNodes()[nd->getID()].get();
+            check(nd->pointsTo.size() == nd2->pointsTo.size(),
+                  "The results differ");
+            for (const auto& ptr : nd->pointsTo) {
+                check(nd2->doesPointsTo(PS2.getNodes()[ptr.target->getID()].get(),
+                                        ptr.offset),
+                      "The results differ");
+            }
+        }
+
+        // the loop stores the GEP to B
+        PSNode *B = PS2.getNodes()[2].get();
+        const PointsToSetT *mem = PA2.getMemoryPointsTo(B, 0);
+        check(mem && !mem->empty(), "B does not hold any pointer");
+        check(PHI2->pointsTo.size() == PHI1->pointsTo.size(),
+              "The results differ");
+        check(PA2.getNumOfConstraints() > 0, "No constraints");
+    }
+
+    void test()
+    {
+        test_results();
+        same_as_fi();
+    }
+};
+
+class SteensgaardPointsToTest
+    : public PointsToTest<analysis::pta::PointerAnalysisSteensgaard>
+{
+public:
+    SteensgaardPointsToTest()
+        : PointsToTest<analysis::pta::PointerAnalysisSteensgaard>
+          ("steensgaard points-to test") {}
+
+    void unification()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        A->setSize(8);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *C = PS.create(PSNodeType::ALLOC);
+        PSNode *GEP = PS.create(PSNodeType::GEP, A, 4);
+        PSNode *S1 = PS.create(PSNodeType::STORE, GEP, B);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, B);
+        PSNode *S2 = PS.create(PSNodeType::STORE, C, B);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, B);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(GEP);
+        GEP->addSuccessor(S1);
+        S1->addSuccessor(L1);
+        L1->addSuccessor(S2);
+        S2->addSuccessor(L2);
+
+        PS.setRoot(A);
+        PointerAnalysisSteensgaard PA(&PS);
+        PA.run();
+
+        // A + 4 and C are stored to the same memory,
+        // so A and C are unified with unknown offset
+        check(PA.pointsToSameObjects(L1, L2), "L1 and L2 were not unified");
+        check(PA.pointsToSameObjects(GEP, C), "A and C were not unified");
+        for (PSNode *L : {L1, L2}) {
+            check(L->doesPointsTo(A, Offset::UNKNOWN), "L does not point to A");
+            check(L->doesPointsTo(C, Offset::UNKNOWN), "L does not point to C");
+            check(L->pointsTo.size() == 2, "L points to more objects");
+        }
+        check(!PA.pointsToSameObjects(L1, B), "B was unified with A");
+    }
+
+    void null_stores()
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *P1 = PS.create(PSNodeType::ALLOC);
+        PSNode *P2 = PS.create(PSNodeType::ALLOC);
+        PSNode *S1 = PS.create(PSNodeType::STORE, NULLPTR, P1);
+        PSNode *S2 = PS.create(PSNodeType::STORE, NULLPTR, P2);
+        PSNode *S3 = PS.create(PSNodeType::STORE, A, P1);
+        PSNode *S4 = PS.create(PSNodeType::STORE, B, P2);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, P1);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, P2);
+        PSNode *PHI = PS.create(PSNodeType::PHI, L1, NULLPTR, nullptr);
+
+        /* *P1 = NULL; *P2 = NULL; *P1 = &A; *P2 = &B;
+         * the null pointer does not unify the memory of P1 and P2 */
+        A->addSuccessor(B);
+        B->addSuccessor(P1);
+        P1->addSuccessor(P2);
+        P2->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(S3);
+        S3->addSuccessor(S4);
+        S4->addSuccessor(L1);
+        L1->addSuccessor(L2);
+        L2->addSuccessor(PHI);
+
+        PS.setRoot(A);
+        PointerAnalysisSteensgaard PA(&PS);
+        PA.run();
+
+        check(L1->doesPointsTo(A), "L1 does not point to A");
+        check(L1->doesPointsTo(NULLPTR), "L1 does not point to null");
+        check(L1->pointsTo.size() == 2, "L1 points to more objects");
+        check(L2->doesPointsTo(B), "L2 does not point to B");
+        check(L2->doesPointsTo(NULLPTR), "L2 does not point to null");
+        check(L2->pointsTo.size() == 2, "L2 points to more objects");
+        check(!PA.pointsToSameObjects(L1, L2), "A was unified with B");
+        check(PHI->pointsTo.size() == 2, "PHI points to more objects");
+    }
+
+    void field_sensitivity(Offset fieldSensitivity)
+    {
+        using namespace analysis;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        A->setSize(16);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *C = PS.create(PSNodeType::ALLOC);
+        PSNode *G1 = PS.create(PSNodeType::GEP, A, 4);
+        PSNode *G2 = PS.create(PSNodeType::GEP, A, 8);
+        PSNode *S1 = PS.create(PSNodeType::STORE, B, G1);
+        PSNode *S2 = PS.create(PSNodeType::STORE, C, G2);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, G1);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, G2);
+
+        A->addSuccessor(B);
+        B->addSuccessor(C);
+        C->addSuccessor(G1);
+        G1->addSuccessor(G2);
+        G2->addSuccessor(S1);
+        S1->addSuccessor(S2);
+        S2->addSuccessor(L1);
+        L1->addSuccessor(L2);
+
+        PS.setRoot(A);
+        PointerAnalysisOptions opts;
+        opts.setFieldSensitivity(fieldSensitivity);
+        PointerAnalysisSteensgaard PA(&PS, opts);
+        PA.run();
+
+        check(L1->doesPointsTo(B), "L1 does not point to B");
+        check(L2->doesPointsTo(C), "L2 does not point to C");
+        if (fieldSensitivity.isUnknown()) {
+            // the fields of A are distinguished
+            check(L1->pointsTo.size() == 1, "L1 points to more objects");
+            check(L2->pointsTo.size() == 1, "L2 points to more objects");
+            check(G1->doesPointsTo(A, 4), "G1 does not point to A + 4");
+        } else {
+            // A + 8 is not tracked, A is collapsed to one field
+            check(L1->doesPointsTo(C), "L1 does not point to C");
+            check(L2->doesPointsTo(B), "L2 does not point to B");
+            check(G1->doesPointsTo(A, Offset::UNKNOWN),
+                  "G1 does not point to A + UNKNOWN");
+        }
+    }
+
+    void test()
+    {
+        // store_load4 expects that A + 4 and C
+        // stored to the same memory are kept apart
+        store_load();
+        store_load2();
+        store_load3();
+        store_load5();
+        gep1();
+        gep2();
+        gep3();
+        gep4();
+        gep5();
+        nulltest();
+        constant_store();
+        load_from_zeroed();
+        load_from_unknown_offset();
+        load_from_unknown_offset2();
+        load_from_unknown_offset3();
+        memcpy_test();
+        memcpy_test2();
+        memcpy_test3();
+        memcpy_test4();
+        memcpy_test5();
+        memcpy_test6();
+        memcpy_test7();
+        memcpy_test8();
+        loop_propagation();
+        unification();
+        null_stores();
+        field_sensitivity(Offset::UNKNOWN);
+        field_sensitivity(8);
+    }
+};
+
+// the parallel solver with more than one thread
+class PointerAnalysisFI4Threads : public PointerAnalysisFIParallel
+{
+public:
+    PointerAnalysisFI4Threads(PointerSubgraph *ps,
+                              analysis::PointerAnalysisOptions opts = {})
+    : PointerAnalysisFIParallel(ps, opts.setSolverThreads(4)) {}
+};
+
+class ParallelPointsToTest
+    : public PointsToTest<PointerAnalysisFI4Threads>
+{
+public:
+    ParallelPointsToTest()
+        : PointsToTest<PointerAnalysisFI4Threads>
+          ("parallel flow-insensitive points-to test") {}
+
+    // build a graph with many loads and stores, with the same seed
+    // the nodes are created in the same order (and have the same IDs).
+    // Larger graphs are solved by tests/pta-benchmark.cpp
+    void buildRandomGraph(PointerSubgraph& PS, unsigned seed, int size)
+    {
+        using namespace analysis;
+
+        auto rand = [&seed](unsigned n) {
+            seed = seed * 1103515245 + 12345;
+            return (seed >> 16) % n;
+        };
+
+        std::vector<PSNode *> pointers;
+        PSNode *root = PS.create(PSNodeType::ALLOC);
+        PSNode *last = root;
+        pointers.push_back(root);
+        for (int i = 0; i < 50; ++i) {
+            PSNode *A = PS.create(PSNodeType::ALLOC);
+            A->setSize(16);
+            last->addSuccessor(A);
+            last = A;
+            pointers.push_back(A);
+        }
+
+        for (int i = 0; i < size; ++i) {
+            PSNode *p = pointers[rand(pointers.size())];
+            PSNode *q = pointers[rand(pointers.size())];
+            PSNode *n = nullptr;
+            switch (rand(5)) {
+                case 0: n = PS.create(PSNodeType::CAST, p); break;
+                case 1: n = PS.create(PSNodeType::GEP, p, rand(3) * 4); break;
+                case 2: n = PS.create(PSNodeType::LOAD, p); break;
+                case 3: n = PS.create(PSNodeType::STORE, p, q); break;
+                case 4: n = PS.create(PSNodeType::PHI, p, q, nullptr); break;
+            }
+
+            last->addSuccessor(n);
+            last = n;
+            if (n->getType() != PSNodeType::STORE)
+                pointers.push_back(n);
+        }
+
+        PS.setRoot(root);
+    }
+
+    void same_as_fi()
+    {
+        using namespace analysis;
+
+        for (unsigned seed : {1, 7, 42}) {
+            PointerSubgraph PS1;
+            buildRandomGraph(PS1, seed, 300);
+            // the iterations of the sequential solver may stop before
+            // the fixpoint (see PointerAnalysis::run()),
+            // the worklist does not
+            PointerAnalysisOptions opts;
+            opts.setWorklistFixpoint(true);
+            PointerAnalysisFI PA1(&PS1, opts);
+            PA1.run();
+
+            PointerSubgraph PS2;
+            buildRandomGraph(PS2, seed, 300);
+            PointerAnalysisFI4Threads PA2(&PS2);
+            PA2.run();
+
+            for (const auto& nd : PS1.getNodes()) {
+                if (!nd)
+                    continue;
+
+                PSNode *nd2 = PS2.getNodes()[nd->getID()].get();
+                check(nd->pointsTo.size() == nd2->pointsTo.size(),
+                      "The results differ");
+                for (const auto& ptr : nd->pointsTo) {
+                    PSNode *target = ptr.target;
+                    if (target->getID() < PS2.size() &&
+                        PS1.getNodes()[target->getID()].get() == target)
+                        target = PS2.getNodes()[target->getID()].get();
+                    check(nd2->doesPointsTo(target, ptr.offset),
+                          "The results differ");
+                }
+            }
+        }
+    }
+
+    void test()
+    {
+        test_results();
+        same_as_fi();
+    }
 };
 
 class PSNodeTest : public Test
@@ -979,9 +1926,108 @@ public:
         check(N2->addPointsTo(N1, 3) == false);
     }
 
+    void points_to_version()
+    {
+        using namespace dg::analysis::pta;
+        PointerSubgraph PS;
+        PSNode *N1 = PS.create(PSNodeType::ALLOC);
+        PSNode *N2 = PS.create(PSNodeType::LOAD, N1);
+
+        unsigned version = N2->pointsToVersion;
+        N2->addPointsTo(N1, 1);
+        check(N2->pointsToVersion > version);
+
+        // adding a pointer that is already there
+        // does not change the version
+        version = N2->pointsToVersion;
+        N2->addPointsTo(N1, 1);
+        check(N2->pointsToVersion == version);
+    }
+
     void test()
     {
         unknown_offset1();
+        points_to_version();
+    }
+};
+
+class PSValueNumberingTest : public Test
+{
+
+public:
+    PSValueNumberingTest()
+          : Test("PointerSubgraph value numbering test") {}
+
+    void value_numbering(bool mergeLoads)
+    {
+        using namespace dg::analysis;
+        using namespace dg::analysis::pta;
+
+        PointerSubgraph PS;
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        PSNode *B = PS.create(PSNodeType::ALLOC);
+        PSNode *G1 = PS.create(PSNodeType::GEP, A, 4);
+        PSNode *G2 = PS.create(PSNodeType::GEP, A, 4);
+        PSNode *G3 = PS.create(PSNodeType::GEP, A, 8);
+        PSNode *S = PS.create(PSNodeType::STORE, G2, B);
+        PSNode *L1 = PS.create(PSNodeType::LOAD, B);
+        PSNode *L2 = PS.create(PSNodeType::LOAD, B);
+        PSNode *G4 = PS.create(PSNodeType::GEP, L1, 2);
+        PSNode *G5 = PS.create(PSNodeType::GEP, L2, 2);
+        PSNode *C1 = PS.create(PSNodeType::CAST, G3);
+        PSNode *C2 = PS.create(PSNodeType::CAST, G3);
+        A->setSize(16);
+
+        A->addSuccessor(B);
+        B->addSuccessor(G1);
+        G1->addSuccessor(G2);
+        G2->addSuccessor(G3);
+        G3->addSuccessor(S);
+        S->addSuccessor(L1);
+        L1->addSuccessor(L2);
+        L2->addSuccessor(G4);
+        G4->addSuccessor(G5);
+        G5->addSuccessor(C1);
+        C1->addSuccessor(C2);
+        PS.setRoot(A);
+
+        PSValueNumberingMerger merger(&PS, mergeLoads);
+        unsigned merged = merger.run();
+        const auto& mapping = merger.getMapping();
+
+        // G2 is the same as G1, and if loads are merged,
+        // then G5 is the same as G4 (once L2 is merged to L1)
+        check(mapping.get(G2) == G1);
+        check(mapping.get(G3) == nullptr);
+        check(mapping.get(C2) == C1);
+        if (mergeLoads) {
+            check(merged == 4);
+            check(mapping.get(L2) == L1);
+            check(mapping.get(G5) == G4);
+        } else {
+            check(merged == 2);
+            check(mapping.get(L2) == nullptr);
+            check(mapping.get(G5) == nullptr);
+        }
+
+        // the merged nodes were removed from the graph,
+        // but the analysis still computes the right results
+        check(S->getOperand(0) == G1);
+        PointerAnalysisFI PA(&PS);
+        PA.run();
+
+        check(S->getOperand(0)->doesPointsTo(A, 4));
+        check(G4->doesPointsTo(A, 6));
+        check(G3->doesPointsTo(A, 8));
+        check(C1->doesPointsTo(A, 8));
+        if (!mergeLoads)
+            check(G5->doesPointsTo(A, 6));
+    }
+
+    void test()
+    {
+        value_numbering(false);
+        value_numbering(true);
     }
 };
 
@@ -995,7 +2041,12 @@ int main(void)
 
     Runner.add(new FlowInsensitivePointsToTest());
     Runner.add(new FlowSensitivePointsToTest());
+    Runner.add(new SparseFlowSensitivePointsToTest());
+    Runner.add(new AndersenPointsToTest());
+    Runner.add(new SteensgaardPointsToTest());
+    Runner.add(new ParallelPointsToTest());
     Runner.add(new PSNodeTest());
+    Runner.add(new PSValueNumberingTest());
 
     return Runner();
 }
@@ -0,0 +1,115 @@
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+
+#include "dg/analysis/PointsTo/PointerSubgraph.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFIParallel.h"
+#include "../tools/TimeMeasure.h"
+
+using namespace dg::analysis::pta;
+using dg::analysis::PointerAnalysisOptions;
+
+// build a graph with many loads and stores (the same as in the parallel
+// flow-insensitive test of points-to-test, but larger), with the same
+// seed the nodes are created in the same order (and have the same IDs)
+static void buildRandomGraph(PointerSubgraph& PS, unsigned seed, int size)
+{
+    auto rand = [&seed](unsigned n) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) % n;
+    };
+
+    std::vector<PSNode *> pointers;
+    PSNode *root = PS.create(PSNodeType::ALLOC);
+    PSNode *last = root;
+    pointers.push_back(root);
+    for (int i = 0; i < 50; ++i) {
+        PSNode *A = PS.create(PSNodeType::ALLOC);
+        A->setSize(16);
+        last->addSuccessor(A);
+        last = A;
+        pointers.push_back(A);
+    }
+
+    for (int i = 0; i < size; ++i) {
+        PSNode *p = pointers[rand(pointers.size())];
+        PSNode *q = pointers[rand(pointers.size())];
+        PSNode *n = nullptr;
+        switch (rand(5)) {
+            case 0: n = PS.create(PSNodeType::CAST, p); break;
+            case 1: n = PS.create(PSNodeType::GEP, p, rand(3) * 4); break;
+            case 2: n = PS.create(PSNodeType::LOAD, p); break;
+            case 3: n = PS.create(PSNodeType::STORE, p, q); break;
+            case 4: n = PS.create(PSNodeType::PHI, p, q, nullptr); break;
+        }
+
+        last->addSuccessor(n);
+        last = n;
+        if (n->getType() != PSNodeType::STORE)
+            pointers.push_back(n);
+    }
+
+    PS.setRoot(root);
+}
+
+// run the analysis on the graph built from the seed,
+// returns the sizes of the points-to sets of the nodes
+template <typename PTA>
+std::vector<size_t> runAnalysis(unsigned seed, int size,
+                                PointerAnalysisOptions opts,
+                                const char *msg)
+{
+    PointerSubgraph PS;
+    buildRandomGraph(PS, seed, size);
+    PTA PA(&PS, opts);
+
+    dg::debug::TimeMeasure tm;
+    tm.start();
+    PA.run();
+    tm.stop();
+
+    std::cout << " -- " << msg << ": processed "
+              << PA.getStatistics().processedNodes << " nodes,";
+    tm.report("", std::cout);
+
+    std::vector<size_t> sizes;
+    for (const auto& nd : PS.getNodes()) {
+        if (nd)
+            sizes.push_back(nd->pointsTo.size());
+    }
+
+    return sizes;
+}
+
+int main(int argc, char *argv[])
+{
+    int size = argc > 1 ? std::atoi(argv[1]) : 2000;
+    bool differ = false;
+
+    for (unsigned seed : {1, 7, 42}) {
+        std::cout << "Running flow-insensitive analysis of a graph with "
+                  << size << " random nodes (seed " << seed << ")\n";
+
+        PointerAnalysisOptions opts;
+        runAnalysis<PointerAnalysisFI>(seed, size, opts, "iterations");
+
+        opts.setWorklistFixpoint(true);
+        auto worklist = runAnalysis<PointerAnalysisFI>(seed, size, opts,
+                                                       "worklist");
+
+        opts.setWorklistFixpoint(false).setSolverThreads(4);
+        auto parallel = runAnalysis<PointerAnalysisFIParallel>(seed, size, opts,
+                                                               "4 threads");
+
+        // the iterations may stop before the fixpoint
+        // (see PointerAnalysis::run()), the other solvers do not
+        if (worklist != parallel) {
+            std::cerr << "The results of the worklist and "
+                      << "the parallel solver differ" << std::endl;
+            differ = true;
+        }
+    }
+
+    return differ ? 1 : 0;
+}
@@ -1,6 +1,8 @@
 #include <vector>
 #include <string>
 #include <random>
+#include <iostream>
+#include <cstdlib>
 
 #include "dg/analysis/PointsTo/PointsToSet.h"
 #include "../tools/TimeMeasure.h"
@@ -82,10 +84,91 @@ void test5() {
 
     PTSetT S;
     for (int i = 0; i < 1000; ++i) {
-        S.add(reinterpret_cast<PSNode *>(i), i);
+        S.add(reinterpret_cast<PSNode *>(i + 1), i);
     }
 }
 
+///
+// Build 'setsNum' sets of pointers to ranges of 'targets' targets
+// (every set holds a half of the targets, at two offsets)
+// and then repeatedly unite them into one set. This is what happens
+// on PHI nodes and loads with many heap objects.
+// Returns the time of building the sets and the time of the unions.
+template <typename PTSetT>
+std::pair<double, double> measureUnions(size_t targets, size_t setsNum) {
+    dg::debug::TimeMeasure tm;
+    std::vector<PTSetT> sets(setsNum);
+
+    tm.start();
+    for (size_t i = 0; i < setsNum; ++i) {
+        size_t first = i * targets / (2 * setsNum);
+        for (size_t t = first; t < first + targets / 2; ++t) {
+            sets[i].add(reinterpret_cast<PSNode *>(t + 1), 0);
+            sets[i].add(reinterpret_cast<PSNode *>(t + 1), 8);
+        }
+    }
+    tm.stop();
+    double build = std::chrono::duration<double, std::milli>(tm.duration()).count();
+
+    tm.start();
+    for (int n = 0; n < 10; ++n) {
+        PTSetT S;
+        for (const auto& s : sets)
+            S.add(s);
+        // checked also in the release builds that do not have asserts
+        size_t expected = 2 * (targets / 2 + (setsNum - 1) * targets / (2 * setsNum));
+        if (S.size() != expected) {
+            std::cerr << "Wrong size of the union: " << S.size()
+                      << ", expected " << expected << std::endl;
+            std::exit(1);
+        }
+    }
+    tm.stop();
+    double unions = std::chrono::duration<double, std::milli>(tm.duration()).count();
+
+    return {build, unions};
+}
+
+// find the number of targets from which the BDD-based
+// set is faster than the bitvector-based sets
+void bddCrossover() {
+    std::cout << "Running unions of ranges of pointers (64 sets)" << std::endl;
+    size_t crossoverUnions = 0, crossoverTotal = 0;
+    for (size_t targets = 256; targets <= (1 << 14); targets *= 2) {
+        auto bv = measureUnions<PointerIdPointsToSet>(targets, 64);
+        auto offs = measureUnions<PointsToSetT>(targets, 64);
+        auto bdd = measureUnions<BddPointsToSet>(targets, 64);
+        std::cout << " -- " << targets << " targets (build + 10x unions): "
+                  << "pointer-id bitvector " << bv.first << " + " << bv.second
+                  << " ms, offsets bitvector " << offs.first << " + " << offs.second
+                  << " ms, BDD " << bdd.first << " + " << bdd.second << " ms"
+                  << std::endl;
+
+        bool fasterUnions = bdd.second < bv.second && bdd.second < offs.second;
+        if (!fasterUnions)
+            crossoverUnions = 0;
+        else if (crossoverUnions == 0)
+            crossoverUnions = targets;
+
+        auto total = bdd.first + bdd.second;
+        bool fasterTotal = total < bv.first + bv.second &&
+                           total < offs.first + offs.second;
+        if (!fasterTotal)
+            crossoverTotal = 0;
+        else if (crossoverTotal == 0)
+            crossoverTotal = targets;
+    }
+
+    if (crossoverUnions)
+        std::cout << " -- BDD unions are faster from " << crossoverUnions << " targets\n";
+    else
+        std::cout << " -- BDD unions are not faster on any tested number of targets\n";
+    if (crossoverTotal)
+        std::cout << " -- BDD is faster in total from " << crossoverTotal << " targets\n";
+    else
+        std::cout << " -- BDD is not faster in total on any tested number of targets\n";
+    std::cout << " -- BDD nodes: " << BddPointsToSet().getBddNodesNum() << std::endl;
+}
 
 int main()
 {
@@ -104,4 +187,6 @@ int main()
 
     times = 10000;
     run(test5, "Adding 1000 different pointers");
+
+    bddCrossover();
 }
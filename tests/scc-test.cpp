@@ -0,0 +1,145 @@
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <dg/analysis/SCC.h>
+#include <set>
+
+using namespace dg::analysis;
+
+struct Node {
+    // the fields used by the SCC computation
+    unsigned dfs_id{0};
+    unsigned scc_id{0};
+    bool on_stack{false};
+
+    std::vector<Node *> successors;
+    const std::vector<Node *>& getSuccessors() const { return successors; }
+    void addSuccessor(Node *s) { successors.push_back(s); }
+    unsigned getSCCId() const { return scc_id; }
+};
+
+static std::set<Node *> toSet(SCC<Node>::SCC_component_t comp) {
+    return std::set<Node *>(comp.begin(), comp.end());
+}
+
+TEST_CASE("SCC-sequence", "SCC") {
+    Node A, B, C;
+
+    A.addSuccessor(&B);
+    B.addSuccessor(&C);
+
+    SCC<Node> scc;
+    auto& comps = scc.compute(&A);
+
+    // the components are in the reverse topological order
+    REQUIRE(comps.size() == 3);
+    REQUIRE(comps[0][0] == &C);
+    REQUIRE(comps[1][0] == &B);
+    REQUIRE(comps[2][0] == &A);
+    REQUIRE(C.getSCCId() == 0);
+    REQUIRE(A.getSCCId() == 2);
+}
+
+TEST_CASE("SCC-cycles", "SCC") {
+    Node A, B, C, D, E, F;
+
+    /* A -> B -> C -> D -> E
+     *      ^    |    ^    |
+     *      +----+    +----+
+     * and F -> F
+     */
+    A.addSuccessor(&B);
+    B.addSuccessor(&C);
+    C.addSuccessor(&B);
+    C.addSuccessor(&D);
+    D.addSuccessor(&E);
+    E.addSuccessor(&D);
+    E.addSuccessor(&F);
+    F.addSuccessor(&F);
+
+    SCC<Node> scc;
+    auto& comps = scc.compute(&A);
+
+    REQUIRE(comps.size() == 4);
+    REQUIRE(toSet(comps[0]) == std::set<Node *>{&F});
+    REQUIRE(toSet(comps[1]) == std::set<Node *>{&D, &E});
+    REQUIRE(toSet(comps[2]) == std::set<Node *>{&B, &C});
+    REQUIRE(toSet(comps[3]) == std::set<Node *>{&A});
+
+    // the first visited node of a component is the last
+    REQUIRE(comps[1][1] == &D);
+    REQUIRE(comps[2][1] == &B);
+}
+
+TEST_CASE("SCC-nested-cycles", "SCC") {
+    Node A, B, C, D;
+
+    // two cycles sharing B, D is reachable only back through C
+    A.addSuccessor(&B);
+    B.addSuccessor(&C);
+    C.addSuccessor(&B);
+    C.addSuccessor(&D);
+    D.addSuccessor(&A);
+
+    SCC<Node> scc;
+    auto& comps = scc.compute(&A);
+
+    REQUIRE(comps.size() == 1);
+    REQUIRE(comps[0].size() == 4);
+    REQUIRE(comps[0][3] == &A);
+}
+
+TEST_CASE("SCC-deep", "SCC") {
+    // the search must not be limited by the size of the stack
+    std::vector<Node> nodes(1000000);
+    for (size_t i = 0; i + 1 < nodes.size(); ++i)
+        nodes[i].addSuccessor(&nodes[i + 1]);
+    nodes.back().addSuccessor(&nodes[0]);
+
+    SCC<Node> scc;
+    auto& comps = scc.compute(&nodes[0]);
+
+    REQUIRE(comps.size() == 1);
+    REQUIRE(comps[0].size() == nodes.size());
+}
+
+TEST_CASE("SCC-recompute", "SCC") {
+    Node A, B, C;
+
+    A.addSuccessor(&B);
+    B.addSuccessor(&C);
+
+    SCC<Node> scc;
+    scc.compute(&A);
+    REQUIRE(scc.getSCC().size() == 3);
+
+    // the nodes numbered by the previous computation
+    // are not visited again
+    C.addSuccessor(&A);
+    SCC<Node> scc2(scc.getIndex());
+    auto& comps = scc2.compute(&A);
+    REQUIRE(comps.size() == 1);
+    REQUIRE(comps[0].size() == 3);
+}
+
+TEST_CASE("SCCComponents-change", "SCC") {
+    Node A, B, C, D;
+    std::vector<Node *> ab{&A, &B}, cd{&C, &D};
+
+    SCCComponents<Node> comps;
+    REQUIRE(comps.add(ab.begin(), ab.end()) == 0);
+    REQUIRE(comps.add(cd.begin(), cd.end()) == 1);
+
+    std::vector<Node *> all{&A, &B, &C, &D};
+    comps.clear(1);
+    comps.assign(0, all);
+    REQUIRE(comps.size() == 2);
+    REQUIRE(comps[1].empty());
+    REQUIRE(std::vector<Node *>(comps[0].begin(), comps[0].end()) == all);
+
+    // many changes of one component do not keep the old nodes
+    for (int i = 0; i < 100; ++i)
+        comps.assign(1, ab);
+    REQUIRE(std::vector<Node *>(comps[0].begin(), comps[0].end()) == all);
+    REQUIRE(std::vector<Node *>(comps[1].begin(), comps[1].end()) == ab);
+}
@@ -61,6 +61,7 @@ static bool dump_graph_only = false;
 static bool names_with_funs = false;
 static bool callgraph = false;
 static uint64_t dump_iteration = 0;
+static bool worklist_fixpoint = false;
 static const char *entry_func = "main";
 
 static char *display_only = nullptr;
@@ -391,7 +392,7 @@ dumpNodeEdgesToDot(PSNode *node)
 }
 
 PSNode *getNodePtr(PSNode *ptr) { return ptr; }
-PSNode *getNodePtr(const std::unique_ptr<PSNode>& ptr) { return ptr.get(); }
+PSNode *getNodePtr(const PointerSubgraph::NodesT::value_type& ptr) { return ptr.get(); }
 
 
 template <typename ContT> static void
@@ -687,6 +688,7 @@ int main(int argc, char *argv[])
     const char *module = nullptr;
     PTType type = FLOW_INSENSITIVE;
     uint64_t field_senitivity = Offset::UNKNOWN;
+    PointsToSetKind setsKind = PointsToSetKind::OFFSETS_SET;
 
     // parse options
     for (int i = 1; i < argc; ++i) {
@@ -696,6 +698,11 @@ int main(int argc, char *argv[])
                 type = FLOW_SENSITIVE;
             else if (strcmp(argv[i+1], "inv") == 0)
                 type = WITH_INVALIDATE;
+        } else if (strcmp(argv[i], "-pta-set") == 0) {
+            if (!PointsToSetT::getKindByName(argv[i + 1], setsKind)) {
+                errs() << "Unknown points-to set: " << argv[i + 1] << "\n";
+                return 1;
+            }
         } else if (strcmp(argv[i], "-pta-field-sensitive") == 0) {
             field_senitivity = static_cast<uint64_t>(atoll(argv[i + 1]));
         } else if (strcmp(argv[i], "-dot") == 0) {
@@ -706,6 +713,8 @@ int main(int argc, char *argv[])
             callgraph = true;
         } else if (strcmp(argv[i], "-ids-only") == 0) {
             ids_only = true;
+        } else if (strcmp(argv[i], "-pta-worklist") == 0) {
+            worklist_fixpoint = true;
         } else if (strcmp(argv[i], "-iteration") == 0) {
             dump_iteration = static_cast<uint64_t>(atoll(argv[i + 1]));
         } else if (strcmp(argv[i], "-graph-only") == 0) {
@@ -760,7 +769,14 @@ int main(int argc, char *argv[])
         }
     }
 
-    LLVMPointerAnalysis PTA(M, entry_func, field_senitivity, threads);
+    LLVMPointerAnalysisOptions opts;
+    opts.threads = threads;
+    opts.pointsToSetKind = setsKind;
+    opts.setFieldSensitivity(field_senitivity);
+    opts.setEntryFunction(entry_func);
+    opts.setWorklistFixpoint(worklist_fixpoint);
+
+    LLVMPointerAnalysis PTA(M, opts);
 
     tm.start();
 
@@ -806,6 +822,9 @@ int main(int argc, char *argv[])
 
     if (stats) {
         dumpStats(&PTA);
+        printf("Fixpoint iterations: %lu\n", PA->getStatistics().iterations);
+        printf("Processed nodes: %lu\n", PA->getStatistics().processedNodes);
+        printf("Nodes in collapsed cycles: %lu\n", PA->getStatistics().collapsedNodes);
         return 0;
     }
 
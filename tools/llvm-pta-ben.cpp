@@ -425,6 +425,7 @@ int main(int argc, char *argv[])
     const char *entry_func = "main";
     PTType type = FLOW_INSENSITIVE;
     uint64_t field_senitivity = Offset::UNKNOWN;
+    PointsToSetKind setsKind = PointsToSetKind::OFFSETS_SET;
 
     // parse options
     for (int i = 1; i < argc; ++i) {
@@ -434,6 +435,11 @@ int main(int argc, char *argv[])
                 type = FLOW_SENSITIVE;
             else if (strcmp(argv[i+1], "inv") == 0)
                 type = WITH_INVALIDATE;
+        } else if (strcmp(argv[i], "-pta-set") == 0) {
+            if (!PointsToSetT::getKindByName(argv[i + 1], setsKind)) {
+                errs() << "Unknown points-to set: " << argv[i + 1] << "\n";
+                return 1;
+            }
         } else if (strcmp(argv[i], "-pta-field-sensitive") == 0) {
             field_senitivity = static_cast<uint64_t>(atoll(argv[i + 1]));
         } else if (strcmp(argv[i], "-entry") == 0) {
@@ -464,7 +470,13 @@ int main(int argc, char *argv[])
 
     TimeMeasure tm;
 
-    LLVMPointerAnalysis PTA(M, entry_func, field_senitivity);
+    analysis::LLVMPointerAnalysisOptions opts;
+    opts.threads = false;
+    opts.pointsToSetKind = setsKind;
+    opts.setFieldSensitivity(field_senitivity);
+    opts.setEntryFunction(entry_func);
+
+    LLVMPointerAnalysis PTA(M, opts);
 
     tm.start();
 
@@ -39,7 +39,11 @@
 #include "dg/llvm/analysis/PointsTo/PointerAnalysis.h"
 
 #include "dg/analysis/PointsTo/PointerAnalysisFI.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFIParallel.h"
 #include "dg/analysis/PointsTo/PointerAnalysisFS.h"
+#include "dg/analysis/PointsTo/PointerAnalysisFSSparse.h"
+#include "dg/analysis/PointsTo/PointerAnalysisAndersen.h"
+#include "dg/analysis/PointsTo/PointerAnalysisSteensgaard.h"
 #include "dg/analysis/PointsTo/Pointer.h"
 
 #include "TimeMeasure.h"
@@ -51,6 +55,14 @@ using llvm::errs;
 enum PTType {
     FLOW_SENSITIVE = 1,
     FLOW_INSENSITIVE,
+    // use the constraint-based solver as the flow-insensitive analysis
+    ANDERSEN = 4,
+    // use the unification-based analysis as the flow-insensitive analysis
+    STEENSGAARD = 8,
+    // compare the flow-insensitive analysis with its parallel solver
+    PARALLEL = 16,
+    // compare the flow-sensitive analysis with its sparse solver
+    SPARSE = 32,
 };
 
 static std::string
@@ -121,17 +133,24 @@ dumpPSNode(PSNode *n)
     }
 }
 
+// the names of the compared analyses
+struct Names {
+    const char *fi{"FI"};
+    const char *fs{"FS"};
+};
+
 static bool verify_ptsets(const llvm::Value *val,
                           LLVMPointerAnalysis *fi,
-                          LLVMPointerAnalysis *fs)
+                          LLVMPointerAnalysis *fs,
+                          const Names& names)
 {
     PSNode *finode = fi->getPointsTo(val);
     PSNode *fsnode = fs->getPointsTo(val);
 
     if (!finode) {
         if (fsnode) {
-            llvm::errs() << "FI don't have points-to for: " << *val << "\n"
-                         << "but FS has:\n";
+            llvm::errs() << names.fi << " don't have points-to for: " << *val << "\n"
+                         << "but " << names.fs << " has:\n";
             dumpPSNode(fsnode);
         } else
             // if boths mapping are null we assume that
@@ -144,8 +163,8 @@ static bool verify_ptsets(const llvm::Value *val,
 
     if (!fsnode) {
         if (finode) {
-            llvm::errs() << "FS don't have points-to for: " << *val << "\n"
-                         << "but FI has:\n";
+            llvm::errs() << names.fs << " don't have points-to for: " << *val << "\n"
+                         << "but " << names.fi << " has:\n";
             dumpPSNode(finode);
         } else
             return true;
@@ -171,10 +190,11 @@ static bool verify_ptsets(const llvm::Value *val,
         }
 
         if (!found) {
-                llvm::errs() << "FS not subset of FI: " << *val << "\n";
-                llvm::errs() << "FI ";
+                llvm::errs() << names.fs << " not subset of "
+                             << names.fi << ": " << *val << "\n";
+                llvm::errs() << names.fi << " ";
                 dumpPSNode(finode);
-                llvm::errs() << "FS ";
+                llvm::errs() << names.fs << " ";
                 dumpPSNode(fsnode);
                 llvm::errs() << " ---- \n";
                 return false;
@@ -184,9 +204,62 @@ static bool verify_ptsets(const llvm::Value *val,
     return true;
 }
 
+// the points-to sets must be the same (not only a subset)
+static bool verify_same_ptsets(const llvm::Value *val,
+                               LLVMPointerAnalysis *seq,
+                               LLVMPointerAnalysis *par)
+{
+    PSNode *seqnode = seq->getPointsTo(val);
+    PSNode *parnode = par->getPointsTo(val);
+    if (!seqnode || !parnode)
+        return !seqnode && !parnode;
+
+    auto contains = [](PSNode *node, const Pointer& ptr) {
+        for (const Pointer& ptr2 : node->pointsTo) {
+            if (ptr2.target->getUserData<llvm::Value>()
+                == ptr.target->getUserData<llvm::Value>()
+                && ptr2.offset == ptr.offset)
+                return true;
+        }
+        return false;
+    };
+
+    bool same = seqnode->pointsTo.size() == parnode->pointsTo.size();
+    for (const Pointer& ptr : seqnode->pointsTo)
+        same = same && contains(parnode, ptr);
+
+    if (!same) {
+        llvm::errs() << "Parallel FI differs from FI: " << *val << "\n";
+        llvm::errs() << "FI ";
+        dumpPSNode(seqnode);
+        llvm::errs() << "Parallel FI ";
+        dumpPSNode(parnode);
+        llvm::errs() << " ---- \n";
+    }
+
+    return same;
+}
+
+static bool verify_same_ptsets(llvm::Module *M,
+                               LLVMPointerAnalysis *seq,
+                               LLVMPointerAnalysis *par)
+{
+    using namespace llvm;
+    bool ret = true;
+
+    for (Function& F : *M)
+        for (BasicBlock& B : F)
+            for (Instruction& I : B)
+                if (!verify_same_ptsets(&I, seq, par))
+                    ret = false;
+
+    return ret;
+}
+
 static bool verify_ptsets(llvm::Module *M,
                           LLVMPointerAnalysis *fi,
-                          LLVMPointerAnalysis *fs)
+                          LLVMPointerAnalysis *fs,
+                          const Names& names = Names())
 {
     using namespace llvm;
     bool ret = true;
@@ -194,7 +267,7 @@ static bool verify_ptsets(llvm::Module *M,
     for (Function& F : *M)
         for (BasicBlock& B : F)
             for (Instruction& I : B)
-                if (!verify_ptsets(&I, fi, fs))
+                if (!verify_ptsets(&I, fi, fs, names))
                     ret = false;
 
     return ret;
@@ -207,6 +280,7 @@ int main(int argc, char *argv[])
     llvm::SMDiagnostic SMD;
     const char *module = nullptr;
     unsigned type = FLOW_SENSITIVE | FLOW_INSENSITIVE;
+    unsigned threads = 1;
 
     // parse options
     for (int i = 1; i < argc; ++i) {
@@ -216,10 +290,22 @@ int main(int argc, char *argv[])
                 type = FLOW_SENSITIVE;
             else if (strcmp(argv[i+1], "fi") == 0)
                 type = FLOW_INSENSITIVE;
+            // compare the flow-sensitive analysis with andersen
+            else if (strcmp(argv[i+1], "fi-andersen") == 0)
+                type = FLOW_SENSITIVE | FLOW_INSENSITIVE | ANDERSEN;
+            else if (strcmp(argv[i+1], "steens") == 0)
+                type = FLOW_SENSITIVE | FLOW_INSENSITIVE | STEENSGAARD;
+            // compare the sparse flow-sensitive analysis with FS and FI
+            else if (strcmp(argv[i+1], "fs-sparse") == 0)
+                type = FLOW_SENSITIVE | FLOW_INSENSITIVE | SPARSE;
             else {
                 errs() << "Unknown PTA type" << argv[i + 1] << "\n";
                 abort();
             }
+        } else if (strcmp(argv[i], "-pta-threads") == 0 && i + 1 < argc) {
+            // compare the sequential and the parallel solver
+            threads = atoi(argv[++i]);
+            type = FLOW_INSENSITIVE | PARALLEL;
         /*} else if (strcmp(argv[i], "-v") == 0) {
             verbose = true;*/
         } else {
@@ -228,7 +314,7 @@ int main(int argc, char *argv[])
     }
 
     if (!module) {
-        errs() << "Usage: % llvm-pta-compare [-pta fs|fi] IR_module\n";
+        errs() << "Usage: % llvm-pta-compare [-pta fs|fi|fi-andersen|steens|fs-sparse] [-pta-threads N] IR_module\n";
         return 1;
     }
 
@@ -250,14 +336,40 @@ int main(int argc, char *argv[])
 
     LLVMPointerAnalysis *PTAfs = nullptr;
     LLVMPointerAnalysis *PTAfi = nullptr;
+    LLVMPointerAnalysis *PTApar = nullptr;
+    LLVMPointerAnalysis *PTAsparse = nullptr;
 
     if (type & FLOW_INSENSITIVE) {
         PTAfi = new LLVMPointerAnalysis(M);
 
         tm.start();
-        PTAfi->run<analysis::pta::PointerAnalysisFI>();
+        if (type & ANDERSEN) {
+            PTAfi->run<analysis::pta::PointerAnalysisAndersen>();
+            tm.stop();
+            tm.report("INFO: Points-to flow-insensitive (andersen) analysis took");
+        } else if (type & STEENSGAARD) {
+            PTAfi->run<analysis::pta::PointerAnalysisSteensgaard>();
+            tm.stop();
+            tm.report("INFO: Points-to flow-insensitive (steensgaard) analysis took");
+        } else {
+            PTAfi->run<analysis::pta::PointerAnalysisFI>();
+            tm.stop();
+            tm.report("INFO: Points-to flow-insensitive analysis took");
+        }
+    }
+
+    if (type & PARALLEL) {
+        LLVMPointerAnalysisOptions opts;
+        opts.threads = false;
+        opts.setEntryFunction("main");
+        opts.setSolverThreads(threads);
+        PTApar = new LLVMPointerAnalysis(M, opts);
+
+        tm.start();
+        PTApar->run<analysis::pta::PointerAnalysisFIParallel>();
         tm.stop();
-        tm.report("INFO: Points-to flow-insensitive analysis took");
+        tm.report("INFO: Points-to flow-insensitive analysis with "
+                  + std::to_string(threads) + " threads took");
     }
 
     if (type & FLOW_SENSITIVE) {
@@ -269,15 +381,44 @@ int main(int argc, char *argv[])
         tm.report("INFO: Points-to flow-sensitive analysis took");
     }
 
+    if (type & SPARSE) {
+        PTAsparse = new LLVMPointerAnalysis(M);
+
+        tm.start();
+        PTAsparse->run<analysis::pta::PointerAnalysisFSSparse>();
+        tm.stop();
+        tm.report("INFO: Points-to sparse flow-sensitive analysis took");
+    }
+
     int ret = 0;
-    if (type == (FLOW_SENSITIVE | FLOW_INSENSITIVE)) {
+    if (type & SPARSE) {
+        // FS is a subset of sparse FS (which can be less precise
+        // only on calls via pointers) and sparse FS is a subset of FI
+        Names names;
+        names.fi = "Sparse FS";
+        ret = !verify_ptsets(M, PTAsparse, PTAfs, names);
+        names.fi = "FI";
+        names.fs = "Sparse FS";
+        ret |= !verify_ptsets(M, PTAfi, PTAsparse, names);
+        if (ret == 0)
+            llvm::errs() << "FS is a subset of sparse FS and sparse FS "
+                            "is a subset of FI, all OK\n";
+    } else if ((type & FLOW_SENSITIVE) && (type & FLOW_INSENSITIVE)) {
         ret = !verify_ptsets(M, PTAfi, PTAfs);
         if (ret == 0)
             llvm::errs() << "FS is a subset of FI, all OK\n";
     }
 
+    if (type & PARALLEL) {
+        ret = !verify_same_ptsets(M, PTAfi, PTApar);
+        if (ret == 0)
+            llvm::errs() << "Parallel FI is the same as FI, all OK\n";
+    }
+
     delete PTAfi;
     delete PTAfs;
+    delete PTApar;
+    delete PTAsparse;
 
     return ret;
 }
@@ -157,13 +157,50 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
         llvm::cl::values(
             clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fi, "fi", "Flow-insensitive PTA (default)"),
             clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fs, "fs", "Flow-sensitive PTA"),
-            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::inv, "inv", "PTA with invalidate nodes")
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::inv, "inv", "PTA with invalidate nodes"),
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fi_andersen, "fi-andersen",
+                       "Flow-insensitive PTA solving a constraint graph"),
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::steens, "steens",
+                       "Unification-based (Steensgaard) flow-insensitive PTA"),
+            clEnumValN(LLVMPointerAnalysisOptions::AnalysisType::fs_sparse, "fs-sparse",
+                       "Flow-sensitive PTA solved along def-use chains from flow-insensitive PTA")
     #if LLVM_VERSION_MAJOR < 4
             , nullptr
     #endif
             ),
         llvm::cl::init(LLVMPointerAnalysisOptions::AnalysisType::fi), llvm::cl::cat(SlicingOpts));
 
+    using dg::analysis::pta::PointsToSetKind;
+    llvm::cl::opt<PointsToSetKind> ptaSet("pta-set",
+        llvm::cl::desc("Choose the implementation of points-to sets:"),
+        llvm::cl::values(
+            clEnumValN(PointsToSetKind::OFFSETS_SET, "offsets-set", "Pointers grouped by targets (default)"),
+            clEnumValN(PointsToSetKind::SIMPLE, "simple", "Set of pointers"),
+            clEnumValN(PointsToSetKind::SEPARATE_OFFSETS, "separate-offsets", "Separate bitvectors of targets and offsets"),
+            clEnumValN(PointsToSetKind::POINTER_ID, "pointer-id", "Bitvector of pointer IDs"),
+            clEnumValN(PointsToSetKind::SMALL_OFFSETS, "small-offsets", "Bitvector of targets with small offsets"),
+            clEnumValN(PointsToSetKind::ALIGNED_SMALL_OFFSETS, "aligned-small-offsets", "Bitvector of targets with small aligned offsets"),
+            clEnumValN(PointsToSetKind::ALIGNED_POINTER_ID, "aligned-pointer-id", "Bitvector of aligned pointer IDs"),
+            clEnumValN(PointsToSetKind::HYBRID_POINTER_ID, "hybrid", "Small array or bitvector of pointer IDs"),
+            clEnumValN(PointsToSetKind::INTERNED, "interned", "Shared (hash-consed) sets of pointer IDs"),
+            clEnumValN(PointsToSetKind::BDD, "bdd", "Sets of pointers represented by BDDs")
+    #if LLVM_VERSION_MAJOR < 4
+            , nullptr
+    #endif
+            ),
+        llvm::cl::init(PointsToSetKind::OFFSETS_SET), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<unsigned> ptaThreads("pta-threads",
+        llvm::cl::desc("The number of threads that solve the flow-insensitive\n"
+                       "pointer analysis (default=1)."),
+        llvm::cl::value_desc("N"), llvm::cl::init(1), llvm::cl::cat(SlicingOpts));
+
+    llvm::cl::opt<bool> ptaWorklist("pta-worklist",
+        llvm::cl::desc("Solve pointer analysis with a worklist of the nodes whose\n"
+                       "inputs changed instead of processing all nodes\n"
+                       "reachable from the changed nodes (default=false)."),
+        llvm::cl::init(false), llvm::cl::cat(SlicingOpts));
+
     llvm::cl::opt<LLVMReachingDefinitionsAnalysisOptions::AnalysisType> rdaType("rda",
         llvm::cl::desc("Choose reaching definitions analysis to use:"),
         llvm::cl::values(
@@ -223,6 +260,9 @@ SlicerOptions parseSlicerOptions(int argc, char *argv[]) {
     options.dgOptions.PTAOptions.fieldSensitivity
                                     = dg::analysis::Offset(ptaFieldSensitivity);
     options.dgOptions.PTAOptions.analysisType = ptaType;
+    options.dgOptions.PTAOptions.pointsToSetKind = ptaSet;
+    options.dgOptions.PTAOptions.setWorklistFixpoint(ptaWorklist);
+    options.dgOptions.PTAOptions.setSolverThreads(ptaThreads);
 
     options.dgOptions.threads = threads;
     options.dgOptions.PTAOptions.threads = threads;
@@ -384,6 +384,15 @@ public:
         else if (options.dgOptions.PTAOptions.analysisType
                     == LLVMPointerAnalysisOptions::AnalysisType::inv)
             module_comment += "flow-sensitive with invalidate\n";
+        else if (options.dgOptions.PTAOptions.analysisType
+                    == LLVMPointerAnalysisOptions::AnalysisType::fi_andersen)
+            module_comment += "flow-insensitive (andersen)\n";
+        else if (options.dgOptions.PTAOptions.analysisType
+                    == LLVMPointerAnalysisOptions::AnalysisType::steens)
+            module_comment += "flow-insensitive (steensgaard)\n";
+        else if (options.dgOptions.PTAOptions.analysisType
+                    == LLVMPointerAnalysisOptions::AnalysisType::fs_sparse)
+            module_comment += "flow-sensitive (sparse)\n";
 
         module_comment+= ";   * PTA field sensitivity: ";
         if (options.dgOptions.PTAOptions.fieldSensitivity == Offset::UNKNOWN)
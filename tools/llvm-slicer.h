@@ -106,6 +106,10 @@ public:
 
         const auto& stats = _builder.getStatistics();
         llvm::errs() << "[llvm-slicer] CPU time of pointer analysis: " << double(stats.ptaTime) / CLOCKS_PER_SEC << " s\n";
+        const auto& ptaStats = _builder.getPTA()->getStatistics();
+        llvm::errs() << "[llvm-slicer] pointer analysis: " << ptaStats.iterations << " iterations, "
+                     << ptaStats.processedNodes << " processed nodes, "
+                     << ptaStats.collapsedNodes << " nodes in collapsed cycles\n";
         llvm::errs() << "[llvm-slicer] CPU time of reaching definitions analysis: " << double(stats.rdaTime) / CLOCKS_PER_SEC << " s\n";
         llvm::errs() << "[llvm-slicer] CPU time of control dependence analysis: " << double(stats.cdTime) / CLOCKS_PER_SEC << " s\n";
     }